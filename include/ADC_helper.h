@@ -1,5 +1,9 @@
+#pragma once
+#include <atomic>
 #include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
 #include "esp_adc/adc_oneshot.h"
+#include "esp_adc/adc_continuous.h"
 #include "esp_adc/adc_cali.h"
 #include "esp_adc/adc_cali_scheme.h"
 #include "esp_log.h"
@@ -8,5 +12,28 @@
 
 static const char* TAG_ADC = "ADC";
 
-void adc_init();
-void adc_task();
\ No newline at end of file
+// 1 = adc_continuous (DMA frames), 0 = old adc_oneshot polling
+#ifndef ADC_USE_CONTINUOUS
+#define ADC_USE_CONTINUOUS 1
+#endif
+
+// Pot -> PWM brightness output. Not GPIO2: that is the on-board LED the gpio
+// init step and the button drive, and both init steps run in parallel.
+#ifndef ADC_PWM_GPIO
+#define ADC_PWM_GPIO GPIO_NUM_25
+#endif
+
+// Continuous mode setup (ESP32 ADC1 DMA, min 20 kHz total)
+static constexpr uint32_t ADC_STREAM_SAMPLE_HZ  = 20 * 1000;   // total over all channels
+static constexpr uint32_t ADC_STREAM_FRAME_SZ   = 1024;        // bytes per DMA frame (512 conversions)
+static constexpr uint32_t ADC_STREAM_POOL_SZ    = 4 * ADC_STREAM_FRAME_SZ;
+static constexpr size_t   ADC_STREAM_MAX_CH     = 4;
+
+esp_err_t adc_init();
+esp_err_t adc_task(const std::atomic<bool>& stop);   // ESP_OK once stop is set, else the ADC error
+
+esp_err_t adc_stream_init(const adc_channel_t* channels, size_t n, uint32_t sample_hz);
+esp_err_t adc_stream_start(TaskHandle_t notify);
+esp_err_t adc_stream_stop();
+uint32_t adc_stream_overflows();
+int adc_latest_raw();    // last filtered channel 0 value, -1 before first block
@@ -10,10 +10,93 @@
 #include "esp_vfs_fat.h"
 #include "sdmmc_cmd.h"
 #include "driver/sdspi_host.h"
+#include "sample_batch.h"
+#include "strip_chart.h"
+#include "boot_profile.h"
+#include "boot_cache.h"
+#include "init_graph.h"
+#include "binproto.h"
+#include "task_stats.h"
+#include "kernel_store.h"
 
 
 #define ADC_CH  ADC_CHANNEL_6
 
+// Log the duration of every init step and the time to the first sample
+#ifndef APP_BOOT_PROFILE
+#define APP_BOOT_PROFILE 1
+#endif
+
+// Trust the device map and SPL06 calibration cached in NVS by the last boot
+#ifndef APP_FAST_BOOT
+#define APP_FAST_BOOT 1
+#endif
+
+// Default core layout (index into App::LAYOUTS), 'layout <n>' overrides it from NVS
+#ifndef APP_TASK_LAYOUT
+#define APP_TASK_LAYOUT 1
+#endif
+
+// Stack bytes for the tasks created static, carved in table order. With
+// APP_STATIC_ALLOC (kernel_store.h) every task is static and the restartable
+// producer takes two stacks.
+#ifndef APP_TASK_STACK_POOL
+#if APP_STATIC_ALLOC
+#define APP_TASK_STACK_POOL (24 * 1024)
+#else
+#define APP_TASK_STACK_POOL (16 * 1024)
+#endif
+#endif
+
+// Log the 'stats' snapshot every N s from the health task, 0 = only on request
+#ifndef APP_STATS_PERIOD_S
+#define APP_STATS_PERIOD_S 60
+#endif
+
+// CLI rx: driver ring buffer, event queue depth, longest accepted line
+#ifndef UART_RX_BUF
+#define UART_RX_BUF 2048
+#endif
+#ifndef UART_EVQ_LEN
+#define UART_EVQ_LEN 20
+#endif
+#ifndef UART_LINE_MAX
+#define UART_LINE_MAX 128
+#endif
+
+// 'stream on <rate>': UART0 baud while streaming, tx ring the consumer writes
+// frames into (never blocks on it, drops instead), frames allowed back to back
+#ifndef CLI_BAUD
+#define CLI_BAUD 115200
+#endif
+#ifndef STREAM_BAUD
+#define STREAM_BAUD 921600
+#endif
+#ifndef UART_TX_BUF
+#define UART_TX_BUF 4096
+#endif
+#ifndef STREAM_BURST
+#define STREAM_BURST 8
+#endif
+
+// Sampling clock callback straight from the esp_timer ISR instead of the
+// esp_timer task: one less context switch between the alarm and the producer
+#ifndef PRODUCER_TIMER_ISR
+#ifdef CONFIG_ESP_TIMER_SUPPORTS_ISR_DISPATCH_METHOD
+#define PRODUCER_TIMER_ISR 1
+#else
+#define PRODUCER_TIMER_ISR 0
+#endif
+#endif
+#if PRODUCER_TIMER_ISR && !defined(CONFIG_ESP_TIMER_SUPPORTS_ISR_DISPATCH_METHOD)
+#error "PRODUCER_TIMER_ISR needs CONFIG_ESP_TIMER_SUPPORTS_ISR_DISPATCH_METHOD"
+#endif
+
+// Full 126 address I2C scan even when the cached map checks out
+#ifndef APP_FORCE_I2C_SCAN
+#define APP_FORCE_I2C_SCAN 0
+#endif
+
 class App{
 public:
     bool start();
@@ -31,7 +114,8 @@ private:
     static void ui_trampoline(void* pv);
     static void uart_trampoline(void* pv);
     static void adc_trampoline(void* pv);
-    static void producer_timer_cb(TimerHandle_t xTimer);
+    static void render_trampoline(void* pv);
+    static void producer_timer_cb(void* arg);
 
     void producer();
     void consumer();
@@ -41,23 +125,165 @@ private:
     void ui_task();
     void uart();
     void adc();
+    void render();
 
     bool spi_init_once();
-    bool sd_mount();
+    bool sd_mount(uint32_t khz);
     void sd_test();
-    void force_spi_cs_high();
+    esp_err_t force_spi_cs_high();
     void sd_log_append(const char* line);
     void sd_log_flush();
 
+    // Every long-lived task in one table. Tasks are pinned by group, the
+    // layout decides which core a group gets.
+    enum class TaskGroup : uint8_t { Acquire, Io };   // sampling/processing vs storage/display/console
+    struct TaskLayout {
+        const char* name;
+        BaseType_t acquire_core;
+        BaseType_t io_core;
+    };
+    struct TaskSpec {
+        const char* name;
+        TaskFunction_t entry;
+        uint32_t stack;                     // bytes
+        UBaseType_t prio;
+        TaskGroup group;
+        bool is_static;                     // stack/TCB from the pool, never freed
+        TaskHandle_t AppContext::* handle;
+        std::atomic<bool> AppContext::* needs;           // device it serves, nullptr = always runs
+    };
+    static const TaskSpec TASKS[];
+    static const TaskLayout LAYOUTS[];
+    static const size_t TASK_COUNT;
+    static const size_t LAYOUT_COUNT;
+    static const TaskSpec* find_task(const char* name);
+    bool create_task(const TaskSpec& t);
+
+    // boot: init graph steps, run by one worker task per core
+    using InitFn = bool (App::*)();
+    int add_init_step(const char* name, uint32_t deps, bool required, int core, InitFn fn);
+    static void init_worker_trampoline(void* pv);
+    void init_worker();
+    void run_init_graph();
+    bool init_core();
+    bool init_adc();
+    bool init_uart();
+    bool init_gpio();
+    bool init_nvs();
+    bool init_i2c();
+    bool init_oled();
+    bool init_spi();
+    bool init_sd();
+    bool init_spl06();
+    bool init_store_cache();
+
+    int boot_begin(const char* name);
+    void boot_end(int step, bool ok = true);
+    void boot_log();
+    void i2c_discover(bool full_scan);
+
+    // What the display shows, at display precision, so equal snapshots = same pixels
+    struct DisplaySnapshot {
+        int16_t temp_dc;        // 0.1 C
+        int16_t rh_pct;
+        int16_t press_hpa;
+        int16_t tmin_dc, tmean_dc, tmax_dc;
+        bool have_stats;
+        bool paused;
+
+        // field by field: memcmp would also compare padding, which a copy
+        // doesn't have to preserve
+        bool operator==(const DisplaySnapshot& o) const {
+            return temp_dc == o.temp_dc && rh_pct == o.rh_pct && press_hpa == o.press_hpa &&
+                   tmin_dc == o.tmin_dc && tmean_dc == o.tmean_dc && tmax_dc == o.tmax_dc &&
+                   have_stats == o.have_stats && paused == o.paused;
+        }
+        bool operator!=(const DisplaySnapshot& o) const { return !(*this == o); }
+    };
+    static constexpr int CHART_PAGE = 5;    // pages 5..7 hold the strip chart
+    DisplaySnapshot take_snapshot();
+    void draw_snapshot(const DisplaySnapshot& s);
+    void request_render();
+
+    void set_latest(SensorChannel c, float v);
+    SensorRecord get_latest();
+
     void inc_dropped_logs();
     uint32_t get_dropped_logs();
 
     void handle_status();
-    void handle_toggle_period(uint32_t ms);
+    void handle_sensor_stats(uint32_t channel);
+    void handle_history(uint32_t value);
+    StatAgg query_stats(SensorChannel c, StatWindow w);
+    void handle_set_period(uint32_t us);
     void handle_toggle_pause();
+    void handle_set_fps(uint32_t fps);
+    void handle_i2c_scan();
+    void handle_stream(bool on, uint32_t rate);
+    void handle_stats();
+    void handle_set_layout(uint32_t layout);
+    void handle_bench(uint32_t seconds);
+    void handle_dsp_bench();
+    void bench_poll();
+    void stream_batch(const SensorBatch& b);
+    void handle_line(char* line, bool overflow);
+
+    // Binary protocol on UART0 next to the text CLI, see binproto.h
+    struct BinLink;
+    void handle_frame(const BinFrame& f);
 
     AppContext ctx_{};
 
+    static constexpr uint32_t SD_FAST_KHZ = 20000;  // SDSPI default speed
+    static constexpr uint32_t SD_SAFE_KHZ = 1000;
+
+    InitGraph<16> init_;
+    InitFn init_fns_[16] = {};
+    TaskHandle_t init_workers_[2] = {};
+    volatile int init_nworkers_ = 0;
+    SemaphoreHandle_t init_mutex_ = nullptr;
+    StaticSemaphore_t init_mutex_buf_;
+    SemaphoreHandle_t init_done_ = nullptr;
+    StaticSemaphore_t init_done_buf_;
+
+    // 'stats': deltas since the previous snapshot, ui task only
+    static constexpr size_t STATS_MAX_TASKS = 24;
+    TaskCpuTracker<STATS_MAX_TASKS> task_cpu_;
+    RateMeter switch_rate_[portNUM_PROCESSORS];
+
+    uint8_t layout_ = APP_TASK_LAYOUT;
+    static constexpr size_t MAX_TASKS = 12;
+    static constexpr size_t SPARE_SLOT = MAX_TASKS;     // second TCB/stack of the restartable task
+    StaticTask_t task_tcb_[MAX_TASKS + 1];
+    StackType_t* task_stack_[MAX_TASKS + 1] = {};
+    StackType_t task_stack_pool_[APP_TASK_STACK_POOL];
+    size_t task_stack_used_ = 0;
+    size_t spare_owner_ = SIZE_MAX;
+    uint8_t task_starts_[MAX_TASKS] = {};
+
+    // 'bench': period and deadline while it runs, ui task only
+    uint32_t bench_end_ms_ = 0;
+    uint32_t bench_prev_period_ = 0;     // us
+
+    BootProfile<16> boot_;
+    portMUX_TYPE boot_mux_ = portMUX_INITIALIZER_UNLOCKED;
+    BootCache boot_cache_{};
+    bool boot_cache_hit_ = false;
+    bool boot_cache_dirty_ = false;
+
     static constexpr int POOL_N = 8;
-    Sample pool_[POOL_N];
+    static constexpr uint32_t BATCH_MAX_AGE_MS = 500; // publish partial batches after this
+    SensorBatch pool_[POOL_N];
+
+    // Kernel objects behind ctx_, in here with APP_STATIC_ALLOC (kernel_store.h)
+    QueueStore<SensorBatch*, POOL_N> free_q_, data_q_;
+    QueueStore<LogEvent, 10> log_q_;
+    QueueStore<ButtonEvent, 10> button_q_;
+    QueueStore<CommandEvent, 10> cmd_q_;
+    QueueStore<float, 8> chart_q_;
+    QueueSetStore<decltype(button_q_)::LEN + decltype(cmd_q_)::LEN> ui_set_;
+    MutexStore stats_mutex_, rollup_mutex_;
+
+    // Heap left when start() returned; with APP_STATIC_ALLOC it should stay there
+    uint32_t heap_after_boot_ = 0;
 };
\ No newline at end of file
@@ -1,15 +1,24 @@
 #pragma once
+#include <atomic>
 #include <cstdint>
 #include "freertos/FreeRTOS.h"
 #include "freertos/queue.h"
 #include "freertos/task.h"
 #include "freertos/semphr.h"
 #include "freertos/portmacro.h" // for portMUX_TYPE
+#include "esp_timer.h"
 #include "sd_policy.h"
+#include "app_types.h"
+#include "window_stats.h"
+#include "rollup_store.h"
+#include "bin_stream.h"
+#include "task_stats.h"
+#include "seqlock_store.h"
 
 struct Settings {
-    uint32_t producer_period_ms;
+    uint32_t producer_period_us;
     float sea_level_hpa;   // P0
+    uint32_t render_max_fps;
 };
 
 struct AppContext{
@@ -18,6 +27,8 @@ struct AppContext{
     QueueHandle_t logQueue = nullptr;
     QueueHandle_t buttonQ = nullptr;
     QueueHandle_t cmdQ = nullptr;
+    QueueHandle_t chartQ = nullptr;     // float samples health -> render strip chart
+    QueueHandle_t uartEvQ = nullptr;    // uart_event_t from the UART driver
     QueueSetHandle_t uiSet = nullptr;
     
     // For restart
@@ -28,13 +39,20 @@ struct AppContext{
     TaskHandle_t buttonHandle;
     TaskHandle_t uiHandle;
     TaskHandle_t uartHandle;
+    TaskHandle_t renderHandle;
+    TaskHandle_t adcHandle;
 
-    //software timer
-    TimerHandle_t producerTimer;
+    // Sampling clock, periodic esp_timer notifying the producer
+    esp_timer_handle_t producerTimer = nullptr;
 
-    // Stop flag
-    volatile bool stopRequested = false;
-    volatile bool producerPaused = false;
+    // Devices that came up at boot, the rest run degraded. Set in start(); a
+    // task whose device fails later clears its flag and carries on without it.
+    std::atomic<bool> have_adc{false}, have_uart{false}, have_gpio{false};
+    std::atomic<bool> have_i2c{false}, have_oled{false}, have_sd{false}, have_spl06{false}, have_sht31{false};
+
+    // Control flags, written by ui/stop(), polled by every task loop
+    std::atomic<bool> stopRequested{false};
+    std::atomic<bool> producerPaused{false};
 
     // Breadcrumb + heartbeat
     volatile int producer_stage;
@@ -44,13 +62,37 @@ struct AppContext{
     portMUX_TYPE dropped_logs_mux;
     uint32_t dropped_logs;
 
-    //Mutex
-    SemaphoreHandle_t settingsMutex;
-    Settings settings;
+    // Binary sample stream: ui task starts/stops it, consumer sends
+    portMUX_TYPE stream_mux;
+    BinStream stream;
+
+    // CLI rx: lines parsed, lines cut, binary frames, rx FIFO/ring overflows (uart task only writes)
+    volatile uint32_t uart_lines, uart_long_lines, uart_frames, uart_rx_overflows;
+
+    // Latest reading of every sensor, written by ui/health/adc, snapshotted by producer
+    portMUX_TYPE latest_mux;
+    SensorRecord latest;
+
+    // Last minute / last hour per sensor channel, fed by consumer (mutex: a
+    // push can rebuild a whole window, too long to hold interrupts off)
+    SemaphoreHandle_t statsMutex;
+    StatsEngine<60, 60> stats;
+
+    // Pipeline timing, a few words per update
+    portMUX_TYPE stats_mux;
+    LatencyStats latency;               // producer queue -> consumer done, under stats_mux
+    ClockJitter jitter;                 // producer wake vs timer schedule, under stats_mux
+
+    // In-RAM history tiers, fed by consumer (mutex, queries scan up to 600 slots)
+    SemaphoreHandle_t rollupMutex;
+    DeviceRollup rollup;
+
+    // Written by the ui task, read lock-free; loops use load_if_changed() with their last version
+    SeqlockStore<Settings> settings;
 
     //DMA SD
     static constexpr size_t SD_BUF_SZ = 2048;
-    char sd_buf[SD_BUF_SZ];
+    alignas(4) char sd_buf[SD_BUF_SZ];  // word aligned: whole sectors go to the card without a bounce buffer
     size_t sd_buf_len;
 
     //SD policy
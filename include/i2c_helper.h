@@ -1,16 +1,57 @@
 #pragma once
-#include "driver/i2c.h"
+#include "driver/i2c_master.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
 #include "esp_log.h"
+#include "ssd1306_display.h"
 
-static uint8_t fb[128 * 8];
+static constexpr uint32_t I2C_BUS_HZ = 400000;          // Fast-mode, SHT31 and SSD1306 both allow it
+static constexpr size_t I2C_TRANS_QUEUE_DEPTH = 16;     // display transfers waiting for the bus
+static constexpr size_t I2C_SENSOR_QUEUE_DEPTH = 4;     // sensor transfers waiting for the bus
+static constexpr int I2C_FAILS_BEFORE_RECOVERY = 3;     // consecutive errors, any device
 
-void i2c_scan();
-esp_err_t i2c_master_init();
-esp_err_t sht31_read(float *temp_c, float *rh);
+// Devices behind the bus manager, index into i2c_get_dev_stats
+enum class I2cDev : uint8_t { Sht31, Oled, COUNT };
+static constexpr int I2C_DEV_COUNT = (int)I2cDev::COUNT;
+
+struct I2cCounters {
+    uint32_t done;
+    uint32_t errors;
+    uint32_t recoveries;
+};
+
+// Per device, times in us. wait = submit -> bus, xfer = on the bus
+struct I2cDevStats {
+    const char* name;
+    uint8_t addr;
+    uint32_t ok;
+    uint32_t errors;
+    uint32_t wait_max_us;
+    uint32_t xfer_max_us;
+    uint64_t wait_total_us;
+    uint64_t xfer_total_us;
+};
+
+// Address-only probes, blocking. Boot and the 'scan' command only.
+bool i2c_probe(uint8_t addr);
+int i2c_scan(uint8_t* found, int max);      // returns devices found, fills up to max
+esp_err_t i2c_master_init();                // bus, devices and the bus manager task
+I2cCounters i2c_get_counters();
+I2cDevStats i2c_get_dev_stats(I2cDev dev);
+
+// Recovery runs in the bus manager between transfers. The epoch goes up after
+// every recovery; whoever owns a device re-initialises it when it changes.
+void i2c_request_recovery();
+uint32_t i2c_bus_epoch();
+
+// SHT31 non-blocking single shot: trigger, then poll until it stops returning
+// ESP_ERR_NOT_FINISHED (needs ~20 ms of measurement time in between)
+esp_err_t sht31_trigger();
+esp_err_t sht31_poll(float *temp_c, float *rh);
 
 esp_err_t ssd1306_cmd(uint8_t addr, const uint8_t *cmds, size_t n);
 esp_err_t ssd1306_data(uint8_t addr, const uint8_t *data, size_t n);
-esp_err_t ssd1306_init();
-esp_err_t ssd1306_clear();
-void draw_text(int x, int page, const char* s);
-esp_err_t ssd1306_flush();
\ No newline at end of file
+
+// The panel on I2C_NUM_0 (0x3C), owns the one and only framebuffer.
+// Only the render task draws or flushes after boot.
+Ssd1306Display& oled();
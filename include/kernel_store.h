@@ -0,0 +1,62 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+
+// Storage for one kernel object. With APP_STATIC_ALLOC the control block and
+// item buffer live inside the owner (App) and create() uses the *CreateStatic
+// API; without it create() is the plain heap call. Call sites are the same
+// either way, and delete works on both (the kernel just doesn't free static ones).
+#ifndef APP_STATIC_ALLOC
+#define APP_STATIC_ALLOC 1
+#endif
+
+template <typename T, size_t N>
+struct QueueStore {
+#if APP_STATIC_ALLOC
+    StaticQueue_t q;
+    uint8_t items[N * sizeof(T)];
+#endif
+    static constexpr size_t LEN = N;
+
+    QueueHandle_t create() {
+#if APP_STATIC_ALLOC
+        return xQueueCreateStatic(N, sizeof(T), items, &q);
+#else
+        return xQueueCreate(N, sizeof(T));
+#endif
+    }
+};
+
+template <size_t N>
+struct QueueSetStore {
+#if APP_STATIC_ALLOC
+    StaticQueue_t q;
+    uint8_t items[N * sizeof(QueueSetMemberHandle_t)];
+#endif
+
+    QueueSetHandle_t create() {
+#if APP_STATIC_ALLOC
+        // what xQueueCreateSet() does, on our buffer
+        return xQueueGenericCreateStatic(N, sizeof(QueueSetMemberHandle_t), items, &q, queueQUEUE_TYPE_SET);
+#else
+        return xQueueCreateSet(N);
+#endif
+    }
+};
+
+struct MutexStore {
+#if APP_STATIC_ALLOC
+    StaticSemaphore_t s;
+#endif
+
+    SemaphoreHandle_t create() {
+#if APP_STATIC_ALLOC
+        return xSemaphoreCreateMutexStatic(&s);
+#else
+        return xSemaphoreCreateMutex();
+#endif
+    }
+};
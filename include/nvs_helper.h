@@ -0,0 +1,11 @@
+#pragma once
+#include "esp_err.h"
+#include "boot_cache.h"
+
+esp_err_t nvs_init();                           // nvs_flash_init, erases on layout change
+bool boot_cache_load(BootCache* out);           // false if missing or corrupt
+esp_err_t boot_cache_store(const BootCache& c); // seals a copy and commits
+
+// Small settings that survive a reboot, namespace "app"
+bool nvs_load_u8(const char* key, uint8_t* out);    // false if never stored
+esp_err_t nvs_store_u8(const char* key, uint8_t v);
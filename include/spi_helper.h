@@ -12,7 +12,7 @@ struct Spl06Cal {
 
 extern Spl06Cal spl_cal;
 
-static spi_device_handle_t spl06_dev;
+extern spi_device_handle_t spl06_dev;
 
 esp_err_t spl06_spi_init();
 
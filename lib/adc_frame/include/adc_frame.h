@@ -0,0 +1,50 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// ESP32 continuous ADC (DMA) frames use TYPE1 output: one little-endian
+// 16-bit word per conversion, bits 0..11 = data, bits 12..15 = channel.
+static constexpr size_t ADC_FRAME_WORD_BYTES = 2;
+
+struct AdcChannelBlock {
+    uint8_t channel;    // ADC1 channel number
+    uint16_t* data;     // caller owned storage
+    size_t cap;
+    size_t len;
+};
+
+inline uint8_t adc_word_channel(uint16_t w) { return (uint8_t)(w >> 12); }
+inline uint16_t adc_word_data(uint16_t w) { return (uint16_t)(w & 0x0FFF); }
+
+// Splits one DMA frame into per-channel sample arrays.
+// Words for channels that are not in 'blocks' are ignored, full blocks stop
+// accepting data. Returns number of words that were stored.
+inline size_t adc_frame_demux(const uint8_t* frame, size_t len_bytes,
+                              AdcChannelBlock* blocks, size_t n_blocks)
+{
+    size_t stored = 0;
+    for (size_t i = 0; i + ADC_FRAME_WORD_BYTES <= len_bytes; i += ADC_FRAME_WORD_BYTES) {
+        uint16_t w = (uint16_t)(frame[i] | (frame[i + 1] << 8));
+        uint8_t ch = adc_word_channel(w);
+
+        for (size_t b = 0; b < n_blocks; b++) {
+            AdcChannelBlock& blk = blocks[b];
+            if (blk.channel != ch) continue;
+            if (blk.len < blk.cap) {
+                blk.data[blk.len++] = adc_word_data(w);
+                stored++;
+            }
+            break;
+        }
+    }
+    return stored;
+}
+
+// Mean of a block, -1 when empty
+inline int adc_block_mean(const AdcChannelBlock& blk)
+{
+    if (blk.len == 0) return -1;
+    uint32_t sum = 0;
+    for (size_t i = 0; i < blk.len; i++) sum += blk.data[i];
+    return (int)(sum / blk.len);
+}
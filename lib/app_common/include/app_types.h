@@ -1,24 +1,52 @@
 #pragma once
+#include <cstddef>
 #include <cstdint>
 
 enum class LogType : uint8_t { SENT, DROPPED, RECEIVED, ERROR, STOP, CHANGED, PAUSED };
 
 enum class ButtonEvent : uint8_t { ShortPress, LongPress };
 
-enum class CommandType : uint8_t { SetPeriod, PauseOn, PauseOff, PauseToggle, Status };
+enum class CommandType : uint8_t { SetPeriod, PauseOn, PauseOff, PauseToggle, Status, SensorStats, History, SetFps, I2cScan,
+                                  StreamOn, StreamOff, Stats, SetLayout, Bench, SetPeriodUs, DspBench };
 
-struct Sample {
-    int count;
+// Producer period limits ('period <ms>', 'period us <us>'), esp_timer driven
+static constexpr uint32_t PERIOD_MIN_US = 250;
+static constexpr uint32_t PERIOD_MAX_US = 10000000;
+
+// 'history' reaches back this far, the rollup minute tier is sized from it
+static constexpr uint32_t HISTORY_MAX_S = 6 * 3600;
+
+enum class SensorChannel : uint8_t { TempC, Humidity, PressureHpa, AltitudeM, Adc, COUNT };
+
+static constexpr size_t SENSOR_CH_COUNT = (size_t)SensorChannel::COUNT;
+static constexpr uint32_t SENSOR_ALL = 0xFF;
+
+static const char* const SENSOR_CH_NAMES[SENSOR_CH_COUNT] = { "temp", "rh", "press", "alt", "adc" };
+
+// One reading of every sensor, taken by the producer at timestamp_ms
+struct SensorRecord {
     uint32_t timestamp_ms;
+    float temp_c;
+    float rh;
+    float press_hpa;
+    float alt_m;
+    float adc;      // raw 0..4095
 };
 
 struct LogEvent{
     LogType type;
-    int count;
+    int count;                      // RECEIVED: first sample, CHANGED: period us, PAUSED: 0/1
     uint32_t timestamp_ms;
+    // RECEIVED only: everything one consumer wakeup drained from dataQ
+    uint32_t last_count;
+    uint16_t samples, batches;
+    uint32_t lat_min_us, lat_max_us;
 };
 
 struct CommandEvent {
     CommandType type;
-    uint32_t value;   // used for SetPeriod, otherwise 0
+    uint32_t value;   // SetPeriod: ms, SetPeriodUs: us, SensorStats: SensorChannel or SENSOR_ALL,
+                      // History: channel << 24 | seconds, SetFps: frames/s,
+                      // StreamOn: stream frames/s, SetLayout: layout index,
+                      // Bench: seconds, otherwise 0
 };
\ No newline at end of file
@@ -0,0 +1,68 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// Token bucket: 'rate' events per second, up to 'burst' back to back
+class RateLimiter {
+public:
+    void init(uint32_t rate, uint32_t burst, uint64_t now_us) {
+        cost_us_ = rate ? 1000000u / rate : 1000000u;
+        cap_us_ = (uint64_t)cost_us_ * (burst ? burst : 1);
+        credit_us_ = cap_us_;
+        last_us_ = now_us;
+    }
+
+    bool take(uint64_t now_us) {
+        credit_us_ += now_us - last_us_;
+        last_us_ = now_us;
+        if (credit_us_ > cap_us_) credit_us_ = cap_us_;
+        if (credit_us_ < cost_us_) return false;
+        credit_us_ -= cost_us_;
+        return true;
+    }
+
+private:
+    uint32_t cost_us_ = 1000000;
+    uint64_t cap_us_ = 0;
+    uint64_t credit_us_ = 0;
+    uint64_t last_us_ = 0;
+};
+
+// Device side bookkeeping of the binary sample stream ('stream on <rate>').
+// throttled = frames skipped by the rate limit, dropped = no room in the tx ring.
+struct BinStream {
+    bool on = false;
+    uint8_t seq = 0;            // frame seq, gaps on the host = frames lost on the wire
+    uint32_t rate = 0;
+    uint32_t frames = 0, dropped = 0, throttled = 0;
+    uint64_t bytes = 0;
+    uint64_t start_us = 0, stop_us = 0;
+    RateLimiter limit;
+
+    void start(uint32_t frames_per_s, uint32_t burst, uint64_t now_us) {
+        *this = BinStream{};
+        on = true;
+        rate = frames_per_s;
+        start_us = now_us;
+        limit.init(frames_per_s, burst, now_us);
+    }
+
+    void stop(uint64_t now_us) { on = false; stop_us = now_us; }
+
+    // Frame may go out now; counts it as throttled if not
+    bool admit(uint64_t now_us) {
+        if (!on) return false;
+        if (limit.take(now_us)) return true;
+        throttled++;
+        return false;
+    }
+
+    void sent(size_t n) { frames++; bytes += n; seq++; }
+    void drop() { dropped++; }
+
+    uint64_t elapsed_us(uint64_t now_us) const { return (on ? now_us : stop_us) - start_us; }
+    uint32_t bytes_per_s(uint64_t now_us) const {
+        uint64_t us = elapsed_us(now_us);
+        return us ? (uint32_t)(bytes * 1000000u / us) : 0;
+    }
+};
@@ -0,0 +1,156 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include "app_types.h"
+
+// Binary mode of the UART0 CLI, for host tools instead of scraping ESP_LOGI.
+// Every message on the wire is
+//
+//   0x00 | COBS( type | seq | payload | crc16 LE ) | 0x00
+//
+// Text never contains 0x00, so the leading zero switches the rx side into
+// frame mode and the trailing one ends the frame; a frame cut short by a
+// reset is dropped by the next leading zero. crc16 is CRC-16/CCITT-FALSE
+// over type..payload. Multi-byte fields are little endian.
+
+static constexpr size_t BIN_MAX_PAYLOAD = 240;
+static constexpr size_t BIN_MAX_RAW     = BIN_MAX_PAYLOAD + 4;                   // type, seq, crc16
+static constexpr size_t BIN_MAX_COBS    = BIN_MAX_RAW + BIN_MAX_RAW / 254 + 1;
+static constexpr size_t BIN_MAX_WIRE    = BIN_MAX_COBS + 2;                      // both delimiters
+
+enum class BinMsg : uint8_t {
+    // host -> device
+    Command   = 0x01,   // CommandEvent: type u8, value u32
+    StatusReq = 0x02,   // no payload
+    SampleReq = 0x03,   // no payload, answered with the latest SensorRecord
+    // device -> host, seq echoes the request
+    Ack       = 0x81,   // BinAck u8
+    Status    = 0x82,   // BinStatus
+    Samples   = 0x83,   // n u8, n * SensorRecord
+    Stream    = 0x84,   // unsolicited, seq = stream frame counter: first_count u32, n u8, n * SensorRecord
+};
+
+enum class BinAck : uint8_t { Ok, Invalid, Busy, UnknownType, BadLength };
+
+// Device state for host tooling, the binary twin of the 'status' command
+struct BinStatus {
+    uint32_t uptime_ms;
+    uint32_t period_ms;         // 0 for sub-ms periods
+    uint32_t heartbeat;
+    uint32_t dropped_logs;
+    uint32_t free_heap;
+    uint32_t i2c_errors;
+    uint8_t  paused;
+    uint8_t  fps;
+    uint8_t  devices;       // BIN_DEV_* bits
+};
+static constexpr size_t BIN_STATUS_SIZE = 7 * 4 + 3;
+
+enum : uint8_t {
+    BIN_DEV_ADC = 1 << 0, BIN_DEV_I2C = 1 << 1, BIN_DEV_OLED = 1 << 2, BIN_DEV_SD = 1 << 3,
+    BIN_DEV_SPL06 = 1 << 4, BIN_DEV_SHT31 = 1 << 5,
+};
+
+static constexpr size_t BIN_RECORD_SIZE = 6 * 4;
+static constexpr size_t BIN_MAX_RECORDS = (BIN_MAX_PAYLOAD - 1) / BIN_RECORD_SIZE;
+static constexpr size_t BIN_MAX_STREAM_RECORDS = (BIN_MAX_PAYLOAD - 5) / BIN_RECORD_SIZE;
+
+struct BinFrame {
+    BinMsg type;
+    uint8_t seq;
+    const uint8_t* payload;     // points into the decoder's buffer
+    size_t len;
+};
+
+uint16_t crc16_ccitt(const uint8_t* p, size_t n, uint16_t crc = 0xFFFF);
+
+// COBS, no delimiter. Return bytes written, 0 if cap is too small / input is malformed.
+size_t cobs_encode(const uint8_t* in, size_t n, uint8_t* out, size_t cap);
+size_t cobs_decode(const uint8_t* in, size_t n, uint8_t* out, size_t cap);
+
+// Whole wire frame including both zeros. Returns bytes written, 0 if it doesn't fit.
+size_t bin_encode(BinMsg type, uint8_t seq, const uint8_t* payload, size_t len,
+                  uint8_t* out, size_t cap);
+
+// COBS body without delimiters -> frame, decoded in place into raw (BIN_MAX_RAW).
+// False on bad COBS, short frame or crc mismatch.
+bool bin_decode(const uint8_t* body, size_t n, uint8_t* raw, BinFrame* out);
+
+// Payload packers, return payload length (0 = doesn't fit) / false on bad length
+size_t bin_put_command(const CommandEvent& ev, uint8_t* out);
+bool bin_get_command(const uint8_t* p, size_t n, CommandEvent* out);
+size_t bin_put_status(const BinStatus& s, uint8_t* out);
+bool bin_get_status(const uint8_t* p, size_t n, BinStatus* out);
+size_t bin_put_samples(const SensorRecord* r, size_t count, uint8_t* out, size_t cap);
+size_t bin_get_samples(const uint8_t* p, size_t n, SensorRecord* out, size_t max);   // records read
+size_t bin_put_stream(uint32_t first_count, const SensorRecord* r, size_t count, uint8_t* out, size_t cap);
+size_t bin_get_stream(const uint8_t* p, size_t n, uint32_t* first_count, SensorRecord* out, size_t max);
+
+// Device side: what answering a request needs from the app
+class BinDevice {
+public:
+    virtual ~BinDevice() = default;
+    virtual bool submit(const CommandEvent& ev) = 0;    // false = command queue full
+    virtual void status(BinStatus* out) = 0;
+    virtual void latest(SensorRecord* out) = 0;
+};
+
+// Answers one request frame into out (BIN_MAX_WIRE). Returns wire bytes, 0 = no reply
+// (frames of device -> host types are ignored).
+size_t bin_serve(const BinFrame& f, BinDevice& dev, uint8_t* out, size_t cap);
+
+// Splits the rx stream into text runs (for the line assembler) and frames.
+// on_text(const uint8_t* p, size_t n), on_frame(const BinFrame& f); the frame
+// is only valid inside the callback.
+class FrameDemux {
+public:
+    template<class OnText, class OnFrame>
+    void feed(const uint8_t* d, size_t n, OnText&& on_text, OnFrame&& on_frame) {
+        size_t text_start = 0;
+        for (size_t i = 0; i < n; i++) {
+            const uint8_t b = d[i];
+            if (!in_frame_) {
+                if (b != 0) continue;
+                if (i > text_start) on_text(d + text_start, i - text_start);
+                in_frame_ = true;
+                len_ = 0;
+                continue;
+            }
+
+            if (b != 0) {
+                if (len_ < sizeof(buf_)) buf_[len_] = b;
+                len_++;
+                text_start = i + 1;
+                continue;
+            }
+
+            text_start = i + 1;
+            if (len_ == 0) continue;        // run of zeros: still waiting for a body
+
+            BinFrame f;
+            if (len_ <= sizeof(buf_) && bin_decode(buf_, len_, raw_, &f)) {
+                frames_++;
+                on_frame(f);
+            } else {
+                bad_frames_++;
+            }
+            in_frame_ = false;
+            len_ = 0;
+        }
+        if (!in_frame_ && text_start < n) on_text(d + text_start, n - text_start);
+    }
+
+    void reset() { in_frame_ = false; len_ = 0; }
+
+    bool in_frame() const { return in_frame_; }
+    uint32_t frames() const { return frames_; }
+    uint32_t bad_frames() const { return bad_frames_; }
+
+private:
+    uint8_t buf_[BIN_MAX_COBS];
+    uint8_t raw_[BIN_MAX_RAW];
+    size_t len_ = 0;
+    bool in_frame_ = false;
+    uint32_t frames_ = 0;
+    uint32_t bad_frames_ = 0;
+};
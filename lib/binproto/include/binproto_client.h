@@ -0,0 +1,112 @@
+#pragma once
+// Host side of the binary protocol (tools, tests). Not for the firmware:
+// it uses std::string and std::chrono.
+#include <chrono>
+#include <cstring>
+#include <functional>
+#include <string>
+#include "binproto.h"
+
+// Byte pipe to the device: serial port, socket, in-process loopback
+class BinTransport {
+public:
+    virtual ~BinTransport() = default;
+    virtual bool write(const uint8_t* p, size_t n) = 0;
+    // Up to cap bytes, waits at most timeout_ms for the first one. Returns bytes read.
+    virtual size_t read(uint8_t* p, size_t cap, int timeout_ms) = 0;
+};
+
+// Request/response over a transport. Log text the device prints between
+// frames is kept and handed out by take_text(). Frames that answer nothing
+// we asked for (Stream batches) go to the on_frame handler, or are counted
+// as stray if there is none.
+class BinClient {
+public:
+    explicit BinClient(BinTransport& t, int timeout_ms = 500) : t_(t), timeout_ms_(timeout_ms) {}
+
+    // Queue a command on the device. False = no ack in time; *ack says what the device thought.
+    bool command(const CommandEvent& ev, BinAck* ack) {
+        uint8_t p[8];
+        size_t n = bin_put_command(ev, p);
+        return request(BinMsg::Command, p, n, BinMsg::Ack, [&](const BinFrame& f) {
+            if (f.len != 1) return false;
+            *ack = (BinAck)f.payload[0];
+            return true;
+        });
+    }
+
+    bool status(BinStatus* out) {
+        return request(BinMsg::StatusReq, nullptr, 0, BinMsg::Status, [&](const BinFrame& f) {
+            return bin_get_status(f.payload, f.len, out);
+        });
+    }
+
+    // Latest record(s), returns how many were read, -1 on timeout
+    int samples(SensorRecord* out, size_t max) {
+        size_t got = 0;
+        bool ok = request(BinMsg::SampleReq, nullptr, 0, BinMsg::Samples, [&](const BinFrame& f) {
+            got = bin_get_samples(f.payload, f.len, out, max);
+            return f.len >= 1;
+        });
+        return ok ? (int)got : -1;
+    }
+
+    std::string take_text() { std::string s; s.swap(text_); return s; }
+
+    void on_frame(std::function<void(const BinFrame&)> fn) { on_frame_ = std::move(fn); }
+
+    // Read for up to timeout_ms with no request pending, unsolicited frames only
+    void poll(int timeout_ms) {
+        uint8_t rx[512];
+        size_t got = t_.read(rx, sizeof(rx), timeout_ms);
+        demux_.feed(rx, got,
+            [&](const uint8_t* p, size_t k) { text_.append((const char*)p, k); },
+            [&](const BinFrame& f) { unsolicited(f); });
+    }
+
+    uint32_t stray_frames() const { return stray_; }
+    uint32_t bad_frames() const { return demux_.bad_frames(); }
+
+private:
+    template<class OnReply>
+    bool request(BinMsg type, const uint8_t* payload, size_t len, BinMsg expect, OnReply&& on_reply) {
+        const uint8_t seq = ++seq_;
+        uint8_t wire[BIN_MAX_WIRE];
+        size_t n = bin_encode(type, seq, payload, len, wire, sizeof(wire));
+        if (n == 0 || !t_.write(wire, n)) return false;
+
+        using clock = std::chrono::steady_clock;
+        const auto deadline = clock::now() + std::chrono::milliseconds(timeout_ms_);
+        bool done = false, ok = false;
+
+        while (!done) {
+            auto left = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - clock::now()).count();
+            if (left <= 0) break;
+
+            uint8_t rx[256];
+            size_t got = t_.read(rx, sizeof(rx), (int)left);
+            demux_.feed(rx, got,
+                [&](const uint8_t* p, size_t k) { text_.append((const char*)p, k); },
+                [&](const BinFrame& f) {
+                    if (done || f.seq != seq || (f.type != expect && f.type != BinMsg::Ack)) { unsolicited(f); return; }
+                    done = true;
+                    // a plain Ack to a non-command request means the device refused it
+                    ok = f.type == expect && on_reply(f);
+                });
+        }
+        return ok;
+    }
+
+    void unsolicited(const BinFrame& f) {
+        if (on_frame_ && f.type == BinMsg::Stream) on_frame_(f);
+        else stray_++;
+    }
+
+    BinTransport& t_;
+    int timeout_ms_;
+    uint8_t seq_ = 0;
+    FrameDemux demux_;
+    std::string text_;
+    uint32_t stray_ = 0;
+    std::function<void(const BinFrame&)> on_frame_;
+};
@@ -0,0 +1,247 @@
+#include "binproto.h"
+#include <cstring>
+#include "command_parser.h"
+
+uint16_t crc16_ccitt(const uint8_t* p, size_t n, uint16_t crc)
+{
+    for (size_t i = 0; i < n; i++) {
+        crc ^= (uint16_t)p[i] << 8;
+        for (int b = 0; b < 8; b++) crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+    }
+    return crc;
+}
+
+size_t cobs_encode(const uint8_t* in, size_t n, uint8_t* out, size_t cap)
+{
+    if (cap == 0) return 0;
+    size_t code_at = 0, o = 1;
+    uint8_t code = 1;
+
+    for (size_t i = 0; i < n; i++) {
+        if (in[i] == 0) {
+            if (o >= cap) return 0;
+            out[code_at] = code;
+            code_at = o++;
+            code = 1;
+            continue;
+        }
+        if (o >= cap) return 0;
+        out[o++] = in[i];
+        if (++code == 0xFF) {       // full 254 byte group, no implied zero
+            if (o >= cap) return 0;
+            out[code_at] = code;
+            code_at = o++;
+            code = 1;
+        }
+    }
+    out[code_at] = code;
+    return o;
+}
+
+size_t cobs_decode(const uint8_t* in, size_t n, uint8_t* out, size_t cap)
+{
+    size_t i = 0, o = 0;
+    while (i < n) {
+        const uint8_t code = in[i++];
+        if (code == 0 || i + code - 1 > n) return 0;
+        for (uint8_t k = 1; k < code; k++) {
+            if (o >= cap || in[i] == 0) return 0;
+            out[o++] = in[i++];
+        }
+        if (code != 0xFF && i < n) {
+            if (o >= cap) return 0;
+            out[o++] = 0;
+        }
+    }
+    return o;
+}
+
+size_t bin_encode(BinMsg type, uint8_t seq, const uint8_t* payload, size_t len,
+                  uint8_t* out, size_t cap)
+{
+    if (len > BIN_MAX_PAYLOAD || cap < 2) return 0;
+
+    uint8_t raw[BIN_MAX_RAW];
+    raw[0] = (uint8_t)type;
+    raw[1] = seq;
+    if (len) memcpy(raw + 2, payload, len);
+    const uint16_t crc = crc16_ccitt(raw, len + 2);
+    raw[len + 2] = (uint8_t)crc;
+    raw[len + 3] = (uint8_t)(crc >> 8);
+
+    out[0] = 0;
+    size_t n = cobs_encode(raw, len + 4, out + 1, cap - 2);
+    if (n == 0) return 0;
+    out[n + 1] = 0;
+    return n + 2;
+}
+
+bool bin_decode(const uint8_t* body, size_t n, uint8_t* raw, BinFrame* out)
+{
+    size_t len = cobs_decode(body, n, raw, BIN_MAX_RAW);
+    if (len < 4) return false;
+
+    const uint16_t crc = (uint16_t)(raw[len - 2] | (raw[len - 1] << 8));
+    if (crc16_ccitt(raw, len - 2) != crc) return false;
+
+    out->type = (BinMsg)raw[0];
+    out->seq = raw[1];
+    out->payload = raw + 2;
+    out->len = len - 4;
+    return true;
+}
+
+static void put_u32(uint8_t* p, uint32_t v)
+{
+    p[0] = (uint8_t)v; p[1] = (uint8_t)(v >> 8); p[2] = (uint8_t)(v >> 16); p[3] = (uint8_t)(v >> 24);
+}
+
+static uint32_t get_u32(const uint8_t* p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static void put_f32(uint8_t* p, float f)
+{
+    uint32_t v;
+    memcpy(&v, &f, 4);
+    put_u32(p, v);
+}
+
+static float get_f32(const uint8_t* p)
+{
+    uint32_t v = get_u32(p);
+    float f;
+    memcpy(&f, &v, 4);
+    return f;
+}
+
+size_t bin_put_command(const CommandEvent& ev, uint8_t* out)
+{
+    out[0] = (uint8_t)ev.type;
+    put_u32(out + 1, ev.value);
+    return 5;
+}
+
+bool bin_get_command(const uint8_t* p, size_t n, CommandEvent* out)
+{
+    if (n != 5) return false;
+    out->type = (CommandType)p[0];
+    out->value = get_u32(p + 1);
+    return true;
+}
+
+size_t bin_put_status(const BinStatus& s, uint8_t* out)
+{
+    put_u32(out + 0,  s.uptime_ms);
+    put_u32(out + 4,  s.period_ms);
+    put_u32(out + 8,  s.heartbeat);
+    put_u32(out + 12, s.dropped_logs);
+    put_u32(out + 16, s.free_heap);
+    put_u32(out + 20, s.i2c_errors);
+    out[24] = s.paused;
+    out[25] = s.fps;
+    out[26] = s.devices;
+    return BIN_STATUS_SIZE;
+}
+
+bool bin_get_status(const uint8_t* p, size_t n, BinStatus* out)
+{
+    if (n != BIN_STATUS_SIZE) return false;
+    out->uptime_ms    = get_u32(p + 0);
+    out->period_ms    = get_u32(p + 4);
+    out->heartbeat    = get_u32(p + 8);
+    out->dropped_logs = get_u32(p + 12);
+    out->free_heap    = get_u32(p + 16);
+    out->i2c_errors   = get_u32(p + 20);
+    out->paused  = p[24];
+    out->fps     = p[25];
+    out->devices = p[26];
+    return true;
+}
+
+size_t bin_put_samples(const SensorRecord* r, size_t count, uint8_t* out, size_t cap)
+{
+    if (count > BIN_MAX_RECORDS || cap < 1 + count * BIN_RECORD_SIZE) return 0;
+    out[0] = (uint8_t)count;
+    uint8_t* p = out + 1;
+    for (size_t i = 0; i < count; i++, p += BIN_RECORD_SIZE) {
+        put_u32(p, r[i].timestamp_ms);
+        put_f32(p + 4,  r[i].temp_c);
+        put_f32(p + 8,  r[i].rh);
+        put_f32(p + 12, r[i].press_hpa);
+        put_f32(p + 16, r[i].alt_m);
+        put_f32(p + 20, r[i].adc);
+    }
+    return 1 + count * BIN_RECORD_SIZE;
+}
+
+size_t bin_get_samples(const uint8_t* p, size_t n, SensorRecord* out, size_t max)
+{
+    if (n < 1 || n != 1 + (size_t)p[0] * BIN_RECORD_SIZE) return 0;
+    size_t count = p[0] < max ? p[0] : max;
+    const uint8_t* q = p + 1;
+    for (size_t i = 0; i < count; i++, q += BIN_RECORD_SIZE) {
+        out[i].timestamp_ms = get_u32(q);
+        out[i].temp_c    = get_f32(q + 4);
+        out[i].rh        = get_f32(q + 8);
+        out[i].press_hpa = get_f32(q + 12);
+        out[i].alt_m     = get_f32(q + 16);
+        out[i].adc       = get_f32(q + 20);
+    }
+    return count;
+}
+
+size_t bin_put_stream(uint32_t first_count, const SensorRecord* r, size_t count, uint8_t* out, size_t cap)
+{
+    if (count > BIN_MAX_STREAM_RECORDS || cap < 4) return 0;
+    size_t n = bin_put_samples(r, count, out + 4, cap - 4);
+    if (n == 0) return 0;
+    put_u32(out, first_count);
+    return n + 4;
+}
+
+size_t bin_get_stream(const uint8_t* p, size_t n, uint32_t* first_count, SensorRecord* out, size_t max)
+{
+    if (n < 5) return 0;
+    *first_count = get_u32(p);
+    return bin_get_samples(p + 4, n - 4, out, max);
+}
+
+static size_t ack(uint8_t seq, BinAck a, uint8_t* out, size_t cap)
+{
+    const uint8_t p = (uint8_t)a;
+    return bin_encode(BinMsg::Ack, seq, &p, 1, out, cap);
+}
+
+size_t bin_serve(const BinFrame& f, BinDevice& dev, uint8_t* out, size_t cap)
+{
+    uint8_t p[BIN_MAX_PAYLOAD];
+
+    switch (f.type) {
+    case BinMsg::Command: {
+        CommandEvent ev;
+        if (!bin_get_command(f.payload, f.len, &ev)) return ack(f.seq, BinAck::BadLength, out, cap);
+        if (!command_event_valid(ev)) return ack(f.seq, BinAck::Invalid, out, cap);
+        return ack(f.seq, dev.submit(ev) ? BinAck::Ok : BinAck::Busy, out, cap);
+    }
+    case BinMsg::StatusReq: {
+        if (f.len != 0) return ack(f.seq, BinAck::BadLength, out, cap);
+        BinStatus s{};
+        dev.status(&s);
+        return bin_encode(BinMsg::Status, f.seq, p, bin_put_status(s, p), out, cap);
+    }
+    case BinMsg::SampleReq: {
+        if (f.len != 0) return ack(f.seq, BinAck::BadLength, out, cap);
+        SensorRecord r{};
+        dev.latest(&r);
+        return bin_encode(BinMsg::Samples, f.seq, p, bin_put_samples(&r, 1, p, sizeof(p)), out, cap);
+    }
+    case BinMsg::Ack:
+    case BinMsg::Status:
+    case BinMsg::Samples:
+    case BinMsg::Stream:
+        return 0;
+    }
+    return ack(f.seq, BinAck::UnknownType, out, cap);
+}
@@ -0,0 +1,63 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+// Known-good boot state kept in NVS so the next boot can skip discovery:
+// the I2C addresses that answered and the SPL06 calibration block as read.
+static constexpr uint32_t BOOT_CACHE_MAGIC = 0x31434242;   // "BBC1"
+static constexpr int BOOT_CACHE_MAX_I2C = 8;
+
+struct BootCache {
+    uint32_t magic;
+    uint8_t n_i2c;
+    uint8_t i2c_addr[BOOT_CACHE_MAX_I2C];
+    uint8_t spl06_id;           // 0 = no calibration cached
+    uint8_t spl06_calib[18];    // registers 0x10..0x21
+    uint32_t crc;
+};
+
+// CRC-32 (IEEE) over everything before 'crc'; zero-init the struct before
+// filling it so padding is deterministic
+inline uint32_t boot_cache_crc(const BootCache& c) {
+    const uint8_t* p = reinterpret_cast<const uint8_t*>(&c);
+    const size_t n = offsetof(BootCache, crc);
+    uint32_t crc = 0xFFFFFFFFu;
+    for (size_t i = 0; i < n; i++) {
+        crc ^= p[i];
+        for (int b = 0; b < 8; b++) crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1u)));
+    }
+    return ~crc;
+}
+
+inline void boot_cache_reset(BootCache& c) {
+    memset(&c, 0, sizeof(c));
+    c.magic = BOOT_CACHE_MAGIC;
+}
+
+inline void boot_cache_seal(BootCache& c) {
+    c.magic = BOOT_CACHE_MAGIC;
+    c.crc = boot_cache_crc(c);
+}
+
+inline bool boot_cache_valid(const BootCache& c) {
+    return c.magic == BOOT_CACHE_MAGIC && c.n_i2c <= BOOT_CACHE_MAX_I2C && c.crc == boot_cache_crc(c);
+}
+
+inline bool boot_cache_has_i2c(const BootCache& c, uint8_t addr) {
+    for (int i = 0; i < c.n_i2c; i++) if (c.i2c_addr[i] == addr) return true;
+    return false;
+}
+
+// false if the table is full; duplicates are ignored
+inline bool boot_cache_add_i2c(BootCache& c, uint8_t addr) {
+    if (boot_cache_has_i2c(c, addr)) return true;
+    if (c.n_i2c >= BOOT_CACHE_MAX_I2C) return false;
+    c.i2c_addr[c.n_i2c++] = addr;
+    return true;
+}
+
+inline void boot_cache_set_spl06(BootCache& c, uint8_t chip_id, const uint8_t calib[18]) {
+    c.spl06_id = chip_id;
+    memcpy(c.spl06_calib, calib, sizeof(c.spl06_calib));
+}
@@ -0,0 +1,48 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// Boot step timestamps. Caller passes the clock (esp_timer_get_time() on the
+// target) so this stays host-testable.
+struct BootStep {
+    const char* name;
+    uint32_t start_us;
+    uint32_t dur_us;
+    bool ok;
+};
+
+template<size_t N>
+class BootProfile {
+public:
+    // returns the step index, -1 if the table is full
+    int begin(const char* name, uint32_t now_us) {
+        if (n_ >= N) return -1;
+        steps_[n_] = BootStep{ name, now_us, 0, false };
+        return (int)n_++;
+    }
+
+    void end(int idx, uint32_t now_us, bool ok = true) {
+        if (idx < 0 || (size_t)idx >= n_) return;
+        steps_[idx].dur_us = now_us - steps_[idx].start_us;
+        steps_[idx].ok = ok;
+        if (now_us > last_us_) last_us_ = now_us;
+    }
+
+    size_t size() const { return n_; }
+    const BootStep& operator[](size_t i) const { return steps_[i]; }
+
+    // first begin to last end, steps may overlap
+    uint32_t total_us() const { return n_ ? last_us_ - steps_[0].start_us : 0; }
+
+    // sum of step durations; above total_us() when steps ran in parallel
+    uint32_t busy_us() const {
+        uint32_t s = 0;
+        for (size_t i = 0; i < n_; i++) s += steps_[i].dur_us;
+        return s;
+    }
+
+private:
+    BootStep steps_[N]{};
+    size_t n_ = 0;
+    uint32_t last_us_ = 0;
+};
@@ -6,5 +6,9 @@
 
 // Parses already-trimmed line (no \r\n), like "period 4000".
 // Returns true if recognized and fills out 'out'.
-// Returns false if unknown/invalid.
+// Returns false if unknown/invalid. Commands come from COMMANDS in command_registry.h.
 bool parse_command_line(const char* line, CommandEvent* out);
+
+// Same limits as the text syntax, for commands that arrive already decoded
+// (binary protocol). False for unknown types and out of range values.
+bool command_event_valid(const CommandEvent& ev);
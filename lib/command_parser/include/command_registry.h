@@ -0,0 +1,160 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include "app_types.h"
+
+// Every CLI command in one table: words, typed arguments with limits, the
+// CommandEvent it turns into and its help line. parse_command_line(), the
+// 'help' output and command_event_valid() are all driven from here, so a new
+// command is one row.
+//
+// Lookup is a perfect hash over the first word, built at compile time; rows
+// sharing a first word ("pause on", "pause off") sit next to each other and
+// are told apart by their sub-word / argument count.
+
+enum class ArgKind : uint8_t { UInt, Enum };
+
+struct ArgSpec {
+    ArgKind kind;
+    uint32_t min, max;              // UInt range, inclusive
+    const char* const* names;       // Enum: value = index into names
+    uint8_t n_names;
+    uint8_t shift;                  // value |= arg << shift
+    const char* unit;               // help only, may be nullptr
+};
+
+struct CommandSpec {
+    const char* word;
+    const char* sub;                // fixed second word, nullptr = none
+    CommandType type;
+    uint32_t value;                 // arguments are OR'ed into this
+    uint8_t n_args;
+    ArgSpec args[2];
+    const char* help;
+};
+
+static constexpr ArgSpec arg_uint(uint32_t min, uint32_t max, const char* unit = nullptr, uint8_t shift = 0) {
+    return ArgSpec{ ArgKind::UInt, min, max, nullptr, 0, shift, unit };
+}
+
+static constexpr ArgSpec arg_enum(const char* const* names, uint8_t n, uint8_t shift = 0) {
+    return ArgSpec{ ArgKind::Enum, 0, (uint32_t)n - 1, names, n, shift, nullptr };
+}
+
+static constexpr ArgSpec ARG_CHANNEL = arg_enum(SENSOR_CH_NAMES, (uint8_t)SENSOR_CH_COUNT);
+
+static constexpr CommandSpec COMMANDS[] = {
+    { "status",  nullptr,  CommandType::Status,      0, 0, {}, "counters, bus and uart stats" },
+    { "stats",   nullptr,  CommandType::Stats,       0, 0, {}, "task cpu/stack, heap, queues, switch rate" },
+    { "period",  nullptr,  CommandType::SetPeriod,   0, 1, { arg_uint(1, PERIOD_MAX_US / 1000, "ms") }, "producer period" },
+    { "period",  "us",     CommandType::SetPeriodUs, 0, 1, { arg_uint(PERIOD_MIN_US, PERIOD_MAX_US, "us") }, "producer period, sub-ms" },
+    { "pause",   "on",     CommandType::PauseOn,     0, 0, {}, "stop sampling" },
+    { "pause",   "off",    CommandType::PauseOff,    0, 0, {}, "resume sampling" },
+    { "pause",   "toggle", CommandType::PauseToggle, 0, 0, {}, "same as the button" },
+    { "sensor",  nullptr,  CommandType::SensorStats, SENSOR_ALL, 0, {}, "window stats, all channels" },
+    { "sensor",  nullptr,  CommandType::SensorStats, 0, 1, { ARG_CHANNEL }, "window stats, one channel" },
+    { "history", nullptr,  CommandType::History,     0, 2,
+      { arg_enum(SENSOR_CH_NAMES, (uint8_t)SENSOR_CH_COUNT, 24), arg_uint(1, HISTORY_MAX_S, "s") }, "min/mean/max over the last N s" },
+    { "fps",     nullptr,  CommandType::SetFps,      0, 1, { arg_uint(1, 30) }, "display frame cap" },
+    { "scan",    nullptr,  CommandType::I2cScan,     0, 0, {}, "full I2C scan, refreshes the boot cache" },
+    { "layout",  nullptr,  CommandType::SetLayout,   0, 1, { arg_uint(0, 3) }, "task cores: 0 float 1 split 2 swapped 3 single, saved, reboots" },
+    { "bench",   nullptr,  CommandType::Bench,       0, 1, { arg_uint(5, 600, "s") }, "pipeline latency at 50 ms period for the current layout" },
+    { "bench",   "dsp",    CommandType::DspBench,    0, 0, {}, "FIR/biquad throughput on this chip, esp-dsp or portable" },
+    { "stream",  "on",     CommandType::StreamOn,    0, 1, { arg_uint(1, 1000, "frames/s") }, "binary samples at STREAM_BAUD" },
+    { "stream",  "off",    CommandType::StreamOff,   0, 0, {}, "back to text at 115200, prints the report" },
+};
+static constexpr size_t COMMAND_COUNT = sizeof(COMMANDS) / sizeof(COMMANDS[0]);
+
+// ---- compile-time perfect hash over the first words ----
+
+static constexpr size_t CMD_HASH_SLOTS = 16;     // power of two, > distinct words
+static constexpr uint8_t CMD_NO_SLOT = 0xFF;
+
+// First words are at most 8 chars, so a word packs into one uint64_t (char i
+// in byte i). The parser packs while it scans for the end of the word; one
+// compare of the packed words then replaces the length check and memcmp.
+static constexpr size_t CMD_WORD_MAX = 8;
+
+constexpr uint64_t cmd_pack(const char* s, size_t n) {
+    uint64_t k = 0;
+    for (size_t i = 0; i < n; i++) k |= (uint64_t)(uint8_t)s[i] << (8 * i);
+    return k;
+}
+
+constexpr uint32_t cmd_hash(uint64_t key, uint32_t seed) {
+    return (uint32_t)((key * (0x9E3779B97F4A7C15ull + 2 * seed)) >> 32);   // multiplicative, high half
+}
+
+constexpr size_t cmd_len(const char* s) {
+    size_t n = 0;
+    while (s[n]) n++;
+    return n;
+}
+
+constexpr bool cmd_same(const char* a, const char* b) {
+    size_t i = 0;
+    for (; a[i] && a[i] == b[i]; i++) {}
+    return a[i] == b[i];
+}
+
+struct CommandHash {
+    uint32_t seed;
+    uint8_t slot[CMD_HASH_SLOTS];   // index of the first row with that word
+    uint8_t rows[CMD_HASH_SLOTS];   // rows sharing it
+    uint64_t key[CMD_HASH_SLOTS];   // packed word, 0 = empty slot
+    uint8_t bare[CMD_HASH_SLOTS];   // row for the word alone (no sub, no args), or CMD_NO_SLOT
+    bool ok;
+};
+
+constexpr CommandHash cmd_build_hash() {
+    for (uint32_t seed = 0; seed < 4096; seed++) {
+        CommandHash h{ seed, {}, {}, {}, {}, true };
+        for (auto& s : h.slot) s = CMD_NO_SLOT;
+        for (auto& b : h.bare) b = CMD_NO_SLOT;
+        size_t k = 0;
+        for (size_t i = 0; i < COMMAND_COUNT && h.ok; i++) {
+            const bool same = i > 0 && cmd_same(COMMANDS[i].word, COMMANDS[i - 1].word);
+            if (same) {
+                h.rows[k]++;
+            } else {
+                const uint64_t key = cmd_pack(COMMANDS[i].word, cmd_len(COMMANDS[i].word));
+                k = cmd_hash(key, seed) & (CMD_HASH_SLOTS - 1);
+                if (h.slot[k] != CMD_NO_SLOT) h.ok = false;
+                h.slot[k] = (uint8_t)i;
+                h.rows[k] = 1;
+                h.key[k] = key;
+            }
+            if (!COMMANDS[i].sub && COMMANDS[i].n_args == 0 && h.bare[k] == CMD_NO_SLOT) h.bare[k] = (uint8_t)i;
+        }
+        if (h.ok) return h;
+    }
+    return CommandHash{ 0, {}, {}, {}, {}, false };
+}
+
+constexpr bool cmd_words_fit() {
+    for (const CommandSpec& c : COMMANDS)
+        if (cmd_len(c.word) == 0 || cmd_len(c.word) > CMD_WORD_MAX) return false;
+    return true;
+}
+
+constexpr bool cmd_rows_grouped() {
+    // a first word may only appear in one run of rows
+    for (size_t i = 0; i < COMMAND_COUNT; i++)
+        for (size_t j = i + 2; j < COMMAND_COUNT; j++)
+            if (cmd_same(COMMANDS[i].word, COMMANDS[j].word) && !cmd_same(COMMANDS[i].word, COMMANDS[j - 1].word))
+                return false;
+    return true;
+}
+
+static constexpr CommandHash COMMAND_HASH = cmd_build_hash();
+static_assert(cmd_words_fit(), "first words are 1..CMD_WORD_MAX chars");
+static_assert(COMMAND_HASH.ok, "no collision-free seed, grow CMD_HASH_SLOTS");
+static_assert(cmd_rows_grouped(), "rows with the same first word must be adjacent");
+static_assert(COMMAND_COUNT < CMD_NO_SLOT, "slot index is a uint8_t");
+
+// First row for a word, nullptr if unknown. *rows = how many rows share the word.
+const CommandSpec* command_find(const char* word, size_t len, size_t* rows = nullptr);
+
+// "history <temp|rh|press|alt|adc> <1..21600 s>" plus the help text, padded
+// into columns. Returns the length written (truncated to cap - 1).
+size_t command_help_line(const CommandSpec& c, char* out, size_t cap);
@@ -1,61 +1,184 @@
 #include "command_parser.h"
+#include "command_registry.h"
+#include <cstdio>
 #include <cstring>
-#include <cstdlib>
 
-static bool starts_with(const char* s, const char* pref){
-    while (*pref) { if (*s++ != *pref++) return false; }
+struct Token {
+    const char* p;
+    size_t n;
+};
+
+static size_t split(const char* line, Token* tok, size_t max)
+{
+    size_t n = 0;
+    const char* s = line;
+    while (*s) {
+        while (*s == ' ') s++;
+        if (!*s) break;
+        const char* start = s;
+        while (*s && *s != ' ') s++;
+        if (n == max) return max + 1;       // too many words for any command
+        tok[n++] = Token{ start, (size_t)(s - start) };
+    }
+    return n;
+}
+
+static bool tok_is(const Token& t, const char* word)
+{
+    return strncmp(word, t.p, t.n) == 0 && word[t.n] == '\0';
+}
+
+static bool parse_arg(const ArgSpec& a, const Token& t, uint32_t* out)
+{
+    if (a.kind == ArgKind::Enum) {
+        for (uint8_t i = 0; i < a.n_names; i++) {
+            if (tok_is(t, a.names[i])) { *out = i; return true; }
+        }
+        return false;
+    }
+
+    // digits only, no sign, no overflow
+    uint32_t v = 0;
+    for (size_t i = 0; i < t.n; i++) {
+        const char c = t.p[i];
+        if (c < '0' || c > '9') return false;
+        if (v > (UINT32_MAX - 9) / 10) return false;
+        v = v * 10 + (uint32_t)(c - '0');
+    }
+    if (v < a.min || v > a.max) return false;
+    *out = v;
     return true;
 }
 
+static bool match(const CommandSpec& c, const Token* tok, size_t n, CommandEvent* out)
+{
+    size_t i = 1;
+    if (c.sub) {
+        if (n < 2 || !tok_is(tok[1], c.sub)) return false;
+        i = 2;
+    }
+    if (n != i + c.n_args) return false;
+
+    uint32_t value = c.value;
+    for (uint8_t k = 0; k < c.n_args; k++) {
+        uint32_t v;
+        if (!parse_arg(c.args[k], tok[i + k], &v)) return false;
+        value |= v << c.args[k].shift;
+    }
+    out->type = c.type;
+    out->value = value;
+    return true;
+}
+
+// Slot for a packed first word, -1 if unknown
+static int find_slot(uint64_t key)
+{
+    const size_t k = cmd_hash(key, COMMAND_HASH.seed) & (CMD_HASH_SLOTS - 1);
+    return COMMAND_HASH.key[k] == key && COMMAND_HASH.slot[k] != CMD_NO_SLOT ? (int)k : -1;
+}
+
+const CommandSpec* command_find(const char* word, size_t len, size_t* rows)
+{
+    if (len == 0 || len > CMD_WORD_MAX) return nullptr;
+    const int k = find_slot(cmd_pack(word, len));
+    if (k < 0) return nullptr;
+    if (rows) *rows = COMMAND_HASH.rows[k];
+    return &COMMANDS[COMMAND_HASH.slot[k]];
+}
+
 bool parse_command_line(const char* line, CommandEvent* out)
 {
     if (!line || !out) return false;
 
-    // status
-    if (!strcmp(line, "status")) {
-        out->type = CommandType::Status;
-        out->value = 0;
-        return true;
+    // first word packed while scanning it, the rest is split once the word
+    // is known
+    const char* s = line;
+    while (*s == ' ') s++;
+    const char* w = s;
+    uint64_t key = 0;
+    size_t wn = 0;
+    for (; *s && *s != ' '; s++, wn++) {
+        if (wn < CMD_WORD_MAX) key |= (uint64_t)(uint8_t)*s << (8 * wn);
     }
+    if (wn == 0 || wn > CMD_WORD_MAX) return false;
 
-    // help (let UART handle printing help; parser can still recognize it if you want)
-    if (!strcmp(line, "help")) {
-        // You can either treat this as a command event or let uart() handle it separately.
-        return false;
-    }
+    // 'help' is not in the table, uart() prints it from the table
+    const int k = find_slot(key);
+    if (k < 0) return false;
 
-    // pause
-    if (!strcmp(line, "pause toggle")) {
-        out->type = CommandType::PauseToggle;
-        out->value = 0;
+    // a word on its own ('status', 'scan', ...) is the most common line:
+    // its row is precomputed, no split and no row walk
+    while (*s == ' ') s++;
+    if (!*s) {
+        const uint8_t b = COMMAND_HASH.bare[k];
+        if (b == CMD_NO_SLOT) return false;
+        out->type = COMMANDS[b].type;
+        out->value = COMMANDS[b].value;
         return true;
     }
-    if (!strcmp(line, "pause on")) {
-        out->type = CommandType::PauseOn;
-        out->value = 0;
-        return true;
-    }
-    if (!strcmp(line, "pause off")) {
-        out->type = CommandType::PauseOff;
-        out->value = 0;
-        return true;
+
+    const CommandSpec* c = &COMMANDS[COMMAND_HASH.slot[k]];
+    Token tok[4];
+    tok[0] = Token{ w, wn };
+    const size_t rest = split(s, tok + 1, 3);
+    if (rest > 3) return false;
+    const size_t n = 1 + rest;
+
+    for (size_t r = 0; r < COMMAND_HASH.rows[k]; r++) {
+        if (match(c[r], tok, n, out)) return true;
     }
+    return false;
+}
 
-    // period N
-    if (starts_with(line, "period ")) {
-        char* end = nullptr;
-        unsigned long v = strtoul(line + 7, &end, 10);
+size_t command_help_line(const CommandSpec& c, char* out, size_t cap)
+{
+    if (cap == 0) return 0;
+    char usage[64];
+    size_t u = (size_t)snprintf(usage, sizeof(usage), "%s%s%s", c.word, c.sub ? " " : "", c.sub ? c.sub : "");
 
-        // must consume at least 1 digit and end exactly at '\0'
-        if (end == (line + 7) || *end != '\0') return false;
+    for (uint8_t k = 0; k < c.n_args && u < sizeof(usage); k++) {
+        const ArgSpec& a = c.args[k];
+        if (a.kind == ArgKind::Enum) {
+            u += (size_t)snprintf(usage + u, sizeof(usage) - u, " <");
+            for (uint8_t i = 0; i < a.n_names && u < sizeof(usage); i++)
+                u += (size_t)snprintf(usage + u, sizeof(usage) - u, "%s%s", i ? "|" : "", a.names[i]);
+            if (u < sizeof(usage)) u += (size_t)snprintf(usage + u, sizeof(usage) - u, ">");
+        } else {
+            u += (size_t)snprintf(usage + u, sizeof(usage) - u, " <%u..%u%s%s>", (unsigned)a.min, (unsigned)a.max,
+                                  a.unit ? " " : "", a.unit ? a.unit : "");
+        }
+    }
 
-        // range check
-        if (v < 50 || v > 10000) return false;
+    int n = snprintf(out, cap, "%-40s %s", usage, c.help);
+    return n < 0 ? 0 : ((size_t)n < cap ? (size_t)n : cap - 1);
+}
 
-        out->type = CommandType::SetPeriod;
-        out->value = (uint32_t)v;
-        return true;
+// Bits [shift, next higher shift) of the value belong to an argument
+static uint32_t arg_mask(const CommandSpec& c, uint8_t k)
+{
+    uint32_t hi = 32;
+    for (uint8_t j = 0; j < c.n_args; j++) {
+        if (c.args[j].shift > c.args[k].shift && c.args[j].shift < hi) hi = c.args[j].shift;
     }
+    const uint32_t bits = hi - c.args[k].shift;
+    return (bits >= 32 ? 0xFFFFFFFFu : ((1u << bits) - 1)) << c.args[k].shift;
+}
 
+bool command_event_valid(const CommandEvent& ev)
+{
+    // valid if some row could have produced it
+    for (const CommandSpec& c : COMMANDS) {
+        if (c.type != ev.type) continue;
+
+        uint32_t rest = ev.value;
+        bool ok = true;
+        for (uint8_t k = 0; k < c.n_args && ok; k++) {
+            const uint32_t mask = arg_mask(c, k);
+            const uint32_t v = (ev.value & mask) >> c.args[k].shift;
+            ok = v >= c.args[k].min && v <= c.args[k].max;
+            rest &= ~mask;
+        }
+        if (ok && rest == c.value) return true;
+    }
     return false;
 }
@@ -0,0 +1,95 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// Block filters for ADC / pressure streams. All work on float arrays.
+// On target (ESP-IDF with esp-dsp) FIR and biquad use the esp-dsp kernels,
+// on the native env the portable reference code below is used.
+#if defined(ESP_PLATFORM) && defined(__has_include)
+#if __has_include("esp_dsp.h")
+#define DSP_USE_ESP_DSP 1
+#endif
+#endif
+#ifndef DSP_USE_ESP_DSP
+#define DSP_USE_ESP_DSP 0
+#endif
+
+#if DSP_USE_ESP_DSP
+#include "esp_dsp.h"
+#endif
+
+// Moving average over the last 'window' samples (window <= MAX_WINDOW)
+class MovingAverage {
+public:
+    static constexpr size_t MAX_WINDOW = 64;
+
+    bool init(size_t window);
+    void reset();
+
+    // out may alias in
+    void process(const float* in, float* out, size_t len);
+
+private:
+    float hist_[MAX_WINDOW]{};
+    size_t window_ = 1;
+    size_t pos_ = 0;
+    size_t filled_ = 0;
+    float sum_ = 0.0f;
+};
+
+// Cascade of direct form II transposed biquads.
+// Coefs per section: b0, b1, b2, a1, a2 (a0 normalized to 1)
+class BiquadCascade {
+public:
+    static constexpr size_t MAX_SECTIONS = 4;
+
+    bool init(const float (*coefs)[5], size_t sections);
+    void reset();
+
+    // out may alias in
+    void process(const float* in, float* out, size_t len);
+
+private:
+    float coef_[MAX_SECTIONS][5]{};
+    float w_[MAX_SECTIONS][2]{};
+    size_t sections_ = 0;
+};
+
+// FIR low-pass with decimation. Coefs must stay valid while the filter is used
+// and should be symmetric (esp-dsp walks them in reverse order).
+class FirDecimator {
+public:
+    static constexpr size_t MAX_TAPS = 64;
+    static constexpr size_t MAX_DECIM = 32;
+
+    bool init(const float* coefs, size_t taps, size_t decim);
+    void reset();
+
+    // Consumes all 'len' input samples, one output per 'decim' inputs. A
+    // block cut short by the end of 'in' is finished by the next call, so
+    // the output count doesn't depend on how the input is split up.
+    // Returns number of outputs written. out must not alias in.
+    size_t process(const float* in, float* out, size_t len);
+
+    size_t decim() const { return decim_; }
+
+private:
+    // whole blocks only: consumes n * decim_ inputs, writes n outputs
+    void run_blocks(const float* in, float* out, size_t n);
+
+    const float* coefs_ = nullptr;
+    size_t taps_ = 0;
+    size_t decim_ = 1;
+    float delay_[MAX_TAPS]{};
+    size_t pos_ = 0;
+    float pending_[MAX_DECIM]{};     // start of a block still missing inputs
+    size_t n_pending_ = 0;
+#if DSP_USE_ESP_DSP
+    fir_f32_t fir_{};
+    float coefs_rw_[MAX_TAPS]{};
+#endif
+};
+
+// Coefficient helpers (RBJ cookbook low-pass, windowed-sinc FIR)
+void biquad_lowpass(float fc_norm, float q, float out[5]);   // fc_norm = fc / fs (0..0.5)
+bool fir_lowpass(float fc_norm, float* coefs, size_t taps);  // Hamming window, unity DC gain
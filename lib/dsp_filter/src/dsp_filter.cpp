@@ -0,0 +1,183 @@
+#include "dsp_filter.h"
+#include <cmath>
+#include <cstring>
+
+static constexpr float DSP_PI = 3.14159265358979f;
+
+// ---------- MovingAverage ----------
+
+bool MovingAverage::init(size_t window){
+    if (window == 0 || window > MAX_WINDOW) return false;
+    window_ = window;
+    reset();
+    return true;
+}
+
+void MovingAverage::reset(){
+    memset(hist_, 0, sizeof(hist_));
+    pos_ = 0;
+    filled_ = 0;
+    sum_ = 0.0f;
+}
+
+void MovingAverage::process(const float* in, float* out, size_t len){
+    for (size_t i = 0; i < len; i++) {
+        float x = in[i];
+        sum_ += x - hist_[pos_];
+        hist_[pos_] = x;
+        if (++pos_ == window_) pos_ = 0;
+        if (filled_ < window_) filled_++;
+
+        // running sum drifts with float rounding, rebuild it once per lap
+        if (pos_ == 0) {
+            float s = 0.0f;
+            for (size_t k = 0; k < window_; k++) s += hist_[k];
+            sum_ = s;
+        }
+        out[i] = sum_ / (float)filled_;
+    }
+}
+
+// ---------- BiquadCascade ----------
+
+bool BiquadCascade::init(const float (*coefs)[5], size_t sections){
+    if (!coefs || sections == 0 || sections > MAX_SECTIONS) return false;
+    for (size_t s = 0; s < sections; s++) {
+        for (int k = 0; k < 5; k++) coef_[s][k] = coefs[s][k];
+    }
+    sections_ = sections;
+    reset();
+    return true;
+}
+
+void BiquadCascade::reset(){
+    memset(w_, 0, sizeof(w_));
+}
+
+void BiquadCascade::process(const float* in, float* out, size_t len){
+    const float* src = in;
+    for (size_t s = 0; s < sections_; s++) {
+#if DSP_USE_ESP_DSP
+        dsps_biquad_f32(src, out, (int)len, coef_[s], w_[s]);
+#else
+        const float b0 = coef_[s][0], b1 = coef_[s][1], b2 = coef_[s][2];
+        const float a1 = coef_[s][3], a2 = coef_[s][4];
+        float w0 = w_[s][0], w1 = w_[s][1];
+        for (size_t i = 0; i < len; i++) {
+            float x = src[i];
+            float y = b0 * x + w0;
+            w0 = b1 * x - a1 * y + w1;
+            w1 = b2 * x - a2 * y;
+            out[i] = y;
+        }
+        w_[s][0] = w0;
+        w_[s][1] = w1;
+#endif
+        src = out; // next section runs in place
+    }
+    if (sections_ == 0 && out != in) memcpy(out, in, len * sizeof(float));
+}
+
+// ---------- FirDecimator ----------
+
+bool FirDecimator::init(const float* coefs, size_t taps, size_t decim){
+    if (!coefs || taps == 0 || taps > MAX_TAPS || decim == 0 || decim > MAX_DECIM) return false;
+    coefs_ = coefs;
+    taps_ = taps;
+    decim_ = decim;
+#if DSP_USE_ESP_DSP
+    memcpy(coefs_rw_, coefs, taps * sizeof(float)); // esp-dsp wants non-const coefs
+#endif
+    reset();
+    return true;
+}
+
+void FirDecimator::reset(){
+    memset(delay_, 0, sizeof(delay_));
+    pos_ = 0;
+    n_pending_ = 0;
+#if DSP_USE_ESP_DSP
+    if (taps_) dsps_fird_init_f32(&fir_, coefs_rw_, delay_, (int)taps_, (int)decim_);
+#endif
+}
+
+size_t FirDecimator::process(const float* in, float* out, size_t len){
+    if (!coefs_) return 0;
+    size_t n_out = 0;
+
+    // finish the block the last call ended in
+    if (n_pending_) {
+        size_t take = decim_ - n_pending_;
+        if (take > len) take = len;
+        memcpy(pending_ + n_pending_, in, take * sizeof(float));
+        n_pending_ += take;
+        in += take;
+        len -= take;
+        if (n_pending_ < decim_) return 0;
+        run_blocks(pending_, out, 1);
+        n_out = 1;
+        n_pending_ = 0;
+    }
+
+    const size_t blocks = len / decim_;
+    run_blocks(in, out + n_out, blocks);
+    n_out += blocks;
+
+    n_pending_ = len - blocks * decim_;
+    memcpy(pending_, in + blocks * decim_, n_pending_ * sizeof(float));
+    return n_out;
+}
+
+void FirDecimator::run_blocks(const float* in, float* out, size_t n){
+    if (n == 0) return;
+#if DSP_USE_ESP_DSP
+    dsps_fird_f32(&fir_, in, out, (int)n);   // n outputs from n * decim inputs
+#else
+    for (size_t o = 0; o < n; o++) {
+        for (size_t j = 0; j < decim_; j++) {
+            delay_[pos_] = *in++;
+            if (++pos_ == taps_) pos_ = 0;
+        }
+
+        // delay_[pos_] is now the oldest sample
+        float acc = 0.0f;
+        size_t d = pos_;
+        for (size_t k = taps_; k-- > 0;) {
+            acc += coefs_[k] * delay_[d];
+            if (++d == taps_) d = 0;
+        }
+        out[o] = acc;
+    }
+#endif
+}
+
+// ---------- coefficient design ----------
+
+void biquad_lowpass(float fc_norm, float q, float out[5]){
+    const float w0 = 2.0f * DSP_PI * fc_norm;
+    const float cw = cosf(w0);
+    const float alpha = sinf(w0) / (2.0f * q);
+    const float a0 = 1.0f + alpha;
+
+    out[0] = ((1.0f - cw) * 0.5f) / a0;
+    out[1] = (1.0f - cw) / a0;
+    out[2] = out[0];
+    out[3] = (-2.0f * cw) / a0;
+    out[4] = (1.0f - alpha) / a0;
+}
+
+bool fir_lowpass(float fc_norm, float* coefs, size_t taps){
+    if (!coefs || taps == 0 || fc_norm <= 0.0f || fc_norm >= 0.5f) return false;
+
+    const float mid = (float)(taps - 1) * 0.5f;
+    float sum = 0.0f;
+    for (size_t i = 0; i < taps; i++) {
+        float n = (float)i - mid;
+        float sinc = (n == 0.0f) ? 2.0f * fc_norm : sinf(2.0f * DSP_PI * fc_norm * n) / (DSP_PI * n);
+        float win = (taps > 1) ? 0.54f - 0.46f * cosf(2.0f * DSP_PI * (float)i / (float)(taps - 1)) : 1.0f;
+        coefs[i] = sinc * win;
+        sum += coefs[i];
+    }
+    for (size_t i = 0; i < taps; i++) coefs[i] /= sum;
+    return true;
+}
@@ -0,0 +1,105 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// Boot steps and the steps they need first. Workers claim steps whose
+// dependencies are done; a failed step skips everything that depends on it
+// so the rest of the system still comes up. Not thread-safe, the runner
+// serialises claim()/finish().
+
+enum class InitState : uint8_t { Pending, Running, Ok, Failed, Skipped };
+
+static constexpr int INIT_ANY_CORE = -1;
+
+template<size_t N>
+class InitGraph {
+    static_assert(N <= 32, "dependencies are a 32-bit mask");
+
+public:
+    static constexpr uint32_t dep(int id) { return 1u << id; }
+
+    // deps may only name steps added before, so the graph is acyclic by
+    // construction. Returns the step id, -1 if full or deps are bad.
+    int add(const char* name, uint32_t deps = 0, bool required = true, int core = INIT_ANY_CORE) {
+        if (n_ >= N) return -1;
+        if (deps & ~(dep((int)n_) - 1u)) return -1;
+        steps_[n_] = Step{ name, deps, required, (int8_t)core, InitState::Pending };
+        return (int)n_++;
+    }
+
+    // next runnable step for a worker on 'core', marked Running; -1 if none.
+    // INIT_ANY_CORE ignores affinity (single worker).
+    int claim(int core) {
+        for (size_t i = 0; i < n_; i++) {
+            Step& s = steps_[i];
+            if (s.state != InitState::Pending) continue;
+            if (core != INIT_ANY_CORE && s.core != INIT_ANY_CORE && s.core != core) continue;
+            if ((s.deps & ok_) != s.deps) continue;
+            s.state = InitState::Running;
+            return (int)i;
+        }
+        return -1;
+    }
+
+    void finish(int id, bool ok) {
+        if (id < 0 || (size_t)id >= n_ || steps_[id].state != InitState::Running) return;
+        steps_[id].state = ok ? InitState::Ok : InitState::Failed;
+        if (ok) { ok_ |= dep(id); return; }
+
+        // deps point backwards, one forward pass reaches every dependent
+        uint32_t bad = dep(id);
+        for (size_t i = (size_t)id + 1; i < n_; i++) {
+            Step& s = steps_[i];
+            if (s.state == InitState::Pending && (s.deps & bad)) {
+                s.state = InitState::Skipped;
+                bad |= dep((int)i);
+            }
+        }
+    }
+
+    // nothing pending or running
+    bool done() const {
+        for (size_t i = 0; i < n_; i++) {
+            if (steps_[i].state == InitState::Pending || steps_[i].state == InitState::Running) return false;
+        }
+        return true;
+    }
+
+    // every required step came up
+    bool ok() const {
+        for (size_t i = 0; i < n_; i++) {
+            if (steps_[i].required && steps_[i].state != InitState::Ok) return false;
+        }
+        return true;
+    }
+
+    size_t size() const { return n_; }
+    const char* name(int id) const { return steps_[id].name; }
+    InitState state(int id) const { return steps_[id].state; }
+    bool required(int id) const { return steps_[id].required; }
+    bool up(int id) const { return id >= 0 && (size_t)id < n_ && steps_[id].state == InitState::Ok; }
+
+private:
+    struct Step {
+        const char* name;
+        uint32_t deps;
+        bool required;
+        int8_t core;
+        InitState state;
+    };
+
+    Step steps_[N]{};
+    size_t n_ = 0;
+    uint32_t ok_ = 0;
+};
+
+inline const char* init_state_name(InitState s) {
+    switch (s) {
+    case InitState::Pending: return "pending";
+    case InitState::Running: return "running";
+    case InitState::Ok:      return "ok";
+    case InitState::Failed:  return "FAILED";
+    case InitState::Skipped: return "skipped";
+    }
+    return "?";
+}
@@ -0,0 +1,85 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// Builds CLI lines from whatever chunk sizes the UART driver hands over.
+// CR, LF and CRLF end a line, empty lines are dropped, backspace/DEL edit,
+// anything else non-printable is ignored. Echo for the terminal is batched
+// and handed out once per line / per chunk instead of once per key.
+//
+// on_line(char* line, size_t len, bool overflow): line is NUL terminated,
+// writable and valid until the next feed(); overflow = the line was longer
+// than N - 1 and got cut.
+// on_echo(const char* bytes, size_t n)
+template<size_t N>
+class LineAssembler {
+    static_assert(N >= 2, "need room for one char and the terminator");
+
+public:
+    template<class OnLine, class OnEcho>
+    void feed(const uint8_t* data, size_t n, OnLine&& on_line, OnEcho&& on_echo) {
+        for (size_t i = 0; i < n; i++) {
+            const uint8_t ch = data[i];
+
+            if (ch == '\r' || ch == '\n') {
+                if (len_ == 0 && !overflow_) continue;
+                echo("\r\n", 2, on_echo);
+                flush_echo(on_echo);
+                buf_[len_] = '\0';
+                on_line(buf_, len_, overflow_);
+                if (overflow_) overflows_++;
+                lines_++;
+                len_ = 0;
+                overflow_ = false;
+                continue;
+            }
+
+            if (ch == 0x08 || ch == 0x7F) {
+                if (len_ > 0 && !overflow_) {
+                    len_--;
+                    echo("\b \b", 3, on_echo);
+                }
+                continue;
+            }
+
+            if (ch < 32 || ch > 126) continue;
+
+            if (len_ >= N - 1) {
+                overflow_ = true;   // drop until end of line
+                continue;
+            }
+            buf_[len_++] = (char)ch;
+            echo((const char*)&ch, 1, on_echo);
+        }
+        flush_echo(on_echo);
+    }
+
+    void reset() { len_ = 0; overflow_ = false; echo_len_ = 0; }
+
+    size_t pending() const { return len_; }
+    uint32_t lines() const { return lines_; }
+    uint32_t overflows() const { return overflows_; }
+
+private:
+    template<class OnEcho>
+    void echo(const char* s, size_t n, OnEcho& on_echo) {
+        if (echo_len_ + n > sizeof(echo_)) flush_echo(on_echo);
+        for (size_t i = 0; i < n; i++) echo_[echo_len_++] = s[i];
+    }
+
+    template<class OnEcho>
+    void flush_echo(OnEcho& on_echo) {
+        if (echo_len_) on_echo(echo_, echo_len_);
+        echo_len_ = 0;
+    }
+
+    char buf_[N];
+    size_t len_ = 0;
+    bool overflow_ = false;
+
+    char echo_[64];
+    size_t echo_len_ = 0;
+
+    uint32_t lines_ = 0;
+    uint32_t overflows_ = 0;
+};
@@ -0,0 +1,199 @@
+#pragma once
+// Host side only (tools/membudget, tests): reads a GNU ld map file and adds up
+// what every memory region, output section and object file takes, then checks
+// that against budgets. Not for the firmware: std::string and streams.
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <istream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+struct MapRegion {
+    std::string name;
+    uint64_t origin, length;
+    uint64_t used;              // output sections whose address falls inside
+};
+
+struct MapSection {
+    std::string name;
+    uint64_t addr, size;
+};
+
+// One input section placed into an output section ('*fill*' padding included)
+struct MapInput {
+    std::string section;        // output section
+    std::string object;         // "libmain.a(app.cpp.obj)", directories stripped
+    uint64_t size;
+};
+
+struct MapFile {
+    std::vector<MapRegion> regions;
+    std::vector<MapSection> sections;
+    std::vector<MapInput> inputs;
+
+    const MapRegion* region(const std::string& name) const {
+        for (const MapRegion& r : regions) if (r.name == name) return &r;
+        return nullptr;
+    }
+    const MapSection* section(const std::string& name) const {
+        for (const MapSection& s : sections) if (s.name == name) return &s;
+        return nullptr;
+    }
+
+    // Bytes each object puts into an output section, largest first
+    std::vector<std::pair<std::string, uint64_t>> top_objects(const std::string& section, size_t n) const {
+        std::map<std::string, uint64_t> by;
+        for (const MapInput& i : inputs) if (i.section == section) by[i.object] += i.size;
+        std::vector<std::pair<std::string, uint64_t>> v(by.begin(), by.end());
+        std::stable_sort(v.begin(), v.end(), [](const auto& a, const auto& b) { return a.second > b.second; });
+        if (v.size() > n) v.resize(n);
+        return v;
+    }
+};
+
+inline bool map_hex(const std::string& s, uint64_t* v) {
+    if (s.size() < 3 || s[0] != '0' || (s[1] != 'x' && s[1] != 'X')) return false;
+    char* end = nullptr;
+    *v = strtoull(s.c_str() + 2, &end, 16);
+    return end && *end == '\0';
+}
+
+// "/a/b/libmain.a(app.cpp.obj)" -> "libmain.a(app.cpp.obj)", "/a/b/foo.o" -> "foo.o"
+inline std::string map_object_name(const std::string& path) {
+    const size_t paren = path.find('(');
+    const size_t slash = path.rfind('/', paren == std::string::npos ? std::string::npos : paren);
+    return slash == std::string::npos ? path : path.substr(slash + 1);
+}
+
+inline std::vector<std::string> map_tokens(const std::string& line) {
+    std::istringstream ss(line);
+    std::vector<std::string> t;
+    for (std::string w; ss >> w;) t.push_back(w);
+    return t;
+}
+
+// Parses the "Memory Configuration" table and the "Linker script and memory
+// map" part. Long section names make ld wrap the address/size onto the next
+// line; both forms are handled. False if neither part was found.
+inline bool map_parse(std::istream& in, MapFile* out) {
+    enum class Part { None, Memory, Map } part = Part::None;
+    std::string line, out_sec, pending_out, pending_in;
+    bool saw_memory = false, saw_map = false;
+
+    while (std::getline(in, line)) {
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        if (line.rfind("Memory Configuration", 0) == 0) { part = Part::Memory; saw_memory = true; continue; }
+        if (line.rfind("Linker script and memory map", 0) == 0) { part = Part::Map; saw_map = true; continue; }
+        if (line.rfind("Cross Reference Table", 0) == 0) break;
+
+        const std::vector<std::string> t = map_tokens(line);
+        if (t.empty()) continue;
+
+        if (part == Part::Memory) {
+            uint64_t o, l;
+            if (t.size() >= 3 && t[0] != "*default*" && map_hex(t[1], &o) && map_hex(t[2], &l))
+                out->regions.push_back(MapRegion{ t[0], o, l, 0 });
+            continue;
+        }
+        if (part != Part::Map) continue;
+
+        const bool top = line[0] != ' ' && line[0] != '\t';
+        uint64_t a, s;
+        if (top) {
+            pending_in.clear();
+            if (line[0] != '.') { out_sec.clear(); pending_out.clear(); continue; }   // LOAD, OUTPUT(...)
+            out_sec = t[0];
+            if (t.size() >= 3 && map_hex(t[1], &a) && map_hex(t[2], &s)) {
+                out->sections.push_back(MapSection{ out_sec, a, s });
+                pending_out.clear();
+            } else {
+                pending_out = out_sec;
+            }
+            continue;
+        }
+        if (out_sec.empty()) continue;
+
+        if (!pending_out.empty()) {
+            // wrapped output section: "   0x3ffb0000   0x1234"
+            if (t.size() >= 2 && map_hex(t[0], &a) && map_hex(t[1], &s))
+                out->sections.push_back(MapSection{ pending_out, a, s });
+            pending_out.clear();
+            continue;
+        }
+
+        if (!pending_in.empty()) {
+            // wrapped input section: "   0x3ffb0000   0x40 path/obj"
+            if (t.size() >= 3 && map_hex(t[0], &a) && map_hex(t[1], &s) && s)
+                out->inputs.push_back(MapInput{ out_sec, map_object_name(t[2]), s });
+            pending_in.clear();
+            continue;
+        }
+
+        if (t[0] == "*fill*") {
+            if (t.size() >= 3 && map_hex(t[1], &a) && map_hex(t[2], &s) && s)
+                out->inputs.push_back(MapInput{ out_sec, "*fill*", s });
+            continue;
+        }
+        if (t[0][0] != '.' && t[0] != "COMMON") continue;   // *(pattern) lines, symbols, assignments
+
+        if (t.size() == 1) { pending_in = t[0]; continue; }
+        if (t.size() >= 4 && map_hex(t[1], &a) && map_hex(t[2], &s) && s)
+            out->inputs.push_back(MapInput{ out_sec, map_object_name(t[3]), s });
+    }
+
+    for (const MapSection& sec : out->sections) {
+        if (!sec.size || !sec.addr) continue;       // debug sections sit at 0
+        for (MapRegion& r : out->regions) {
+            if (sec.addr >= r.origin && sec.addr < r.origin + r.length) { r.used += sec.size; break; }
+        }
+    }
+    return saw_memory || saw_map;
+}
+
+// "dram0_0_seg=85%", ".dram0.bss=48K", ".iram0.text=100000". Region names
+// first, then output sections; '%' only makes sense for a region.
+// *report gets one line either way. False = over budget or bad spec.
+inline bool map_check(const MapFile& m, const std::string& spec, std::string* report) {
+    const size_t eq = spec.find('=');
+    if (eq == std::string::npos || eq == 0 || eq + 1 >= spec.size()) {
+        *report = "bad budget '" + spec + "', want name=bytes[K|%]";
+        return false;
+    }
+    const std::string name = spec.substr(0, eq);
+    std::string lim = spec.substr(eq + 1);
+    const char unit = lim.back();
+    if (unit == 'K' || unit == 'k' || unit == '%') lim.pop_back();
+    char* end = nullptr;
+    const uint64_t n = strtoull(lim.c_str(), &end, 10);
+    if (lim.empty() || !end || *end) {
+        *report = "bad budget '" + spec + "'";
+        return false;
+    }
+
+    uint64_t used, max;
+    if (const MapRegion* r = m.region(name)) {
+        used = r->used;
+        max = unit == '%' ? r->length * n / 100 : (unit == 'K' || unit == 'k') ? n * 1024 : n;
+    } else if (const MapSection* s = m.section(name)) {
+        if (unit == '%') {
+            *report = name + ": '%' needs a region";
+            return false;
+        }
+        used = s->size;
+        max = (unit == 'K' || unit == 'k') ? n * 1024 : n;
+    } else {
+        *report = name + ": no such region or section";
+        return false;
+    }
+
+    const bool ok = used <= max;
+    std::ostringstream o;
+    o << name << " " << used << " / " << max << " B" << (ok ? "  ok" : "  OVER by ");
+    if (!ok) o << (used - max) << " B";
+    *report = o.str();
+    return ok;
+}
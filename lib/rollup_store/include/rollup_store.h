@@ -0,0 +1,239 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cmath>
+#include "app_types.h"
+#include "window_stats.h"
+
+// Fixed-memory history in three tiers:
+//   raw    - last RAW_N records, float, exact
+//   second - 1 s means for the last SEC_N seconds (int16 quantized)
+//   minute - 1 min mean/min/max for the last MIN_N minutes (int16 quantized)
+// All storage is inside the object (no heap). Queries touch at most
+// max(RAW_N, SEC_N, MIN_N) entries.
+
+enum class RollupTier : uint8_t { Raw, Second, Minute };
+
+// int16 fixed point per channel: value = q / scale
+struct RollupQuant { float scale; };
+static constexpr RollupQuant ROLLUP_QUANT[SENSOR_CH_COUNT] = {
+    {100.0f},   // temp C     +-327 C, 0.01
+    {100.0f},   // rh %       0..327, 0.01
+    {20.0f},    // press hPa  0..1638, 0.05
+    {2.0f},     // alt m      +-16383, 0.5
+    {8.0f},     // adc raw    0..4095, 0.125
+};
+
+inline int16_t rollup_q(SensorChannel c, float v) {
+    float s = v * ROLLUP_QUANT[(size_t)c].scale;
+    if (s > 32767.0f) s = 32767.0f;
+    if (s < -32767.0f) s = -32767.0f;
+    return (int16_t)lrintf(s);
+}
+inline float rollup_dq(SensorChannel c, int16_t q) {
+    return (float)q / ROLLUP_QUANT[(size_t)c].scale;
+}
+
+template <size_t RAW_N, size_t SEC_N, size_t MIN_N>
+class RollupStore {
+public:
+    static_assert(SEC_N <= 65535, "second stamps are 16 bit");
+    static_assert(SEC_N < MIN_N * 60, "minute tier must reach past the second tier");
+    static_assert(1000000 / PERIOD_MIN_US <= 65535, "samples per second must fit Sec::n");
+
+    struct Budget { size_t raw, second, minute, total; };
+
+    static constexpr Budget budget() {
+        return Budget{ sizeof(Raw), sizeof(Sec), sizeof(Min),
+                       sizeof(RollupStore) };
+    }
+
+    void push(const SensorRecord& r) {
+        // raw tier
+        raw_.t[raw_head_] = r.timestamp_ms;
+        const float v[SENSOR_CH_COUNT] = { r.temp_c, r.rh, r.press_hpa, r.alt_m, r.adc };
+        for (size_t c = 0; c < SENSOR_CH_COUNT; c++) raw_.v[c][raw_head_] = v[c];
+        raw_head_ = (raw_head_ + 1) % RAW_N;
+        if (raw_len_ < RAW_N) raw_len_++;
+
+        // roll second / minute accumulators on boundary crossings
+        const uint32_t sec = r.timestamp_ms / 1000;
+        if (have_sec_ && sec != cur_sec_) commit_second();
+        const uint32_t min = sec / 60;
+        if (have_min_ && min != cur_min_) commit_minute();
+
+        if (!have_sec_) { have_sec_ = true; cur_sec_ = sec; }
+        if (!have_min_) { have_min_ = true; cur_min_ = min; }
+        for (size_t c = 0; c < SENSOR_CH_COUNT; c++) {
+            sec_acc_[c].add(v[c]);
+            min_acc_[c].add(v[c]);
+        }
+    }
+
+    // Aggregate of channel c over (now - window, now]. Picks the finest tier that
+    // covers the window; second tier min/max are the min/max of the 1 s means.
+    StatAgg query(SensorChannel c, uint32_t now_ms, uint32_t window_ms) const {
+        StatAgg out;
+        const size_t ci = (size_t)c;
+        if (ci >= SENSOR_CH_COUNT || window_ms == 0) return out;
+
+        const uint32_t from_ms = now_ms - window_ms;   // exclusive, wrap-safe compares below
+
+        const bool raw_covers = raw_len_ < RAW_N || (uint32_t)(now_ms - oldest_raw_ms()) >= window_ms;
+        if (raw_len_ > 0 && raw_covers) {
+            for (size_t i = 0; i < raw_len_; i++) {
+                size_t idx = (raw_head_ + RAW_N - 1 - i) % RAW_N;
+                if ((int32_t)(raw_.t[idx] - from_ms) <= 0) break;
+                if ((int32_t)(raw_.t[idx] - now_ms) > 0) continue;
+                out.add(raw_.v[ci][idx]);
+            }
+            return out;
+        }
+
+        const uint32_t now_s = now_ms / 1000;
+        const uint32_t win_s = (window_ms + 999) / 1000;
+
+        if (win_s <= SEC_N) {
+            for (uint32_t k = 0; k < win_s; k++) {
+                uint32_t s = now_s - k;
+                if (have_sec_ && s == cur_sec_) { out.merge(sec_acc_[ci]); continue; }
+                size_t slot = s % SEC_N;
+                if (sec_.n[slot] == 0 || sec_.stamp[slot] != (uint16_t)s) continue;
+                StatAgg e = StatAgg::of(rollup_dq(c, sec_.mean[ci][slot]));
+                e.n = sec_.n[slot];
+                out.merge(e);
+            }
+            return out;
+        }
+
+        const uint32_t now_m = now_s / 60;
+        uint32_t win_m = (win_s + 59) / 60;
+        if (win_m > MIN_N) win_m = MIN_N;
+        for (uint32_t k = 0; k < win_m; k++) {
+            uint32_t m = now_m - k;
+            if (have_min_ && m == cur_min_) { out.merge(min_acc_[ci]); continue; }
+            size_t slot = m % MIN_N;
+            if (min_.n[slot] == 0 || min_.stamp[slot] != m) continue;
+            StatAgg e;
+            e.n = min_.n[slot];
+            e.mean = rollup_dq(c, min_.mean[ci][slot]);
+            e.min = rollup_dq(c, min_.min[ci][slot]);
+            e.max = rollup_dq(c, min_.max[ci][slot]);
+            out.merge(e);   // M2 is not kept per minute, stddev is within-minute-mean only
+        }
+        return out;
+    }
+
+    // Last n values of channel c at tier resolution, oldest first. Gaps are NAN.
+    // Returns number of values written.
+    size_t series(SensorChannel c, RollupTier tier, uint32_t now_ms, float* out, size_t n) const {
+        const size_t ci = (size_t)c;
+        if (ci >= SENSOR_CH_COUNT || !out) return 0;
+
+        if (tier == RollupTier::Raw) {
+            if (n > raw_len_) n = raw_len_;
+            for (size_t i = 0; i < n; i++) {
+                size_t idx = (raw_head_ + RAW_N - n + i) % RAW_N;
+                out[i] = raw_.v[ci][idx];
+            }
+            return n;
+        }
+
+        const uint32_t now_s = now_ms / 1000;
+        if (tier == RollupTier::Second) {
+            if (n > SEC_N) n = SEC_N;
+            for (size_t i = 0; i < n; i++) {
+                uint32_t s = now_s - (uint32_t)(n - 1 - i);
+                size_t slot = s % SEC_N;
+                if (have_sec_ && s == cur_sec_ && sec_acc_[ci].n) out[i] = sec_acc_[ci].mean;
+                else if (sec_.n[slot] && sec_.stamp[slot] == (uint16_t)s) out[i] = rollup_dq(c, sec_.mean[ci][slot]);
+                else out[i] = NAN;
+            }
+            return n;
+        }
+
+        const uint32_t now_m = now_s / 60;
+        if (n > MIN_N) n = MIN_N;
+        for (size_t i = 0; i < n; i++) {
+            uint32_t m = now_m - (uint32_t)(n - 1 - i);
+            size_t slot = m % MIN_N;
+            if (have_min_ && m == cur_min_ && min_acc_[ci].n) out[i] = min_acc_[ci].mean;
+            else if (min_.n[slot] && min_.stamp[slot] == m) out[i] = rollup_dq(c, min_.mean[ci][slot]);
+            else out[i] = NAN;
+        }
+        return n;
+    }
+
+    size_t raw_size() const { return raw_len_; }
+
+private:
+    struct Raw {
+        uint32_t t[RAW_N];
+        float v[SENSOR_CH_COUNT][RAW_N];
+    };
+    struct Sec {
+        uint16_t stamp[SEC_N];      // second number, low 16 bits
+        uint16_t n[SEC_N];          // samples in that second, 0 = empty (4000 at PERIOD_MIN_US)
+        int16_t mean[SENSOR_CH_COUNT][SEC_N];
+    };
+    struct Min {
+        uint32_t stamp[MIN_N];      // minute number
+        uint32_t n[MIN_N];          // 240000 at PERIOD_MIN_US
+        int16_t mean[SENSOR_CH_COUNT][MIN_N];
+        int16_t min[SENSOR_CH_COUNT][MIN_N];
+        int16_t max[SENSOR_CH_COUNT][MIN_N];
+    };
+
+    uint32_t oldest_raw_ms() const {
+        return raw_.t[(raw_head_ + RAW_N - raw_len_) % RAW_N];
+    }
+
+    void commit_second() {
+        size_t slot = cur_sec_ % SEC_N;
+        uint32_t n = sec_acc_[0].n;
+        sec_.stamp[slot] = (uint16_t)cur_sec_;
+        sec_.n[slot] = (uint16_t)(n > 65535 ? 65535 : n);
+        for (size_t c = 0; c < SENSOR_CH_COUNT; c++) {
+            sec_.mean[c][slot] = rollup_q((SensorChannel)c, sec_acc_[c].mean);
+            sec_acc_[c] = StatAgg{};
+        }
+        have_sec_ = false;
+    }
+
+    void commit_minute() {
+        size_t slot = cur_min_ % MIN_N;
+        uint32_t n = min_acc_[0].n;
+        min_.stamp[slot] = cur_min_;
+        min_.n[slot] = n;
+        for (size_t c = 0; c < SENSOR_CH_COUNT; c++) {
+            SensorChannel ch = (SensorChannel)c;
+            min_.mean[c][slot] = rollup_q(ch, min_acc_[c].mean);
+            min_.min[c][slot] = rollup_q(ch, min_acc_[c].min);
+            min_.max[c][slot] = rollup_q(ch, min_acc_[c].max);
+            min_acc_[c] = StatAgg{};
+        }
+        have_min_ = false;
+    }
+
+    Raw raw_{};
+    size_t raw_head_ = 0;
+    size_t raw_len_ = 0;
+
+    Sec sec_{};
+    Min min_{};
+
+    StatAgg sec_acc_[SENSOR_CH_COUNT]{};
+    StatAgg min_acc_[SENSOR_CH_COUNT]{};
+    uint32_t cur_sec_ = 0;
+    uint32_t cur_min_ = 0;
+    bool have_sec_ = false;
+    bool have_min_ = false;
+};
+
+// Device configuration: ~2 min raw at 1 Hz, 10 min of seconds, 6 h of
+// minutes. The store lives in the static App, i.e. in DRAM .bss next to the
+// stats windows, task stacks and IDF's own statics (dram0_0_seg is 176 KB on
+// the ESP32), so it gets a fixed share of that: ~25 KB.
+using DeviceRollup = RollupStore<128, 600, HISTORY_MAX_S / 60>;
+static constexpr size_t ROLLUP_BUDGET_BYTES = 26 * 1024;
+static_assert(sizeof(DeviceRollup) <= ROLLUP_BUDGET_BYTES, "history tiers over their DRAM share");
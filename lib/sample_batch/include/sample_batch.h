@@ -0,0 +1,95 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include "app_types.h"
+
+// Structure-of-arrays batch of SensorRecords. Each channel is one contiguous
+// float array, so filters / stats / serialization can run over a whole column.
+// Records in a batch have consecutive counts starting at first_count.
+template <size_t N>
+struct SampleBatch {
+    static constexpr size_t CAP = N;
+
+    uint32_t first_count = 0;
+    size_t len = 0;
+    uint32_t sent_us = 0;       // when the producer queued it, for pipeline latency
+    uint32_t timestamp_ms[N]{};
+    float ch[SENSOR_CH_COUNT][N]{};
+
+    void clear() { len = 0; }
+    bool empty() const { return len == 0; }
+    bool full() const { return len >= N; }
+
+    bool push(uint32_t count, const SensorRecord& r) {
+        if (full()) return false;
+        if (len == 0) first_count = count;
+
+        timestamp_ms[len] = r.timestamp_ms;
+        ch[(size_t)SensorChannel::TempC][len]       = r.temp_c;
+        ch[(size_t)SensorChannel::Humidity][len]    = r.rh;
+        ch[(size_t)SensorChannel::PressureHpa][len] = r.press_hpa;
+        ch[(size_t)SensorChannel::AltitudeM][len]   = r.alt_m;
+        ch[(size_t)SensorChannel::Adc][len]         = r.adc;
+        len++;
+        return true;
+    }
+
+    SensorRecord at(size_t i) const {
+        SensorRecord r{};
+        if (i >= len) return r;
+        r.timestamp_ms = timestamp_ms[i];
+        r.temp_c    = ch[(size_t)SensorChannel::TempC][i];
+        r.rh        = ch[(size_t)SensorChannel::Humidity][i];
+        r.press_hpa = ch[(size_t)SensorChannel::PressureHpa][i];
+        r.alt_m     = ch[(size_t)SensorChannel::AltitudeM][i];
+        r.adc       = ch[(size_t)SensorChannel::Adc][i];
+        return r;
+    }
+
+    const float* channel(SensorChannel c) const { return ch[(size_t)c]; }
+    float* channel(SensorChannel c) { return ch[(size_t)c]; }
+
+    uint32_t last_count() const { return len ? first_count + (uint32_t)(len - 1) : first_count; }
+    uint32_t age_ms(uint32_t now_ms) const { return len ? now_ms - timestamp_ms[0] : 0; }
+};
+
+// Whatever the consumer drained from dataQ in one wakeup, logged as one
+// RECEIVED event instead of one per batch
+struct DrainSummary {
+    uint32_t first_count = 0, last_count = 0;
+    uint32_t samples = 0, batches = 0;
+    uint32_t lat_min_us = UINT32_MAX, lat_max_us = 0;
+    uint32_t timestamp_ms = 0;      // first sample of the first batch
+
+    bool empty() const { return batches == 0; }
+
+    template <size_t N>
+    void add(const SampleBatch<N>& b, uint32_t lat_us) {
+        if (b.empty()) return;
+        if (batches == 0) {
+            first_count = b.first_count;
+            timestamp_ms = b.timestamp_ms[0];
+        }
+        last_count = b.last_count();
+        samples += (uint32_t)b.len;
+        batches++;
+        if (lat_us < lat_min_us) lat_min_us = lat_us;
+        if (lat_us > lat_max_us) lat_max_us = lat_us;
+    }
+
+    LogEvent event() const {
+        LogEvent ev{};
+        ev.type = LogType::RECEIVED;
+        ev.count = (int)first_count;
+        ev.timestamp_ms = timestamp_ms;
+        ev.last_count = last_count;
+        ev.samples = (uint16_t)(samples > UINT16_MAX ? UINT16_MAX : samples);
+        ev.batches = (uint16_t)(batches > UINT16_MAX ? UINT16_MAX : batches);
+        ev.lat_min_us = empty() ? 0 : lat_min_us;
+        ev.lat_max_us = lat_max_us;
+        return ev;
+    }
+};
+
+// Batch type used by the producer/consumer pool
+using SensorBatch = SampleBatch<16>;
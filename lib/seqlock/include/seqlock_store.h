@@ -0,0 +1,114 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+// After SEQLOCK_SPINS failed tries a reader (or a second writer) backs off.
+// On target the writer may be a lower priority task it preempted on the same
+// core ('single' / 'float' layouts): spinning would never let that writer
+// finish, and taskYIELD() only hands the core to equal or higher priorities,
+// so the back-off is a one tick sleep.
+#ifndef SEQLOCK_SPINS
+#define SEQLOCK_SPINS 64
+#endif
+#ifndef SEQLOCK_BACKOFF
+#if defined(ESP_PLATFORM)
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#define SEQLOCK_BACKOFF() vTaskDelay(1)
+#else
+#include <thread>
+#define SEQLOCK_BACKOFF() std::this_thread::yield()
+#endif
+#endif
+
+// Versioned store for a small struct that is read far more often than it is
+// written (settings). Readers never block: they copy the value and retry if a
+// writer was active meanwhile. Writers serialise on the sequence number itself
+// (even = stable, odd = write in progress), so there is no mutex anywhere.
+//
+// The payload is kept as relaxed atomic words, so a reader racing a writer
+// gets a torn copy it throws away, never undefined behaviour.
+//
+// Task context only: a stalled writer makes readers sleep (SEQLOCK_BACKOFF).
+//
+// version() goes up by one per published write; load_if_changed() lets a loop
+// skip the copy entirely when nothing moved since it last looked.
+template<class T>
+class SeqlockStore {
+    static_assert(std::is_trivially_copyable<T>::value, "T is copied word by word");
+    static constexpr size_t WORDS = (sizeof(T) + 3) / 4;
+
+public:
+    SeqlockStore() = default;
+    explicit SeqlockStore(const T& v) { store(v); }
+
+    T load() const {
+        T v;
+        load(&v);
+        return v;
+    }
+
+    // Returns the version the copy belongs to
+    uint32_t load(T* out) const {
+        uint32_t w[WORDS];
+        uint32_t s1, s2;
+        uint32_t tries = 0;
+        do {
+            if (tries && tries % SEQLOCK_SPINS == 0) SEQLOCK_BACKOFF();
+            tries++;
+            s1 = seq_.load(std::memory_order_acquire);
+            if (s1 & 1u) continue;                          // writer mid-way
+            for (size_t i = 0; i < WORDS; i++) w[i] = words_[i].load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            s2 = seq_.load(std::memory_order_relaxed);
+        } while ((s1 & 1u) || s1 != s2);
+
+        memcpy(out, w, sizeof(T));
+        return s1 >> 1;
+    }
+
+    // Copies only if a write was published since *seen; updates *seen
+    bool load_if_changed(uint32_t* seen, T* out) const {
+        if ((seq_.load(std::memory_order_acquire) >> 1) == *seen) return false;
+        *seen = load(out);
+        return true;
+    }
+
+    uint32_t version() const { return seq_.load(std::memory_order_acquire) >> 1; }
+
+    void store(const T& v) {
+        update([&](T& cur) { cur = v; });
+    }
+
+    // Read-modify-write of the whole struct, fn(T&) runs with the store owned.
+    // Keep it short: readers spin while it runs.
+    template<class F>
+    void update(F&& fn) {
+        uint32_t s = seq_.load(std::memory_order_relaxed);
+        for (uint32_t tries = 1;; tries++) {
+            if (!(s & 1u) && seq_.compare_exchange_weak(s, s + 1, std::memory_order_acquire,
+                                                         std::memory_order_relaxed))
+                break;
+            if (tries % SEQLOCK_SPINS == 0) SEQLOCK_BACKOFF();
+            s = seq_.load(std::memory_order_relaxed);
+        }
+        std::atomic_thread_fence(std::memory_order_release);    // odd seq visible before the data
+
+        uint32_t w[WORDS] = {};
+        for (size_t i = 0; i < WORDS; i++) w[i] = words_[i].load(std::memory_order_relaxed);
+        T cur;
+        memcpy(&cur, w, sizeof(T));
+        fn(cur);
+        memcpy(w, &cur, sizeof(T));
+        for (size_t i = 0; i < WORDS; i++) words_[i].store(w[i], std::memory_order_relaxed);
+
+        seq_.store(s + 2, std::memory_order_release);
+    }
+
+private:
+    std::atomic<uint32_t> seq_{0};
+    std::atomic<uint32_t> words_[WORDS] = {};
+};
@@ -0,0 +1,89 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// Keep a copy of what the panel shows and only send bytes that differ.
+// Costs 1 KB; without it flush sends the dirty column range recorded by drawing.
+#ifndef SSD1306_SHADOW_FB
+#define SSD1306_SHADOW_FB 1
+#endif
+
+// One I2C write to the panel: control byte (0x00 cmd / 0x40 data) + payload.
+// ESP side queues it on the i2c_master bus, native tests record it.
+class Ssd1306Transport {
+public:
+    virtual ~Ssd1306Transport() = default;
+    virtual bool write(uint8_t control, const uint8_t* bytes, size_t n) = 0;
+
+    // Goes up whenever a write that write() already accepted fails later on
+    // the bus. Transports that only report through write() keep the default.
+    virtual uint32_t fail_epoch() const { return 0; }
+};
+
+struct Ssd1306Stats {
+    uint32_t frames;            // flush calls
+    uint32_t bytes_last;        // I2C bytes (addr + control + payload) of last flush
+    uint32_t tx_last;           // I2C transactions of last flush
+    uint32_t pages_last;        // pages sent in last flush
+    uint64_t bytes_total;
+};
+
+// 128x64 SSD1306 in horizontal addressing mode. Owns the only framebuffer:
+// page p, column x is fb_[p * 128 + x], bit 0 = top row of the page.
+class Ssd1306Display {
+public:
+    static constexpr int WIDTH = 128;
+    static constexpr int HEIGHT = 64;
+    static constexpr int PAGES = HEIGHT / 8;
+    static constexpr size_t FB_SIZE = WIDTH * PAGES;
+
+    explicit Ssd1306Display(Ssd1306Transport& t) : tx_(t) {
+        for (int p = 0; p < PAGES; p++) { dirty_lo_[p] = 0xFF; dirty_hi_[p] = 0; }
+    }
+
+    Ssd1306Display(const Ssd1306Display&) = delete;
+    Ssd1306Display& operator=(const Ssd1306Display&) = delete;
+
+    bool init();            // power-up command sequence
+    bool clear_panel();     // zero panel RAM and framebuffer
+    bool flush();           // send changed bytes only, everything after a failed write
+    bool stale() const { return tx_.fail_epoch() != fail_epoch_; }   // a write failed since the last flush
+    void invalidate();      // next flush resends everything (after re-init)
+
+    // drawing (clipped to the panel)
+    void clear();
+    void clear_pages(int first, int count);
+    void set_pixel(int x, int y, bool on);
+    void hline(int x, int y, int w, bool on = true);
+    void vline(int x, int y, int h, bool on = true);
+    void fill_rect(int x, int y, int w, int h, bool on = true);
+    void draw_char(int x, int page, char ch);
+    int draw_text(int x, int page, const char* s);      // 6x8 cells, returns end x
+    int draw_text_2x(int x, int page, const char* s);   // 12x16 cells on page, page + 1
+
+    // raw page access, caller marks what it changed
+    uint8_t* page_ptr(int page) { return &fb_[page * WIDTH]; }
+    void mark_dirty(int page, int x0, int x1);
+
+    const uint8_t* buffer() const { return fb_; }
+    const Ssd1306Stats& stats() const { return stats_; }
+
+private:
+    bool send_cmd(const uint8_t* cmds, size_t n);
+    bool send_data(const uint8_t* data, size_t n);
+
+    Ssd1306Transport& tx_;
+    uint8_t fb_[FB_SIZE]{};
+#if SSD1306_SHADOW_FB
+    uint8_t sent_[FB_SIZE]{};
+#endif
+    // dirty column range per page, lo > hi = clean
+    uint8_t dirty_lo_[PAGES];
+    uint8_t dirty_hi_[PAGES];
+    bool force_ = true;
+    uint32_t fail_epoch_ = 0;   // transport fail_epoch() at the last flush
+
+    Ssd1306Stats stats_{};
+    uint32_t frame_bytes_ = 0;
+    uint32_t frame_tx_ = 0;
+};
@@ -0,0 +1,58 @@
+#pragma once
+#include <cstdint>
+#include "ssd1306_display.h"
+
+// Sweep-style strip chart: each new sample overwrites one column at the write
+// head and blanks the column after it as a cursor, like a scope in roll-off
+// mode. A sample therefore dirties 2 columns of the chart pages instead of the
+// whole chart, which is what shifting the graph left would cost.
+//
+// The SSD1306 hardware scroll (0x26/0x27) is not used: it scrolls continuously
+// on its own frame clock, not one column per command, and scrolls every
+// column of the selected pages, text included.
+class StripChart {
+public:
+    static constexpr int MAX_W = Ssd1306Display::WIDTH;
+    static constexpr int MAX_PAGES = Ssd1306Display::PAGES;
+
+    // chart area: columns x..x+w-1 on pages page..page+pages-1, clamped to
+    // the panel (at least 2 columns and 1 page)
+    StripChart(int x, int page, int w, int pages);
+
+    // fixed vertical range, autoscale off
+    void set_range(float lo, float hi);
+    // range follows the data, never narrower than min_span
+    void set_autoscale(float min_span);
+
+    // draws the sample into the display framebuffer and marks what changed
+    void push(Ssd1306Display& d, float v);
+    // full repaint of the chart area (after rescale or an external clear)
+    void redraw(Ssd1306Display& d);
+    void reset(Ssd1306Display& d);
+
+    int x() const { return x_; }
+    int width() const { return w_; }
+    int pages() const { return pages_; }
+    int head() const { return head_; }
+    int count() const { return count_; }
+    float lo() const { return lo_; }
+    float hi() const { return hi_; }
+    uint32_t redraws() const { return redraws_; }
+
+private:
+    int to_y(float v) const;
+    void draw_column(Ssd1306Display& d, int col);
+    void blank_column(Ssd1306Display& d, int col);
+    bool fit_range();   // true if lo_/hi_ changed
+
+    int x_, page_, w_, pages_;
+    float vals_[MAX_W];
+    int head_ = 0;      // next column to write
+    int count_ = 0;     // valid columns, saturates at w_
+
+    bool auto_ = true;
+    float min_span_ = 1.0f;
+    float lo_ = 0.0f, hi_ = 1.0f;
+    bool have_range_ = false;
+    uint32_t redraws_ = 0;
+};
@@ -0,0 +1,181 @@
+#include "ssd1306_display.h"
+#include <cstring>
+#include "text_render.h"
+
+bool Ssd1306Display::send_cmd(const uint8_t* cmds, size_t n) {
+    frame_bytes_ += 2 + n;  // address + control + payload
+    frame_tx_++;
+    return tx_.write(0x00, cmds, n);
+}
+
+bool Ssd1306Display::send_data(const uint8_t* data, size_t n) {
+    frame_bytes_ += 2 + n;
+    frame_tx_++;
+    return tx_.write(0x40, data, n);
+}
+
+bool Ssd1306Display::init() {
+    const uint8_t seq[] = {
+        0xAE,       // display off
+        0xD5, 0x80, // clock
+        0xA8, 0x3F, // multiplex 1/64
+        0xD3, 0x00, // offset
+        0x40,       // start line
+        0x8D, 0x14, // charge pump
+        0x20, 0x00, // memory mode = horizontal
+        0xA1,       // segment remap
+        0xC8,       // COM scan dec
+        0xDA, 0x12, // COM pins
+        0x81, 0x7F, // contrast
+        0xD9, 0xF1, // precharge
+        0xDB, 0x40, // vcomh
+        0xA4,       // resume RAM
+        0xA6,       // normal display
+        0xAF        // display on
+    };
+    return send_cmd(seq, sizeof(seq));
+}
+
+bool Ssd1306Display::clear_panel() {
+    const uint8_t set_addr[] = {
+        0x21, 0x00, 0x7F, // col 0..127
+        0x22, 0x00, 0x07  // page 0..7
+    };
+    if (!send_cmd(set_addr, sizeof(set_addr))) return false;
+
+    static const uint8_t zero[WIDTH] = {}; // one page row
+    for (int page = 0; page < PAGES; page++) {
+        if (!send_data(zero, sizeof(zero))) return false;
+    }
+
+    memset(fb_, 0, sizeof(fb_));
+#if SSD1306_SHADOW_FB
+    memset(sent_, 0, sizeof(sent_));
+#endif
+    memset(dirty_lo_, 0xFF, sizeof(dirty_lo_));
+    memset(dirty_hi_, 0x00, sizeof(dirty_hi_));
+    force_ = false;
+    return true;
+}
+
+void Ssd1306Display::invalidate() {
+    force_ = true;
+}
+
+void Ssd1306Display::mark_dirty(int page, int x0, int x1) {
+    if (page < 0 || page >= PAGES) return;
+    if (x0 < 0) x0 = 0;
+    if (x1 > WIDTH - 1) x1 = WIDTH - 1;
+    if (x0 > x1) return;
+    if (x0 < dirty_lo_[page]) dirty_lo_[page] = (uint8_t)x0;
+    if (x1 > dirty_hi_[page]) dirty_hi_[page] = (uint8_t)x1;
+}
+
+bool Ssd1306Display::flush() {
+    frame_bytes_ = 0;
+    frame_tx_ = 0;
+    uint32_t pages = 0;
+
+    // sent_ assumes every queued byte arrived; once one didn't, nothing in
+    // it can be trusted and the whole frame goes out again
+    const uint32_t fe = tx_.fail_epoch();
+    if (fe != fail_epoch_) {
+        fail_epoch_ = fe;
+        force_ = true;
+    }
+
+    for (int page = 0; page < PAGES; page++) {
+        int c0 = force_ ? 0 : dirty_lo_[page];
+        int c1 = force_ ? WIDTH - 1 : dirty_hi_[page];
+        if (c0 > c1) continue;
+
+        const uint8_t* cur = &fb_[page * WIDTH];
+#if SSD1306_SHADOW_FB
+        // trim the drawn range to bytes that really changed
+        uint8_t* sent = &sent_[page * WIDTH];
+        if (!force_) {
+            while (c0 <= c1 && cur[c0] == sent[c0]) c0++;
+            if (c0 > c1) { dirty_lo_[page] = 0xFF; dirty_hi_[page] = 0; continue; }
+            while (cur[c1] == sent[c1]) c1--;
+        }
+#endif
+
+        const uint8_t set_addr[] = { 0x21, (uint8_t)c0, (uint8_t)c1, 0x22, (uint8_t)page, (uint8_t)page };
+        if (!send_cmd(set_addr, sizeof(set_addr))) return false;
+
+        const size_t n = (size_t)(c1 - c0 + 1);
+        if (!send_data(&cur[c0], n)) return false;
+
+#if SSD1306_SHADOW_FB
+        memcpy(&sent[c0], &cur[c0], n);
+#endif
+        dirty_lo_[page] = 0xFF;
+        dirty_hi_[page] = 0;
+        pages++;
+    }
+    force_ = false;
+
+    stats_.frames++;
+    stats_.bytes_last = frame_bytes_;
+    stats_.tx_last = frame_tx_;
+    stats_.pages_last = pages;
+    stats_.bytes_total += frame_bytes_;
+    return true;
+}
+
+void Ssd1306Display::clear() {
+    memset(fb_, 0, sizeof(fb_));
+    for (int p = 0; p < PAGES; p++) mark_dirty(p, 0, WIDTH - 1);
+}
+
+void Ssd1306Display::clear_pages(int first, int count) {
+    if (first < 0) { count += first; first = 0; }
+    if (first + count > PAGES) count = PAGES - first;
+    if (count <= 0) return;
+    memset(&fb_[first * WIDTH], 0, (size_t)count * WIDTH);
+    for (int p = first; p < first + count; p++) mark_dirty(p, 0, WIDTH - 1);
+}
+
+void Ssd1306Display::set_pixel(int x, int y, bool on) {
+    if (x < 0 || x >= WIDTH || y < 0 || y >= HEIGHT) return;
+    uint8_t& b = fb_[(y >> 3) * WIDTH + x];
+    const uint8_t bit = (uint8_t)(1u << (y & 7));
+    if (on) b |= bit; else b &= (uint8_t)~bit;
+    mark_dirty(y >> 3, x, x);
+}
+
+void Ssd1306Display::hline(int x, int y, int w, bool on) {
+    for (int i = 0; i < w; i++) set_pixel(x + i, y, on);
+}
+
+void Ssd1306Display::vline(int x, int y, int h, bool on) {
+    for (int i = 0; i < h; i++) set_pixel(x, y + i, on);
+}
+
+void Ssd1306Display::fill_rect(int x, int y, int w, int h, bool on) {
+    for (int i = 0; i < h; i++) hline(x, y + i, w, on);
+}
+
+void Ssd1306Display::draw_char(int x, int page, char ch) {
+    const char s[2] = {ch, 0};
+    draw_text(x, page, s);
+}
+
+int Ssd1306Display::draw_text(int x, int page, const char* s) {
+    if (page < 0 || page > PAGES - 1) return x;
+    PageBuffer pb{fb_, WIDTH, PAGES};
+    int end = text_draw(pb, x, page, s);
+    if (end > x) mark_dirty(page, x, end - 1);
+    return end;
+}
+
+int Ssd1306Display::draw_text_2x(int x, int page, const char* s) {
+    if (page < 0 || page > PAGES - 2) return x;
+    PageBuffer pb{fb_, WIDTH, PAGES};
+    int end = text_draw_2x(pb, x, page, s);
+    if (end > x) {
+        mark_dirty(page, x, end - 1);
+        mark_dirty(page + 1, x, end - 1);
+    }
+    return end;
+}
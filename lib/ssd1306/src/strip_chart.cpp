@@ -0,0 +1,124 @@
+#include "strip_chart.h"
+#include <cmath>
+
+StripChart::StripChart(int x, int page, int w, int pages)
+    : x_(x), page_(page), w_(w), pages_(pages) {
+    if (x_ < 0) x_ = 0;
+    if (x_ > MAX_W - 2) x_ = MAX_W - 2;
+    if (w_ > MAX_W - x_) w_ = MAX_W - x_;
+    if (w_ < 2) w_ = 2;
+    if (page_ < 0) page_ = 0;
+    if (page_ > MAX_PAGES - 1) page_ = MAX_PAGES - 1;
+    if (pages_ > MAX_PAGES - page_) pages_ = MAX_PAGES - page_;
+    if (pages_ < 1) pages_ = 1;
+    for (int i = 0; i < MAX_W; i++) vals_[i] = NAN;
+}
+
+void StripChart::set_range(float lo, float hi) {
+    auto_ = false;
+    lo_ = lo;
+    hi_ = hi > lo ? hi : lo + 1.0f;
+    have_range_ = true;
+}
+
+void StripChart::set_autoscale(float min_span) {
+    auto_ = true;
+    min_span_ = min_span > 0.0f ? min_span : 1.0f;
+    have_range_ = false;
+}
+
+int StripChart::to_y(float v) const {
+    // top row of the chart = hi_, bottom row = lo_
+    const int h = pages_ * 8;
+    float f = (v - lo_) / (hi_ - lo_);
+    int y = (h - 1) - (int)lrintf(f * (float)(h - 1));
+    if (y < 0) y = 0;
+    if (y > h - 1) y = h - 1;
+    return y;
+}
+
+bool StripChart::fit_range() {
+    if (!auto_) return false;
+
+    float mn = INFINITY, mx = -INFINITY;
+    for (int i = 0; i < w_; i++) {
+        if (std::isnan(vals_[i])) continue;
+        if (vals_[i] < mn) mn = vals_[i];
+        if (vals_[i] > mx) mx = vals_[i];
+    }
+    if (mn > mx) return false;
+
+    // pad so the trace does not sit on the border, keep a minimum span
+    float span = mx - mn;
+    if (span < min_span_) span = min_span_;
+    const float mid = 0.5f * (mn + mx);
+    const float lo = mid - 0.6f * span;
+    const float hi = mid + 0.6f * span;
+
+    if (have_range_ && lo == lo_ && hi == hi_) return false;
+    lo_ = lo;
+    hi_ = hi;
+    have_range_ = true;
+    return true;
+}
+
+void StripChart::blank_column(Ssd1306Display& d, int col) {
+    const int x = x_ + col;
+    for (int p = 0; p < pages_; p++) {
+        d.page_ptr(page_ + p)[x] = 0x00;
+        d.mark_dirty(page_ + p, x, x);
+    }
+}
+
+void StripChart::draw_column(Ssd1306Display& d, int col) {
+    const float v = vals_[col];
+    const int x = x_ + col;
+    uint8_t colbits[MAX_PAGES] = {};
+
+    if (!std::isnan(v)) {
+        // vertical segment from the previous sample keeps steps connected
+        int y0 = to_y(v), y1 = y0;
+        const int prev = (col + w_ - 1) % w_;
+        if (col > 0 && !std::isnan(vals_[prev])) y1 = to_y(vals_[prev]);
+        if (y1 < y0) { int t = y0; y0 = y1; y1 = t; }
+        for (int y = y0; y <= y1; y++) colbits[y >> 3] |= (uint8_t)(1u << (y & 7));
+    }
+
+    for (int p = 0; p < pages_; p++) {
+        d.page_ptr(page_ + p)[x] = colbits[p];
+        d.mark_dirty(page_ + p, x, x);
+    }
+}
+
+void StripChart::push(Ssd1306Display& d, float v) {
+    const bool out_of_range = have_range_ && (v < lo_ || v > hi_);
+
+    vals_[head_] = v;
+    if (count_ < w_) count_++;
+    const int col = head_;
+    head_ = (head_ + 1) % w_;
+
+    // rescale on a value outside the range, and once per sweep so the range
+    // can also shrink; both repaint, every other sample costs 2 columns
+    if (auto_ && (!have_range_ || out_of_range || head_ == 0) && fit_range()) {
+        redraw(d);
+        return;
+    }
+
+    draw_column(d, col);
+    blank_column(d, head_);
+}
+
+void StripChart::redraw(Ssd1306Display& d) {
+    redraws_++;
+    for (int c = 0; c < w_; c++) draw_column(d, c);
+    if (count_ > 0) blank_column(d, head_);
+}
+
+void StripChart::reset(Ssd1306Display& d) {
+    for (int i = 0; i < MAX_W; i++) vals_[i] = NAN;
+    head_ = 0;
+    count_ = 0;
+    if (auto_) have_range_ = false;
+    for (int c = 0; c < w_; c++) blank_column(d, c);
+}
@@ -0,0 +1,74 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include "ssd1306_display.h"
+
+// Host model of an SSD1306 on I2C. Takes the same control + payload writes
+// the ESP transport puts on the bus, keeps GDDRAM and the address pointer the
+// way the controller does, and counts what each frame costs on the wire.
+// Native builds only; plug it in where the ESP side uses I2cOledTransport.
+
+struct SimCounters {
+    uint32_t transactions;      // I2C writes (START .. STOP)
+    uint32_t bytes;             // address + control + payload
+    uint32_t cmd_bytes;         // payload bytes of 0x00 writes
+    uint32_t data_bytes;        // payload bytes of 0x40 writes (GDDRAM)
+};
+
+class Ssd1306Sim : public Ssd1306Transport {
+public:
+    static constexpr int WIDTH = 128;
+    static constexpr int PAGES = 8;
+    static constexpr int HEIGHT = PAGES * 8;
+
+    enum class AddrMode : uint8_t { Horizontal = 0, Vertical = 1, Page = 2 };
+
+    Ssd1306Sim() { reset(); }
+
+    // power-on state: RAM cleared, page addressing, display off
+    void reset();
+
+    // one I2C write: control byte (0x00 / 0x40, Co bit 0x80 clear) + payload
+    bool write(uint8_t control, const uint8_t* bytes, size_t n) override;
+    // raw I2C payload after the address byte, control bytes included;
+    // handles Co = 1 (one control + one byte pairs) as well
+    bool feed(const uint8_t* buf, size_t n);
+
+    // GDDRAM as stored, page p column x at ram()[p * 128 + x]
+    const uint8_t* ram() const { return ram_; }
+    // what the panel shows, with segment remap / COM scan / invert applied
+    bool pixel(int x, int y) const;
+    bool display_on() const { return on_; }
+    AddrMode mode() const { return mode_; }
+    uint32_t unknown_cmds() const { return unknown_; }
+
+    // ASCII PBM (P1) of the panel. Returns bytes written, 0 if cap too small.
+    size_t render_pbm(char* out, size_t cap) const;
+    bool save_pbm(const char* path) const;
+
+    const SimCounters& counters() const { return c_; }
+    void reset_counters() { c_ = SimCounters{}; }
+
+    // wire time for the counted traffic: 9 clocks per byte plus START/STOP
+    static double bus_us(const SimCounters& c, uint32_t scl_hz);
+
+private:
+    void command(uint8_t b);
+    void data(uint8_t b);
+
+    uint8_t ram_[WIDTH * PAGES];
+
+    AddrMode mode_;
+    uint8_t col_, page_;
+    uint8_t col_lo_, col_hi_, page_lo_, page_hi_;
+    bool on_, seg_remap_, com_rev_, invert_;
+
+    // multi-byte command being collected
+    uint8_t pend_cmd_ = 0;
+    uint8_t pend_need_ = 0;
+    uint8_t pend_args_[6];
+    uint8_t pend_got_ = 0;
+
+    uint32_t unknown_ = 0;
+    SimCounters c_{};
+};
@@ -0,0 +1,188 @@
+#include "ssd1306_sim.h"
+#include <cstdio>
+#include <cstring>
+
+// argument bytes that follow each multi-byte command
+static uint8_t arg_count(uint8_t cmd) {
+    switch (cmd) {
+    case 0x20: case 0x81: case 0x8D: case 0xA8: case 0xD3:
+    case 0xD5: case 0xD9: case 0xDA: case 0xDB:
+        return 1;
+    case 0x21: case 0x22: case 0xA3:
+        return 2;
+    case 0x29: case 0x2A:
+        return 5;
+    case 0x26: case 0x27:
+        return 6;
+    default:
+        return 0;
+    }
+}
+
+void Ssd1306Sim::reset() {
+    memset(ram_, 0, sizeof(ram_));
+    mode_ = AddrMode::Page;
+    col_ = page_ = 0;
+    col_lo_ = 0; col_hi_ = WIDTH - 1;
+    page_lo_ = 0; page_hi_ = PAGES - 1;
+    on_ = seg_remap_ = com_rev_ = invert_ = false;
+    pend_need_ = pend_got_ = 0;
+    unknown_ = 0;
+    c_ = SimCounters{};
+}
+
+bool Ssd1306Sim::write(uint8_t control, const uint8_t* bytes, size_t n) {
+    c_.transactions++;
+    c_.bytes += 2 + n;
+
+    if (control == 0x00) {
+        c_.cmd_bytes += n;
+        for (size_t i = 0; i < n; i++) command(bytes[i]);
+        return true;
+    }
+    if (control == 0x40) {
+        c_.data_bytes += n;
+        for (size_t i = 0; i < n; i++) data(bytes[i]);
+        return true;
+    }
+    return false;
+}
+
+bool Ssd1306Sim::feed(const uint8_t* buf, size_t n) {
+    if (n == 0) return false;
+    c_.transactions++;
+    c_.bytes += 1 + n;
+
+    size_t i = 0;
+    while (i < n) {
+        const uint8_t ctrl = buf[i++];
+        const bool is_data = ctrl & 0x40;
+        if (ctrl & 0x80) {
+            // Co = 1: exactly one byte, then another control byte
+            if (i >= n) return false;
+            if (is_data) { c_.data_bytes++; data(buf[i++]); }
+            else { c_.cmd_bytes++; command(buf[i++]); }
+            continue;
+        }
+        // Co = 0: the rest of the transaction is this stream
+        for (; i < n; i++) {
+            if (is_data) { c_.data_bytes++; data(buf[i]); }
+            else { c_.cmd_bytes++; command(buf[i]); }
+        }
+    }
+    return true;
+}
+
+void Ssd1306Sim::command(uint8_t b) {
+    if (pend_need_) {
+        pend_args_[pend_got_++] = b;
+        if (pend_got_ < pend_need_) return;
+        pend_need_ = 0;
+
+        const uint8_t* a = pend_args_;
+        switch (pend_cmd_) {
+        case 0x20:
+            mode_ = (a[0] & 0x03) <= 2 ? (AddrMode)(a[0] & 0x03) : AddrMode::Page;
+            break;
+        case 0x21:
+            col_lo_ = a[0] & 0x7F; col_hi_ = a[1] & 0x7F;
+            col_ = col_lo_;
+            break;
+        case 0x22:
+            page_lo_ = a[0] & 0x07; page_hi_ = a[1] & 0x07;
+            page_ = page_lo_;
+            break;
+        default:
+            break;  // timing / analog settings, nothing to model
+        }
+        return;
+    }
+
+    const uint8_t n = arg_count(b);
+    if (n) {
+        pend_cmd_ = b;
+        pend_need_ = n;
+        pend_got_ = 0;
+        return;
+    }
+
+    if (b <= 0x0F) { col_ = (col_ & 0xF0) | b; return; }                         // lower column (page mode)
+    if (b >= 0x10 && b <= 0x17) { col_ = (uint8_t)((col_ & 0x0F) | ((b & 0x07) << 4)); return; }
+    if (b >= 0x40 && b <= 0x7F) return;                                          // start line
+    if (b >= 0xB0 && b <= 0xB7) { page_ = b & 0x07; return; }
+
+    switch (b) {
+    case 0xAE: on_ = false; break;
+    case 0xAF: on_ = true; break;
+    case 0xA0: seg_remap_ = false; break;
+    case 0xA1: seg_remap_ = true; break;
+    case 0xC0: com_rev_ = false; break;
+    case 0xC8: com_rev_ = true; break;
+    case 0xA6: invert_ = false; break;
+    case 0xA7: invert_ = true; break;
+    case 0xA4: case 0xA5: case 0x2E: case 0x2F: case 0xE3: break;
+    default: unknown_++; break;
+    }
+}
+
+void Ssd1306Sim::data(uint8_t b) {
+    ram_[page_ * WIDTH + col_] = b;
+
+    switch (mode_) {
+    case AddrMode::Horizontal:
+        if (col_ < col_hi_) { col_++; break; }
+        col_ = col_lo_;
+        page_ = page_ < page_hi_ ? page_ + 1 : page_lo_;
+        break;
+    case AddrMode::Vertical:
+        if (page_ < page_hi_) { page_++; break; }
+        page_ = page_lo_;
+        col_ = col_ < col_hi_ ? col_ + 1 : col_lo_;
+        break;
+    case AddrMode::Page:
+        col_ = (uint8_t)((col_ + 1) % WIDTH);  // wraps within the page
+        break;
+    }
+}
+
+bool Ssd1306Sim::pixel(int x, int y) const {
+    if (x < 0 || x >= WIDTH || y < 0 || y >= HEIGHT) return false;
+    // A1 maps column 0 to the left edge, C8 maps page 0 to the top on the
+    // usual 128x64 modules; the reset values mirror each axis
+    const int cx = seg_remap_ ? x : WIDTH - 1 - x;
+    const int ry = com_rev_ ? y : HEIGHT - 1 - y;
+    bool on = (ram_[(ry >> 3) * WIDTH + cx] >> (ry & 7)) & 1;
+    return on != invert_;
+}
+
+size_t Ssd1306Sim::render_pbm(char* out, size_t cap) const {
+    int n = snprintf(out, cap, "P1\n%d %d\n", WIDTH, HEIGHT);
+    if (n < 0 || (size_t)n >= cap) return 0;
+    size_t pos = (size_t)n;
+    if (pos + (size_t)HEIGHT * (WIDTH + 1) + 1 > cap) return 0;
+
+    for (int y = 0; y < HEIGHT; y++) {
+        for (int x = 0; x < WIDTH; x++) out[pos++] = (on_ && pixel(x, y)) ? '1' : '0';
+        out[pos++] = '\n';
+    }
+    out[pos] = '\0';
+    return pos;
+}
+
+bool Ssd1306Sim::save_pbm(const char* path) const {
+    static char buf[32 + HEIGHT * (WIDTH + 1) + 1];
+    size_t n = render_pbm(buf, sizeof(buf));
+    if (!n) return false;
+    FILE* f = fopen(path, "w");
+    if (!f) return false;
+    bool ok = fwrite(buf, 1, n, f) == n;
+    fclose(f);
+    return ok;
+}
+
+double Ssd1306Sim::bus_us(const SimCounters& c, uint32_t scl_hz) {
+    if (!scl_hz) return 0.0;
+    // 8 data bits + ACK per byte, ~1 clock each for START and STOP
+    const double clocks = 9.0 * c.bytes + 2.0 * c.transactions;
+    return clocks * 1e6 / scl_hz;
+}
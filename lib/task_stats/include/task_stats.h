@@ -0,0 +1,152 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// Per-task CPU share between two run-time stats snapshots. The kernel hands
+// out absolute run-time counters (us since boot, 32 bit, wraps after ~71 min);
+// only the difference between two 'stats' calls means anything, so the last
+// counter of every task is kept here, keyed by its task number.
+struct TaskSample {
+    uint32_t id;            // uxTaskNumber, unique for the life of the task
+    const char* name;
+    uint32_t runtime;       // run-time counter, us
+    uint32_t stack_free;    // high-water mark, bytes never used
+    uint8_t prio;
+    int8_t core;            // -1 = no affinity
+};
+
+template<size_t N>
+class TaskCpuTracker {
+public:
+    // permille[i] = share of one core task s[i] had since the previous update
+    // (1000 = one core flat out). Tasks new since then report their whole
+    // counter over the window. Returns the window length in us, 0 on the first call.
+    uint32_t update(const TaskSample* s, size_t n, uint32_t total_runtime, uint16_t* permille) {
+        const uint32_t window = have_prev_ ? total_runtime - prev_total_ : 0;
+
+        for (size_t i = 0; i < n; i++) {
+            uint32_t prev = 0;
+            for (size_t k = 0; k < n_prev_; k++) {
+                if (prev_id_[k] == s[i].id) { prev = prev_rt_[k]; break; }
+            }
+            const uint32_t ran = s[i].runtime - prev;
+            uint64_t pm = window ? (uint64_t)ran * 1000u / window : 0;
+            permille[i] = (uint16_t)(pm > 1000 ? 1000 : pm);
+        }
+
+        n_prev_ = n < N ? n : N;
+        for (size_t i = 0; i < n_prev_; i++) {
+            prev_id_[i] = s[i].id;
+            prev_rt_[i] = s[i].runtime;
+        }
+        prev_total_ = total_runtime;
+        have_prev_ = true;
+        return window;
+    }
+
+private:
+    uint32_t prev_id_[N] = {};
+    uint32_t prev_rt_[N] = {};
+    size_t n_prev_ = 0;
+    uint32_t prev_total_ = 0;
+    bool have_prev_ = false;
+};
+
+// Rate of a free running counter between two reads, per second (wrap safe)
+struct RateMeter {
+    uint32_t last_count = 0;
+    uint32_t last_us = 0;
+    bool primed = false;
+
+    uint32_t per_s(uint32_t count, uint32_t now_us) {
+        uint32_t r = 0;
+        if (primed && now_us != last_us) r = (uint32_t)((uint64_t)(count - last_count) * 1000000u / (now_us - last_us));
+        last_count = count;
+        last_us = now_us;
+        primed = true;
+        return r;
+    }
+};
+
+// Latency distribution in log2 buckets (bucket b holds [2^(b-1), 2^b) us,
+// bucket 0 holds 0). Single writer; readers take a copy.
+struct LatencyStats {
+    static constexpr int BUCKETS = 32;
+
+    uint32_t count = 0;
+    uint32_t min_us = UINT32_MAX;
+    uint32_t max_us = 0;
+    uint64_t sum_us = 0;
+    uint32_t bucket[BUCKETS] = {};
+
+    void reset() { *this = LatencyStats{}; }
+
+    void add(uint32_t us) {
+        count++;
+        sum_us += us;
+        if (us < min_us) min_us = us;
+        if (us > max_us) max_us = us;
+        int b = 0;
+        while (b < BUCKETS - 1 && (us >> b) != 0) b++;
+        bucket[b]++;
+    }
+
+    uint32_t mean_us() const { return count ? (uint32_t)(sum_us / count) : 0; }
+
+    // Upper edge of the bucket holding the p-th percentile (0..100), capped at max
+    uint32_t percentile_us(uint32_t p) const {
+        if (!count) return 0;
+        const uint64_t want = ((uint64_t)count * p + 99) / 100;
+        uint64_t seen = 0;
+        for (int b = 0; b < BUCKETS; b++) {
+            seen += bucket[b];
+            if (seen >= want && seen) {
+                const uint32_t edge = b == 0 ? 0 : (b >= 32 ? UINT32_MAX : (1u << b) - 1);
+                return edge < max_us ? edge : max_us;
+            }
+        }
+        return max_us;
+    }
+};
+
+// Sampling clock jitter: how late the producer ran after each timer tick, and
+// ticks it slept through. A periodic esp_timer fires at start + k * period
+// (esp_timer_get_expiry_time() doesn't work on periodic timers), so the
+// schedule is kept here: restart() with the start stamp, then every wake
+// advances k by the notifications it took. Lateness is against that
+// schedule, so a late wake never shifts the ticks after it.
+struct ClockJitter {
+    LatencyStats late;              // wake lateness, one entry per wake
+    uint32_t missed = 0;            // ticks that piled up behind a slow iteration
+
+    uint64_t start_us = 0;          // timer (re)started here, first tick at start + period
+    uint32_t period_us = 0;         // 0 = no schedule yet
+    uint64_t k = 0;                 // index of the last tick taken
+    bool synced = false;
+
+    // Timer started or restarted with a new period: new schedule, stats cleared
+    void restart(uint64_t now_us, uint32_t period) {
+        *this = ClockJitter{};
+        start_us = now_us;
+        period_us = period;
+    }
+
+    // Ticks were thrown away (pause, boot kick): the next wake finds its place
+    // in the schedule again and isn't counted
+    void resync() { synced = false; }
+
+    // ticks: notifications taken at this wake
+    void add(uint64_t now_us, uint32_t ticks) {
+        if (!period_us || now_us < start_us) return;
+        if (!synced) {
+            k = (now_us - start_us) / period_us;
+            synced = true;
+            return;
+        }
+        k += ticks;
+        const uint64_t due = start_us + k * period_us;
+        const uint64_t l = now_us > due ? now_us - due : 0;
+        late.add(l > UINT32_MAX ? UINT32_MAX : (uint32_t)l);
+        if (ticks > 1) missed += ticks - 1;
+    }
+};
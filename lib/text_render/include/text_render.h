@@ -0,0 +1,38 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// Text rendering into an SSD1306-style page buffer (byte = 8 vertical pixels,
+// bit 0 on top, page p column x at data[p * width + x]). No hardware deps,
+// so the same code renders on target and in native tests.
+
+struct PageBuffer {
+    uint8_t* data;
+    int width;
+    int pages;
+};
+
+static constexpr int FONT_W = 6;        // 5 glyph columns + 1 spacing
+static constexpr int FONT2X_W = 12;     // 2x scaled, spans two pages
+static constexpr char FONT_FIRST = 0x20;
+static constexpr char FONT_LAST = 0x7E;
+
+// 6 column bitmap of a printable ASCII char, '?' for anything else. O(1).
+const uint8_t* font_glyph(char ch);
+
+// Draws s at column x on 'page'. Whole glyphs are copied with memcpy, only the
+// glyph crossing the right edge is clipped. Returns x after the last glyph.
+int text_draw(PageBuffer& fb, int x, int page, const char* s);
+
+// 2x scaled text (12x16 cells) on page and page + 1, clipped and blitted
+// the same way as text_draw
+int text_draw_2x(PageBuffer& fb, int x, int page, const char* s);
+
+inline int text_width(const char* s, int cell_w = FONT_W) {
+    int n = 0;
+    while (s[n]) n++;
+    return n * cell_w;
+}
+
+// Writes the buffer as ASCII PBM (P1). Returns bytes written, 0 if cap is too small.
+size_t pbm_dump(const PageBuffer& fb, char* out, size_t cap);
@@ -0,0 +1,208 @@
+#include "text_render.h"
+#include <cstdio>
+#include <cstring>
+
+// Classic 5x7 font, printable ASCII 0x20..0x7E, 6th column is the spacing
+static const uint8_t FONT5X7[FONT_LAST - FONT_FIRST + 1][FONT_W] = {
+    {0x00,0x00,0x00,0x00,0x00,0x00}, // ' '
+    {0x00,0x00,0x5F,0x00,0x00,0x00}, // !
+    {0x00,0x07,0x00,0x07,0x00,0x00}, // "
+    {0x14,0x7F,0x14,0x7F,0x14,0x00}, // #
+    {0x24,0x2A,0x7F,0x2A,0x12,0x00}, // $
+    {0x23,0x13,0x08,0x64,0x62,0x00}, // %
+    {0x36,0x49,0x55,0x22,0x50,0x00}, // &
+    {0x00,0x05,0x03,0x00,0x00,0x00}, // '
+    {0x00,0x1C,0x22,0x41,0x00,0x00}, // (
+    {0x00,0x41,0x22,0x1C,0x00,0x00}, // )
+    {0x08,0x2A,0x1C,0x2A,0x08,0x00}, // *
+    {0x08,0x08,0x3E,0x08,0x08,0x00}, // +
+    {0x00,0x50,0x30,0x00,0x00,0x00}, // ,
+    {0x08,0x08,0x08,0x08,0x08,0x00}, // -
+    {0x00,0x60,0x60,0x00,0x00,0x00}, // .
+    {0x20,0x10,0x08,0x04,0x02,0x00}, // /
+    {0x3E,0x51,0x49,0x45,0x3E,0x00}, // 0
+    {0x00,0x42,0x7F,0x40,0x00,0x00}, // 1
+    {0x42,0x61,0x51,0x49,0x46,0x00}, // 2
+    {0x21,0x41,0x45,0x4B,0x31,0x00}, // 3
+    {0x18,0x14,0x12,0x7F,0x10,0x00}, // 4
+    {0x27,0x45,0x45,0x45,0x39,0x00}, // 5
+    {0x3C,0x4A,0x49,0x49,0x30,0x00}, // 6
+    {0x01,0x71,0x09,0x05,0x03,0x00}, // 7
+    {0x36,0x49,0x49,0x49,0x36,0x00}, // 8
+    {0x06,0x49,0x49,0x29,0x1E,0x00}, // 9
+    {0x00,0x36,0x36,0x00,0x00,0x00}, // :
+    {0x00,0x56,0x36,0x00,0x00,0x00}, // ;
+    {0x08,0x14,0x22,0x41,0x00,0x00}, // <
+    {0x14,0x14,0x14,0x14,0x14,0x00}, // =
+    {0x00,0x41,0x22,0x14,0x08,0x00}, // >
+    {0x02,0x01,0x51,0x09,0x06,0x00}, // ?
+    {0x32,0x49,0x79,0x41,0x3E,0x00}, // @
+    {0x7E,0x11,0x11,0x11,0x7E,0x00}, // A
+    {0x7F,0x49,0x49,0x49,0x36,0x00}, // B
+    {0x3E,0x41,0x41,0x41,0x22,0x00}, // C
+    {0x7F,0x41,0x41,0x22,0x1C,0x00}, // D
+    {0x7F,0x49,0x49,0x49,0x41,0x00}, // E
+    {0x7F,0x09,0x09,0x09,0x01,0x00}, // F
+    {0x3E,0x41,0x49,0x49,0x7A,0x00}, // G
+    {0x7F,0x08,0x08,0x08,0x7F,0x00}, // H
+    {0x00,0x41,0x7F,0x41,0x00,0x00}, // I
+    {0x20,0x40,0x41,0x3F,0x01,0x00}, // J
+    {0x7F,0x08,0x14,0x22,0x41,0x00}, // K
+    {0x7F,0x40,0x40,0x40,0x40,0x00}, // L
+    {0x7F,0x02,0x0C,0x02,0x7F,0x00}, // M
+    {0x7F,0x04,0x08,0x10,0x7F,0x00}, // N
+    {0x3E,0x41,0x41,0x41,0x3E,0x00}, // O
+    {0x7F,0x09,0x09,0x09,0x06,0x00}, // P
+    {0x3E,0x41,0x51,0x21,0x5E,0x00}, // Q
+    {0x7F,0x09,0x19,0x29,0x46,0x00}, // R
+    {0x46,0x49,0x49,0x49,0x31,0x00}, // S
+    {0x01,0x01,0x7F,0x01,0x01,0x00}, // T
+    {0x3F,0x40,0x40,0x40,0x3F,0x00}, // U
+    {0x1F,0x20,0x40,0x20,0x1F,0x00}, // V
+    {0x3F,0x40,0x38,0x40,0x3F,0x00}, // W
+    {0x63,0x14,0x08,0x14,0x63,0x00}, // X
+    {0x07,0x08,0x70,0x08,0x07,0x00}, // Y
+    {0x61,0x51,0x49,0x45,0x43,0x00}, // Z
+    {0x00,0x7F,0x41,0x41,0x00,0x00}, // [
+    {0x02,0x04,0x08,0x10,0x20,0x00}, // backslash
+    {0x00,0x41,0x41,0x7F,0x00,0x00}, // ]
+    {0x04,0x02,0x01,0x02,0x04,0x00}, // ^
+    {0x40,0x40,0x40,0x40,0x40,0x00}, // _
+    {0x00,0x01,0x02,0x04,0x00,0x00}, // `
+    {0x20,0x54,0x54,0x54,0x78,0x00}, // a
+    {0x7F,0x48,0x44,0x44,0x38,0x00}, // b
+    {0x38,0x44,0x44,0x44,0x20,0x00}, // c
+    {0x38,0x44,0x44,0x48,0x7F,0x00}, // d
+    {0x38,0x54,0x54,0x54,0x18,0x00}, // e
+    {0x08,0x7E,0x09,0x01,0x02,0x00}, // f
+    {0x0C,0x52,0x52,0x52,0x3E,0x00}, // g
+    {0x7F,0x08,0x04,0x04,0x78,0x00}, // h
+    {0x00,0x44,0x7D,0x40,0x00,0x00}, // i
+    {0x20,0x40,0x44,0x3D,0x00,0x00}, // j
+    {0x7F,0x10,0x28,0x44,0x00,0x00}, // k
+    {0x00,0x41,0x7F,0x40,0x00,0x00}, // l
+    {0x7C,0x04,0x18,0x04,0x78,0x00}, // m
+    {0x7C,0x08,0x04,0x04,0x78,0x00}, // n
+    {0x38,0x44,0x44,0x44,0x38,0x00}, // o
+    {0x7C,0x14,0x14,0x14,0x08,0x00}, // p
+    {0x08,0x14,0x14,0x18,0x7C,0x00}, // q
+    {0x7C,0x08,0x04,0x04,0x08,0x00}, // r
+    {0x48,0x54,0x54,0x54,0x20,0x00}, // s
+    {0x04,0x3F,0x44,0x40,0x20,0x00}, // t
+    {0x3C,0x40,0x40,0x20,0x7C,0x00}, // u
+    {0x1C,0x20,0x40,0x20,0x1C,0x00}, // v
+    {0x3C,0x40,0x30,0x40,0x3C,0x00}, // w
+    {0x44,0x28,0x10,0x28,0x44,0x00}, // x
+    {0x0C,0x50,0x50,0x50,0x3C,0x00}, // y
+    {0x44,0x64,0x54,0x4C,0x44,0x00}, // z
+    {0x00,0x08,0x36,0x41,0x00,0x00}, // {
+    {0x00,0x00,0x7F,0x00,0x00,0x00}, // |
+    {0x00,0x41,0x36,0x08,0x00,0x00}, // }
+    {0x02,0x01,0x02,0x04,0x02,0x00}, // ~
+};
+
+// 4 bits -> 8 bits with every bit doubled, for the 2x font
+static const uint8_t STRETCH4[16] = {
+    0x00, 0x03, 0x0C, 0x0F, 0x30, 0x33, 0x3C, 0x3F,
+    0xC0, 0xC3, 0xCC, 0xCF, 0xF0, 0xF3, 0xFC, 0xFF,
+};
+
+const uint8_t* font_glyph(char ch) {
+    if (ch < FONT_FIRST || ch > FONT_LAST) ch = '?';
+    return FONT5X7[ch - FONT_FIRST];
+}
+
+int text_draw(PageBuffer& fb, int x, int page, const char* s) {
+    if (!fb.data || page < 0 || page >= fb.pages || x >= fb.width) return x;
+
+    uint8_t* row = &fb.data[page * fb.width];
+
+    // left clip: skip whole glyphs that start off screen
+    while (*s && x < 0) {
+        int vis = x + FONT_W;
+        if (vis > 0) {
+            memcpy(row, font_glyph(*s) + (FONT_W - vis), (size_t)vis);
+        }
+        x += FONT_W;
+        s++;
+    }
+
+    // fast path: glyphs that fit completely
+    while (*s && x + FONT_W <= fb.width) {
+        memcpy(&row[x], font_glyph(*s++), FONT_W);
+        x += FONT_W;
+    }
+
+    // the one glyph crossing the right edge
+    if (*s && x < fb.width) {
+        memcpy(&row[x], font_glyph(*s), (size_t)(fb.width - x));
+        x += FONT_W;
+    }
+    return x;
+}
+
+// One 2x glyph as two 12 column halves, ready to blit
+static void glyph_2x(char ch, uint8_t top[FONT2X_W], uint8_t bot[FONT2X_W]) {
+    const uint8_t* g = font_glyph(ch);
+    for (int c = 0; c < FONT_W; c++) {
+        top[2 * c] = top[2 * c + 1] = STRETCH4[g[c] & 0x0F];
+        bot[2 * c] = bot[2 * c + 1] = STRETCH4[g[c] >> 4];
+    }
+}
+
+int text_draw_2x(PageBuffer& fb, int x, int page, const char* s) {
+    if (!fb.data || page < 0 || page + 1 >= fb.pages || x >= fb.width) return x;
+
+    uint8_t* top = &fb.data[page * fb.width];
+    uint8_t* bot = &fb.data[(page + 1) * fb.width];
+    uint8_t gt[FONT2X_W], gb[FONT2X_W];
+
+    // left clip, same as text_draw
+    while (*s && x < 0) {
+        int vis = x + FONT2X_W;
+        if (vis > 0) {
+            glyph_2x(*s, gt, gb);
+            memcpy(top, gt + (FONT2X_W - vis), (size_t)vis);
+            memcpy(bot, gb + (FONT2X_W - vis), (size_t)vis);
+        }
+        x += FONT2X_W;
+        s++;
+    }
+
+    while (*s && x + FONT2X_W <= fb.width) {
+        glyph_2x(*s++, gt, gb);
+        memcpy(&top[x], gt, FONT2X_W);
+        memcpy(&bot[x], gb, FONT2X_W);
+        x += FONT2X_W;
+    }
+
+    if (*s && x < fb.width) {
+        glyph_2x(*s, gt, gb);
+        memcpy(&top[x], gt, (size_t)(fb.width - x));
+        memcpy(&bot[x], gb, (size_t)(fb.width - x));
+        x += FONT2X_W;
+    }
+    return x;
+}
+
+size_t pbm_dump(const PageBuffer& fb, char* out, size_t cap) {
+    if (!fb.data || !out) return 0;
+    const int h = fb.pages * 8;
+
+    int n = snprintf(out, cap, "P1\n%d %d\n", fb.width, h);
+    if (n < 0 || (size_t)n >= cap) return 0;
+    size_t pos = (size_t)n;
+
+    // one char per pixel plus newline per row
+    const size_t need = pos + (size_t)h * (size_t)(fb.width + 1) + 1;
+    if (need > cap) return 0;
+
+    for (int y = 0; y < h; y++) {
+        const uint8_t* row = &fb.data[(y >> 3) * fb.width];
+        const uint8_t bit = (uint8_t)(1u << (y & 7));
+        for (int x = 0; x < fb.width; x++) out[pos++] = (row[x] & bit) ? '1' : '0';
+        out[pos++] = '\n';
+    }
+    out[pos] = '\0';
+    return pos;
+}
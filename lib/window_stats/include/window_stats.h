@@ -0,0 +1,222 @@
+#pragma once
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include "app_types.h"
+
+// Count / mean / M2 (Welford) plus min and max. Aggregates can be merged and
+// "un-merged" (Chan et al.), which lets a sliding window drop its oldest entry in O(1).
+struct StatAgg {
+    uint32_t n = 0;
+    float mean = 0.0f;
+    float m2 = 0.0f;
+    float min = 0.0f;
+    float max = 0.0f;
+
+    static StatAgg of(float x) { return StatAgg{1, x, 0.0f, x, x}; }
+
+    void add(float x) {
+        if (n == 0) { *this = of(x); return; }
+        n++;
+        float d = x - mean;
+        mean += d / (float)n;
+        m2 += d * (x - mean);
+        if (x < min) min = x;
+        if (x > max) max = x;
+    }
+
+    void merge(const StatAgg& b) {
+        if (b.n == 0) return;
+        if (n == 0) { *this = b; return; }
+        uint32_t nt = n + b.n;
+        float d = b.mean - mean;
+        mean += d * (float)b.n / (float)nt;
+        m2 += b.m2 + d * d * (float)n * (float)b.n / (float)nt;
+        n = nt;
+        if (b.min < min) min = b.min;
+        if (b.max > max) max = b.max;
+    }
+
+    // Removes b's count/mean/M2 contribution. min/max are left alone,
+    // the window keeps them with monotonic deques.
+    void unmerge(const StatAgg& b) {
+        if (b.n == 0) return;
+        if (b.n >= n) { n = 0; mean = 0.0f; m2 = 0.0f; return; }
+        uint32_t na = n - b.n;
+        float mean_a = ((float)n * mean - (float)b.n * b.mean) / (float)na;
+        float d = b.mean - mean_a;
+        m2 -= b.m2 + d * d * (float)na * (float)b.n / (float)n;
+        if (m2 < 0.0f) m2 = 0.0f;
+        mean = mean_a;
+        n = na;
+    }
+
+    float variance() const { return n > 1 ? m2 / (float)(n - 1) : 0.0f; }
+    float stddev() const { return std::sqrt(variance()); }
+};
+
+// Sliding window over the last N aggregates (raw samples are aggregates with n=1).
+// An empty aggregate still takes a slot: it stands for a time step with no
+// data. count/mean/M2 are updated incrementally and min/max come from
+// monotonic deques of ring positions, so push() is O(1) except once per lap,
+// when total_ is rebuilt from the ring (O(N)) to drop the float drift that
+// unmerge() accumulates. Amortised that is still O(1). Nothing counts pushes,
+// so nothing wraps: the entry leaving the window is always the one at head_.
+template <size_t N>
+class SlidingStats {
+public:
+    static_assert(N > 0, "window must not be empty");
+
+    void reset() { *this = SlidingStats{}; }
+
+    void push(const StatAgg& e) {
+        if (count_ == N) {
+            // oldest entry leaves; if it is still a deque front, that's where
+            total_.unmerge(ring_[head_]);
+            if (min_len_ && min_q_[min_head_] == head_) pop_front(min_head_, min_len_);
+            if (max_len_ && max_q_[max_head_] == head_) pop_front(max_head_, max_len_);
+        } else {
+            count_++;
+        }
+        ring_[head_] = e;
+
+        if (e.n) {
+            while (min_len_ && ring_[back(min_q_, min_head_, min_len_)].min >= e.min) min_len_--;
+            min_q_[(min_head_ + min_len_++) % N] = (uint32_t)head_;
+            while (max_len_ && ring_[back(max_q_, max_head_, max_len_)].max <= e.max) max_len_--;
+            max_q_[(max_head_ + max_len_++) % N] = (uint32_t)head_;
+        }
+
+        if (++head_ == N) {
+            head_ = 0;
+            rebuild();
+        } else {
+            total_.merge(e);
+        }
+    }
+
+    void push(float x) { push(StatAgg::of(x)); }
+
+    StatAgg result() const {
+        StatAgg r = total_;
+        if (min_len_ == 0) return r;   // only gaps
+        r.min = ring_[min_q_[min_head_]].min;
+        r.max = ring_[max_q_[max_head_]].max;
+        return r;
+    }
+
+    size_t size() const { return count_; }
+    static constexpr size_t capacity() { return N; }
+
+private:
+    static uint32_t back(const uint32_t* q, size_t h, size_t len) { return q[(h + len - 1) % N]; }
+    static void pop_front(size_t& h, size_t& len) { h = (h + 1) % N; len--; }
+
+    void rebuild() {
+        StatAgg t;
+        for (size_t i = 0; i < count_; i++) t.merge(ring_[i]);
+        total_ = t;
+    }
+
+    StatAgg ring_[N]{};
+    size_t head_ = 0;       // next write position, wraps at N
+    size_t count_ = 0;
+    StatAgg total_{};
+
+    uint32_t min_q_[N]{};   // ring positions of non-empty entries, oldest first
+    uint32_t max_q_[N]{};
+    size_t min_head_ = 0, min_len_ = 0;
+    size_t max_head_ = 0, max_len_ = 0;
+};
+
+enum class StatWindow : uint8_t { Short, Long };
+
+// Two time windows per channel, whatever the producer period: the last
+// SHORT_S seconds (1 s slots) and the last LONG_MIN minutes (1 min slots),
+// each plus the slot still being filled. Seconds without samples are empty
+// slots, so a slow producer doesn't stretch the windows. Time comes from the
+// sample timestamps; if it goes backwards (ms counter wrap) the windows restart.
+template <size_t SHORT_S, size_t LONG_MIN>
+class ChannelStats {
+public:
+    void push(uint32_t t_ms, float x) {
+        const uint32_t s = t_ms / 1000;
+        if (!started_ || s < sec_) {
+            reset();
+            started_ = true;
+            sec_ = s;
+        } else if (s != sec_) {
+            advance(s);
+        }
+        sec_acc_.add(x);
+    }
+
+    StatAgg query(StatWindow w) const {
+        StatAgg r;
+        if (w == StatWindow::Short) {
+            r = short_.result();
+        } else {
+            r = long_.result();
+            r.merge(min_acc_);
+        }
+        r.merge(sec_acc_);
+        return r;
+    }
+
+    void reset() {
+        short_.reset();
+        long_.reset();
+        sec_acc_ = min_acc_ = StatAgg{};
+        started_ = false;
+    }
+
+private:
+    // closes the current second, then one empty slot per second (minute)
+    // skipped; a gap longer than a window just empties it
+    void advance(uint32_t s) {
+        short_.push(sec_acc_);
+        min_acc_.merge(sec_acc_);
+        sec_acc_ = StatAgg{};
+        for (uint32_t k = 1; k < s - sec_ && k <= SHORT_S; k++) short_.push(StatAgg{});
+
+        const uint32_t m0 = sec_ / 60, m1 = s / 60;
+        if (m1 != m0) {
+            long_.push(min_acc_);
+            min_acc_ = StatAgg{};
+            for (uint32_t k = 1; k < m1 - m0 && k <= LONG_MIN; k++) long_.push(StatAgg{});
+        }
+        sec_ = s;
+    }
+
+    SlidingStats<SHORT_S> short_;
+    SlidingStats<LONG_MIN> long_;
+    StatAgg sec_acc_{};     // second in progress
+    StatAgg min_acc_{};     // closed seconds of the minute in progress
+    uint32_t sec_ = 0;
+    bool started_ = false;
+};
+
+// Windowed stats for every sensor channel, fed one batch column at a time
+// (SampleBatch::channel() plus its timestamps), so each channel's windows
+// stay hot while it runs.
+template <size_t SHORT_S = 60, size_t LONG_MIN = 60>
+class StatsEngine {
+public:
+    static constexpr uint32_t SHORT_SECONDS = SHORT_S;
+    static constexpr uint32_t LONG_SECONDS = LONG_MIN * 60;
+
+    void update(SensorChannel c, const uint32_t* t_ms, const float* x, size_t len) {
+        if ((size_t)c >= SENSOR_CH_COUNT) return;
+        for (size_t i = 0; i < len; i++) ch_[(size_t)c].push(t_ms[i], x[i]);
+    }
+
+    StatAgg query(SensorChannel c, StatWindow w) const {
+        if ((size_t)c >= SENSOR_CH_COUNT) return StatAgg{};
+        return ch_[(size_t)c].query(w);
+    }
+
+    void reset() { for (auto& c : ch_) c.reset(); }
+
+private:
+    ChannelStats<SHORT_S, LONG_MIN> ch_[SENSOR_CH_COUNT];
+};
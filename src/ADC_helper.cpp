@@ -1,51 +1,139 @@
 #include "ADC_helper.h"
+#include "adc_frame.h"
+#include "dsp_filter.h"
 
 adc_oneshot_unit_handle_t adc1_handle = nullptr;
 adc_cali_handle_t cali_handle = nullptr;
 bool cali_ok = false;
 
-static void pwm_init(){
+// continuous mode
+static adc_continuous_handle_t adc_cont_handle = nullptr;
+static adc_channel_t stream_channels[ADC_STREAM_MAX_CH];
+static size_t stream_n = 0;
+static TaskHandle_t stream_task = nullptr;
+static volatile uint32_t stream_ovf = 0;
+static volatile int latest_raw = -1;
+
+static esp_err_t pwm_init(){
     ledc_timer_config_t timer = {};
     timer.speed_mode       = LEDC_HIGH_SPEED_MODE;
     timer.timer_num        = LEDC_TIMER_0;
     timer.duty_resolution  = LEDC_TIMER_13_BIT;
     timer.freq_hz          = 5000;
     timer.clk_cfg          = LEDC_AUTO_CLK;
-    ESP_ERROR_CHECK(ledc_timer_config(&timer));
+    esp_err_t err = ledc_timer_config(&timer);
+    if (err != ESP_OK) return err;
 
     ledc_channel_config_t ch = {};
     ch.speed_mode     = LEDC_HIGH_SPEED_MODE;
     ch.channel        = LEDC_CHANNEL_0;
     ch.timer_sel      = LEDC_TIMER_0;
     ch.intr_type      = LEDC_INTR_DISABLE;
-    ch.gpio_num       = GPIO_NUM_2;
+    ch.gpio_num       = ADC_PWM_GPIO;
     ch.duty           = 0;
     ch.hpoint         = 0;
-    ESP_ERROR_CHECK(ledc_channel_config(&ch));
+    return ledc_channel_config(&ch);
 }
 
-void adc_init(){
+esp_err_t adc_init(){
+    esp_err_t err;
+#if ADC_USE_CONTINUOUS
+    const adc_channel_t chans[] = { ADC_CHANNEL_6, ADC_CHANNEL_7 }; // GPIO34, GPIO35
+    err = adc_stream_init(chans, sizeof(chans) / sizeof(chans[0]), ADC_STREAM_SAMPLE_HZ);
+    if (err != ESP_OK) return err;
+#else
     // 1) Create ADC1 unit
     adc_oneshot_unit_init_cfg_t unit_cfg = {};
     unit_cfg.unit_id = ADC_UNIT_1;
-    ESP_ERROR_CHECK(adc_oneshot_new_unit(&unit_cfg, &adc1_handle));
+    err = adc_oneshot_new_unit(&unit_cfg, &adc1_handle);
+    if (err != ESP_OK) return err;
 
     // 2) Configure one channel
     adc_oneshot_chan_cfg_t chan_cfg = {};
     chan_cfg.bitwidth = ADC_BITWIDTH_DEFAULT;       // usually 12-bit
     chan_cfg.atten = ADC_ATTEN_DB_11;               // up to ~3.3V range (approx)
-    ESP_ERROR_CHECK(adc_oneshot_config_channel(adc1_handle, ADC_CHANNEL_6, &chan_cfg));
+    err = adc_oneshot_config_channel(adc1_handle, ADC_CHANNEL_6, &chan_cfg);
+    if (err != ESP_OK) return err;
+#endif
+
+    return pwm_init();
+}
+
+// Runs in ISR context once per filled DMA frame (not per sample)
+static bool IRAM_ATTR adc_conv_done_cb(adc_continuous_handle_t handle, const adc_continuous_evt_data_t* edata, void* user_data){
+    BaseType_t hpw = pdFALSE;
+    if (stream_task) vTaskNotifyGiveFromISR(stream_task, &hpw);
+    return hpw == pdTRUE;
+}
 
-    pwm_init();
+static bool IRAM_ATTR adc_pool_ovf_cb(adc_continuous_handle_t handle, const adc_continuous_evt_data_t* edata, void* user_data){
+    stream_ovf++;
+    return false;
 }
 
-static void pwm_set_percent(int percent){
+esp_err_t adc_stream_init(const adc_channel_t* channels, size_t n, uint32_t sample_hz){
+    if (n == 0 || n > ADC_STREAM_MAX_CH) return ESP_ERR_INVALID_ARG;
+
+    adc_continuous_handle_cfg_t handle_cfg = {};
+    handle_cfg.max_store_buf_size = ADC_STREAM_POOL_SZ;
+    handle_cfg.conv_frame_size = ADC_STREAM_FRAME_SZ;
+    esp_err_t err = adc_continuous_new_handle(&handle_cfg, &adc_cont_handle);
+    if (err != ESP_OK) return err;
+
+    adc_digi_pattern_config_t pattern[ADC_STREAM_MAX_CH] = {};
+    for (size_t i = 0; i < n; i++) {
+        pattern[i].atten = ADC_ATTEN_DB_11;
+        pattern[i].channel = channels[i] & 0x7;
+        pattern[i].unit = ADC_UNIT_1;
+        pattern[i].bit_width = SOC_ADC_DIGI_MAX_BITWIDTH;
+        stream_channels[i] = channels[i];
+    }
+    stream_n = n;
+
+    adc_continuous_config_t dig_cfg = {};
+    dig_cfg.sample_freq_hz = sample_hz;
+    dig_cfg.conv_mode = ADC_CONV_SINGLE_UNIT_1;
+    dig_cfg.format = ADC_DIGI_OUTPUT_FORMAT_TYPE1;
+    dig_cfg.pattern_num = n;
+    dig_cfg.adc_pattern = pattern;
+    err = adc_continuous_config(adc_cont_handle, &dig_cfg);
+    if (err != ESP_OK) return err;
+
+    adc_continuous_evt_cbs_t cbs = {};
+    cbs.on_conv_done = adc_conv_done_cb;
+    cbs.on_pool_ovf = adc_pool_ovf_cb;
+    return adc_continuous_register_event_callbacks(adc_cont_handle, &cbs, nullptr);
+}
+
+esp_err_t adc_stream_start(TaskHandle_t notify){
+    if (!adc_cont_handle) return ESP_ERR_INVALID_STATE;
+    stream_task = notify;
+    return adc_continuous_start(adc_cont_handle);
+}
+
+esp_err_t adc_stream_stop(){
+    if (!adc_cont_handle) return ESP_ERR_INVALID_STATE;
+    esp_err_t err = adc_continuous_stop(adc_cont_handle);
+    stream_task = nullptr;
+    return err;
+}
+
+uint32_t adc_stream_overflows(){
+    return stream_ovf;
+}
+
+int adc_latest_raw(){
+    return latest_raw;
+}
+
+static esp_err_t pwm_set_percent(int percent){
     if (percent < 0) percent = 0;
     if (percent > 100) percent = 100;
 
     uint32_t duty = (uint32_t)((percent * 8191) / 100);
-    ESP_ERROR_CHECK(ledc_set_duty(LEDC_HIGH_SPEED_MODE, LEDC_CHANNEL_0, duty));
-    ESP_ERROR_CHECK(ledc_update_duty(LEDC_HIGH_SPEED_MODE, LEDC_CHANNEL_0));
+    esp_err_t err = ledc_set_duty(LEDC_HIGH_SPEED_MODE, LEDC_CHANNEL_0, duty);
+    if (err != ESP_OK) return err;
+    return ledc_update_duty(LEDC_HIGH_SPEED_MODE, LEDC_CHANNEL_0);
 }
 
 
@@ -56,29 +144,88 @@ static int adc_raw_to_percent(int raw)
     return (raw * 100) / 4095;
 }
 
-void adc_task(){
+#if ADC_USE_CONTINUOUS
+esp_err_t adc_task(const std::atomic<bool>& stop){
+    static uint8_t frame[ADC_STREAM_FRAME_SZ];
+    static uint16_t ch_data[ADC_STREAM_MAX_CH][ADC_STREAM_FRAME_SZ / ADC_FRAME_WORD_BYTES];
+
+    AdcChannelBlock blocks[ADC_STREAM_MAX_CH];
+    for (size_t i = 0; i < stream_n; i++) {
+        blocks[i] = { (uint8_t)stream_channels[i], ch_data[i], ADC_STREAM_FRAME_SZ / ADC_FRAME_WORD_BYTES, 0 };
+    }
+
+    esp_err_t err = adc_stream_start(xTaskGetCurrentTaskHandle());
+    if (err != ESP_OK) return err;
+
+    // 10 kHz per channel -> FIR low-pass + decimate by 16 -> moving average
+    static float fir_coefs[32];
+    static float fblock[ADC_STREAM_FRAME_SZ / ADC_FRAME_WORD_BYTES];
+    static float fdec[ADC_STREAM_FRAME_SZ / ADC_FRAME_WORD_BYTES];
+    FirDecimator fir;
+    MovingAverage avg;
+    fir_lowpass(0.02f, fir_coefs, 32);
+    fir.init(fir_coefs, 32, 16);
+    avg.init(8);
+
+    int prev = -1;
+    uint32_t prev_ovf = 0;
+    while(true){
+        // one wakeup per DMA frame; drain everything the driver has buffered
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(1000));
+        if (stop) return adc_stream_stop();
+
+        while (true) {
+            uint32_t got = 0;
+            err = adc_continuous_read(adc_cont_handle, frame, sizeof(frame), &got, 0);
+            if (err != ESP_OK || got == 0) break; // ESP_ERR_TIMEOUT = pool empty
+
+            for (size_t i = 0; i < stream_n; i++) blocks[i].len = 0;
+            adc_frame_demux(frame, got, blocks, stream_n);
+
+            // processing stage: channel 0 of the pattern drives PWM
+            const AdcChannelBlock& b0 = blocks[0];
+            if (b0.len == 0) continue;
+            for (size_t i = 0; i < b0.len; i++) fblock[i] = (float)b0.data[i];
+
+            size_t n = fir.process(fblock, fdec, b0.len);
+            if (n == 0) continue;
+            avg.process(fdec, fdec, n);
+
+            latest_raw = (int)(fdec[n - 1] + 0.5f);
+            int pct = adc_raw_to_percent(latest_raw);
+            if (pct != prev) {
+                if (pwm_set_percent(pct) != ESP_OK) ESP_LOGW(TAG_ADC, "pwm update failed");
+                prev = pct;
+            }
+        }
+
+        uint32_t ovf = adc_stream_overflows();
+        if (ovf != prev_ovf) {
+            ESP_LOGW(TAG_ADC, "DMA pool overflow x%u", (unsigned)(ovf - prev_ovf));
+            prev_ovf = ovf;
+        }
+    }
+}
+#else
+esp_err_t adc_task(const std::atomic<bool>& stop){
 
     int prev = -1;
     while(true){
+        if (stop) return ESP_OK;
         int raw = 0;
-        ESP_ERROR_CHECK(adc_oneshot_read(adc1_handle, ADC_CHANNEL_6, &raw));
+        esp_err_t err = adc_oneshot_read(adc1_handle, ADC_CHANNEL_6, &raw);
+        if (err != ESP_OK) return err;
 
+        latest_raw = raw;
         int pct = adc_raw_to_percent(raw);
 
         // small deadband so logs don’t spam
         if (pct != prev) {
-            pwm_set_percent(pct);
+            if (pwm_set_percent(pct) != ESP_OK) ESP_LOGW(TAG_ADC, "pwm update failed");
             ESP_LOGI("PWM", "raw=%d -> %d%%", raw, pct);
-            ESP_LOGI("PWM", "test duty 0 then max");
-            ESP_ERROR_CHECK(ledc_set_duty(LEDC_HIGH_SPEED_MODE, LEDC_CHANNEL_0, 0));
-            ESP_ERROR_CHECK(ledc_update_duty(LEDC_HIGH_SPEED_MODE, LEDC_CHANNEL_0));
-            vTaskDelay(pdMS_TO_TICKS(800));
-            ESP_ERROR_CHECK(ledc_set_duty(LEDC_HIGH_SPEED_MODE, LEDC_CHANNEL_0, 8191));
-            ESP_ERROR_CHECK(ledc_update_duty(LEDC_HIGH_SPEED_MODE, LEDC_CHANNEL_0));
-            vTaskDelay(pdMS_TO_TICKS(800));
-            ESP_LOGI("PWM", "End test");
             prev = pct;
         }
         vTaskDelay(pdMS_TO_TICKS(100));
     }
 }
+#endif
@@ -3,6 +3,15 @@
 #include "spi_helper.h"
 #include "ADC_helper.h"
 #include "command_parser.h"
+#include "command_registry.h"
+#include "dsp_filter.h"
+#include "nvs_helper.h"
+#include "line_assembler.h"
+#include "esp_system.h"
+#include "esp_heap_caps.h"
+#include "esp_freertos_hooks.h"
+#include <fcntl.h>
+#include <unistd.h>
 
 static void IRAM_ATTR gpio_isr_handler(void* arg) {
     auto* self = static_cast<App*>(arg);
@@ -18,24 +27,307 @@ static void IRAM_ATTR gpio_isr_handler(void* arg) {
 
 static const char *TAG = "APP";
 
+// Context switches, sampled: on every tick, is this core running another task
+// than at the previous tick? One plain store per core from its own tick ISR.
+// Lower bound, can't see switches between ticks, tops out at configTICK_RATE_HZ.
+static TaskHandle_t s_tick_task[portNUM_PROCESSORS];
+static volatile uint32_t s_tick_switches[portNUM_PROCESSORS];
+
+static void IRAM_ATTR tick_switch_hook(){
+    const int core = xPortGetCoreID();
+    TaskHandle_t cur = xTaskGetCurrentTaskHandle();
+    if (cur != s_tick_task[core]) {
+        s_tick_task[core] = cur;
+        s_tick_switches[core] = s_tick_switches[core] + 1;
+    }
+}
+
+// Allocations after boot, counted by the heap's own hook (CONFIG_HEAP_USE_HOOKS).
+// With APP_STATIC_ALLOC these should stay at zero; 'stats' prints them.
+static volatile bool s_heap_watch = false;
+static volatile uint32_t s_heap_allocs, s_heap_bytes;
+static portMUX_TYPE s_heap_mux = portMUX_INITIALIZER_UNLOCKED;
+
+static void heap_watch_start(){
+    s_heap_allocs = s_heap_bytes = 0;
+    s_heap_watch = true;
+}
+
+#if CONFIG_HEAP_USE_HOOKS
+static constexpr bool HEAP_HOOKS = true;
+
+extern "C" void IRAM_ATTR esp_heap_trace_alloc_hook(void* ptr, size_t size, uint32_t caps){
+    (void)ptr; (void)caps;
+    if (!s_heap_watch) return;
+    portENTER_CRITICAL_SAFE(&s_heap_mux);
+    s_heap_allocs = s_heap_allocs + 1;
+    s_heap_bytes = s_heap_bytes + (uint32_t)size;
+    portEXIT_CRITICAL_SAFE(&s_heap_mux);
+}
+#else
+static constexpr bool HEAP_HOOKS = false;
+#endif
+
+// Log and leave the init step instead of aborting the whole boot
+#define INIT_CHECK(tag, x) do {                                             \
+        esp_err_t err_ = (x);                                               \
+        if (err_ != ESP_OK) {                                               \
+            ESP_LOGE(tag, "%s: %s", #x, esp_err_to_name(err_));             \
+            return false;                                                   \
+        }                                                                   \
+    } while (0)
+
 bool App::start(){
+    // Init graph: I2C/OLED on core 0 and SPI/SD/SPL06 on core 1 run side by
+    // side. Only "core" is required, everything else degrades.
+    const int core  = add_init_step("core",  0, true, INIT_ANY_CORE, &App::init_core);
+    const int adc   = add_init_step("adc",   0, false, INIT_ANY_CORE, &App::init_adc);
+    const int uart  = add_init_step("uart",  0, false, 0, &App::init_uart);     // ISR on the I/O core
+    const int gpio  = add_init_step("gpio",  0, false, INIT_ANY_CORE, &App::init_gpio);
+    const int nvs   = add_init_step("nvs",   0, false, INIT_ANY_CORE, &App::init_nvs);
+    const int i2c   = add_init_step("i2c",   init_.dep(nvs), false, 0, &App::init_i2c);
+    const int oled  = add_init_step("oled",  init_.dep(i2c), false, 0, &App::init_oled);
+    const int spi   = add_init_step("spi",   0, false, 1, &App::init_spi);
+    const int sd    = add_init_step("sd",    init_.dep(spi), false, 1, &App::init_sd);
+    const int spl06 = add_init_step("spl06", init_.dep(spi) | init_.dep(nvs), false, 1, &App::init_spl06);
+    add_init_step("cache", init_.dep(i2c) | init_.dep(spl06), false, INIT_ANY_CORE, &App::init_store_cache);
+
+    run_init_graph();
+
+    ctx_.have_adc   = init_.up(adc);
+    ctx_.have_uart  = init_.up(uart);
+    ctx_.have_gpio  = init_.up(gpio);
+    ctx_.have_i2c   = init_.up(i2c);
+    ctx_.have_oled  = init_.up(oled);
+    ctx_.have_sd    = init_.up(sd);
+    ctx_.have_spl06 = init_.up(spl06);
+    ctx_.have_sht31 = init_.up(i2c) && boot_cache_has_i2c(boot_cache_, 0x44);
+
+    for (size_t i = 0; i < init_.size(); i++) {
+        if (init_.state((int)i) != InitState::Ok) {
+            ESP_LOGW("INIT", "%s %s%s", init_.name((int)i), init_state_name(init_.state((int)i)),
+                     init_.required((int)i) ? "" : ", running degraded");
+        }
+    }
+    if (!init_.up(core)) {
+        ESP_LOGE(TAG, "core init failed");
+        return false;
+    }
+
+    uint8_t saved_layout;
+    if (init_.up(nvs) && nvs_load_u8("layout", &saved_layout) && saved_layout < LAYOUT_COUNT) layout_ = saved_layout;
+    if (layout_ >= LAYOUT_COUNT) layout_ = 1;
+    ESP_LOGI(TAG, "task layout %s", LAYOUTS[layout_].name);
+
+    int step = boot_begin("tasks");
+    for (size_t i = 0; i < TASK_COUNT; i++) {
+        if (!create_task(TASKS[i])) return false;
+    }
+    boot_end(step);
+
+    // first sample now instead of one timer period later
+    xTaskNotifyGive(ctx_.producerHandle);
+
+    boot_log();
+    heap_after_boot_ = esp_get_free_heap_size();
+    heap_watch_start();
+    return true;
+}
+
+// Acquisition = producer, consumer, ADC, health (sensor polls); I/O = SD
+// logger, display, console, button. The acquisition chain runs highest so a
+// slow SD write or OLED flush can only delay I/O, never a sample.
+const App::TaskSpec App::TASKS[] = {
+    //  name        entry                        stack prio group              static handle                        needs
+    { "producer", &App::producer_trampoline, 2048, 6, TaskGroup::Acquire, false, &AppContext::producerHandle, nullptr },
+    { "consumer", &App::consumer_trampoline, 2048, 5, TaskGroup::Acquire, true,  &AppContext::consumerHandle, nullptr },
+    { "ADC",      &App::adc_trampoline,      3072, 4, TaskGroup::Acquire, true,  &AppContext::adcHandle,      &AppContext::have_adc },
+    { "health",   &App::health_trampoline,   2048, 3, TaskGroup::Acquire, true,  &AppContext::healthHandle,   nullptr },
+    { "Button",   &App::button_trampoline,   2048, 4, TaskGroup::Io,      true,  &AppContext::buttonHandle,   &AppContext::have_gpio },
+    { "ui",       &App::ui_trampoline,       3072, 4, TaskGroup::Io,      true,  &AppContext::uiHandle,       nullptr },
+    { "uart",     &App::uart_trampoline,     3072, 3, TaskGroup::Io,      true,  &AppContext::uartHandle,     &AppContext::have_uart },
+    { "logger",   &App::logger_trampoline,   2048, 2, TaskGroup::Io,      true,  &AppContext::loggerHandle,   nullptr },
+    { "render",   &App::render_trampoline,   3072, 2, TaskGroup::Io,      true,  &AppContext::renderHandle,   &AppContext::have_oled },
+};
+const size_t App::TASK_COUNT = sizeof(TASKS) / sizeof(TASKS[0]);
+
+// PRO_CPU (0) also runs the esp_timer task and the UART/I2C ISRs installed
+// there at boot, so the default keeps console and display I/O next to them.
+const App::TaskLayout App::LAYOUTS[] = {
+    { "float",   tskNO_AFFINITY, tskNO_AFFINITY },   // scheduler's choice, the old behaviour
+    { "split",   1,              0 },
+    { "swapped", 0,              1 },
+    { "single",  0,              0 },
+};
+const size_t App::LAYOUT_COUNT = sizeof(LAYOUTS) / sizeof(LAYOUTS[0]);
+
+const App::TaskSpec* App::find_task(const char* name){
+    for (size_t i = 0; i < TASK_COUNT; i++) {
+        if (!strcmp(TASKS[i].name, name)) return &TASKS[i];
+    }
+    return nullptr;
+}
+
+bool App::create_task(const TaskSpec& t){
+    static_assert(sizeof(TASKS) / sizeof(TASKS[0]) <= MAX_TASKS, "raise MAX_TASKS");
+    if (t.needs && !(ctx_.*t.needs)) return true;   // device missing, run without it
+
+    const TaskLayout& l = LAYOUTS[layout_];
+    const BaseType_t core = t.group == TaskGroup::Acquire ? l.acquire_core : l.io_core;
+    const size_t i = (size_t)(&t - TASKS);
+    TaskHandle_t h = nullptr;
+
+    size_t slot = i;
+#if APP_STATIC_ALLOC
+    // Rows the table keeps off the pool are the ones restarted at runtime
+    // (health -> producer). A deleted task's TCB can sit on the kernel's
+    // termination list until idle runs, so restarts alternate with a spare slot.
+    bool use_static = true;
+    if (!t.is_static) {
+        if (spare_owner_ == SIZE_MAX) spare_owner_ = i;
+        if (spare_owner_ != i) {
+            ESP_LOGE(TAG, "%s: only one restartable task has a spare slot", t.name);
+            return false;
+        }
+        if (task_starts_[i]++ & 1) slot = SPARE_SLOT;
+    }
+#else
+    bool use_static = t.is_static;
+#endif
+    if (use_static && !task_stack_[slot]) {
+        if (task_stack_used_ + t.stack > APP_TASK_STACK_POOL) {
+#if APP_STATIC_ALLOC
+            ESP_LOGE(TAG, "%s: stack pool full, raise APP_TASK_STACK_POOL", t.name);
+            return false;
+#else
+            ESP_LOGW(TAG, "%s: stack pool full, allocating from heap", t.name);
+            use_static = false;
+#endif
+        } else {
+            task_stack_[slot] = &task_stack_pool_[task_stack_used_];
+            task_stack_used_ += t.stack;
+        }
+    }
+
+    if (use_static) {
+        h = xTaskCreateStaticPinnedToCore(t.entry, t.name, t.stack, this, t.prio, task_stack_[slot], &task_tcb_[slot], core);
+    } else if (xTaskCreatePinnedToCore(t.entry, t.name, t.stack, this, t.prio, &h, core) != pdPASS) {
+        h = nullptr;
+    }
+
+    if (!h) {
+        ESP_LOGE(TAG, "Failed to create %s task", t.name);
+        return false;
+    }
+    if (t.handle) ctx_.*t.handle = h;
+    return true;
+}
+
+int App::add_init_step(const char* name, uint32_t deps, bool required, int core, InitFn fn){
+    int id = init_.add(name, deps, required, core);
+    if (id >= 0) init_fns_[id] = fn;
+    return id;
+}
+
+void App::init_worker_trampoline(void* pv){
+    static_cast<App*>(pv)->init_worker();
+}
+
+void App::init_worker(){
+    while (true) {
+        // a lone worker takes every step, pinned or not
+        const int core = init_nworkers_ > 1 ? xPortGetCoreID() : INIT_ANY_CORE;
+
+        xSemaphoreTake(init_mutex_, portMAX_DELAY);
+        bool finished = init_.done();
+        int id = finished ? -1 : init_.claim(core);
+        xSemaphoreGive(init_mutex_);
+
+        if (finished) break;
+        if (id < 0) {
+            // nothing runnable on this core yet, wait for the other worker
+            ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(10));
+            continue;
+        }
+
+        int prof = boot_begin(init_.name(id));
+        bool ok = (this->*init_fns_[id])();
+        boot_end(prof, ok);
+
+        // notify under the mutex: the other worker cannot see done() and
+        // delete itself before this is finished
+        xSemaphoreTake(init_mutex_, portMAX_DELAY);
+        init_.finish(id, ok);
+        for (TaskHandle_t w : init_workers_) if (w) xTaskNotifyGive(w);
+        xSemaphoreGive(init_mutex_);
+    }
+
+    xSemaphoreGive(init_done_);
+    vTaskDelete(NULL);
+}
+
+void App::run_init_graph(){
+    init_mutex_ = xSemaphoreCreateMutexStatic(&init_mutex_buf_);
+    init_done_ = xSemaphoreCreateCountingStatic(2, 0, &init_done_buf_);
+
+    // one worker per core, each runs the steps pinned to it plus unpinned ones
+    init_nworkers_ = 2;
+    int running = 0;
+    for (int c = 0; c < 2; c++) {
+        if (xTaskCreatePinnedToCore(&App::init_worker_trampoline, c ? "init1" : "init0", 4096,
+                                    this, 5, &init_workers_[c], c) == pdPASS) {
+            running++;
+        } else {
+            ESP_LOGE(TAG, "init worker %d not created", c);
+            init_workers_[c] = nullptr;
+        }
+    }
+    init_nworkers_ = running;
+
+    // no worker at all: run the graph here, in order
+    if (!running) {
+        for (int id; (id = init_.claim(INIT_ANY_CORE)) >= 0;) {
+            int prof = boot_begin(init_.name(id));
+            bool ok = (this->*init_fns_[id])();
+            boot_end(prof, ok);
+            init_.finish(id, ok);
+        }
+    }
+
+    while (running--) xSemaphoreTake(init_done_, portMAX_DELAY);
+    init_workers_[0] = init_workers_[1] = nullptr;
+
+    vSemaphoreDelete(init_done_);
+    vSemaphoreDelete(init_mutex_);
+    init_done_ = init_mutex_ = nullptr;
+}
+
+bool App::init_core(){
     ctx_.dropped_logs_mux = portMUX_INITIALIZER_UNLOCKED;
-    ctx_.settings.producer_period_ms = 2000;
-    ctx_.settings.sea_level_hpa = 1013.25f;
+    ctx_.latest_mux = portMUX_INITIALIZER_UNLOCKED;
+    ctx_.stats_mux = portMUX_INITIALIZER_UNLOCKED;
+    ctx_.stream_mux = portMUX_INITIALIZER_UNLOCKED;
+    ctx_.settings.store(Settings{ 2000 * 1000, 1013.25f, 5 });
     ctx_.stopRequested = false;
 
-    ctx_.freeQ = xQueueCreate(POOL_N, sizeof(Sample*));
-    ctx_.dataQ = xQueueCreate(POOL_N, sizeof(Sample*));
-    ctx_.logQueue = xQueueCreate(10, sizeof(LogEvent));
-    ctx_.buttonQ = xQueueCreate(10, sizeof(ButtonEvent));
-    ctx_.cmdQ = xQueueCreate(10, sizeof(CommandEvent));
-    ctx_.uiSet = xQueueCreateSet(20);
+    ctx_.freeQ = free_q_.create();
+    ctx_.dataQ = data_q_.create();
+    ctx_.logQueue = log_q_.create();
+    ctx_.buttonQ = button_q_.create();
+    ctx_.cmdQ = cmd_q_.create();
+    ctx_.chartQ = chart_q_.create();
+    ctx_.uiSet = ui_set_.create();
 
     ctx_.sd_buf_len = 0;
     ctx_.sd_policy.flush_period_ms = 2000;
     ctx_.sd_policy.watermark_bytes = ctx_.SD_BUF_SZ - 256;
     ctx_.sd_state.last_flush_ms = (uint32_t)(esp_timer_get_time() / 1000);
 
+    if(ctx_.freeQ == nullptr || ctx_.dataQ == nullptr || ctx_.logQueue == nullptr || ctx_.buttonQ == nullptr || ctx_.cmdQ == nullptr || ctx_.chartQ == nullptr){
+        ESP_LOGE(TAG, "Failed to create Queue");
+        return false;
+    }
+
     if(!ctx_.uiSet){
         ESP_LOGE(TAG, "Failed to create uiSet");
         return false;
@@ -46,41 +338,88 @@ bool App::start(){
         return false;
     }
 
-    //Software timer
-    ctx_.producerTimer = xTimerCreate(
-        "prod_tmr",
-        pdMS_TO_TICKS(ctx_.settings.producer_period_ms),
-        pdTRUE, //auto reload
-        this, //timer ID = App*
-        producer_timer_cb
-    );
+    for(int i = 0; i < POOL_N; i++){
+        SensorBatch* p = &pool_[i];
+        if (xQueueSend(ctx_.freeQ, &p, 0) != pdTRUE){
+            ESP_LOGE("INIT", "Failed to init freeQ queue");
+            return false;
+        }
+    }
+
+    for (int c = 0; c < portNUM_PROCESSORS; c++) {
+        if (esp_register_freertos_tick_hook_for_cpu(tick_switch_hook, c) != ESP_OK)
+            ESP_LOGW("INIT", "no tick hook slot on core %d, switch rate unavailable", c);
+    }
+
+    ctx_.statsMutex = stats_mutex_.create();
+    if (ctx_.statsMutex == NULL){
+        ESP_LOGE("INIT", "Failed to create stats Mutex");
+        return false;
+    }
+
+    ctx_.rollupMutex = rollup_mutex_.create();
+    if (ctx_.rollupMutex == NULL){
+        ESP_LOGE("INIT", "Failed to create rollup Mutex");
+        return false;
+    }
 
-    if(!ctx_.producerTimer){
+    constexpr auto rb = DeviceRollup::budget();
+    ESP_LOGI("ROLLUP", "memory budget raw=%u sec=%u min=%u total=%u bytes",
+             (unsigned)rb.raw, (unsigned)rb.second, (unsigned)rb.minute, (unsigned)rb.total);
+
+    // Sampling clock: periodic esp_timer, alarms at start + k * period in us,
+    // so a late callback never pushes the following ones back
+    esp_timer_create_args_t targs{};
+    targs.callback = producer_timer_cb;
+    targs.arg = this;
+#if PRODUCER_TIMER_ISR
+    targs.dispatch_method = ESP_TIMER_ISR;
+#else
+    targs.dispatch_method = ESP_TIMER_TASK;
+#endif
+    targs.name = "prod_tmr";
+    targs.skip_unhandled_events = false;   // producer counts the ticks it missed
+
+    if(esp_timer_create(&targs, &ctx_.producerTimer) != ESP_OK){
         ESP_LOGE(TAG, "Failed to create producer timer");
         return false;
     }
 
-    if(xTimerStart(ctx_.producerTimer, 0) != pdPASS){
+    const uint32_t period_us = ctx_.settings.load().producer_period_us;
+    ctx_.jitter.restart((uint64_t)esp_timer_get_time(), period_us);   // no tasks yet, no lock
+    if(esp_timer_start_periodic(ctx_.producerTimer, period_us) != ESP_OK){
         ESP_LOGE(TAG, "Failed to start producer timer");
         return false;
     }
+    return true;
+}
 
-    //ADC init
-    adc_init();
+bool App::init_adc(){
+    INIT_CHECK("ADC", adc_init());
+    return true;
+}
 
-    //UART init
+bool App::init_uart(){
     const uart_port_t UART_NUM = UART_NUM_0;
 
     uart_config_t uart_cfg{};
-    uart_cfg.baud_rate = 115200;
+    uart_cfg.baud_rate = CLI_BAUD;
     uart_cfg.data_bits = UART_DATA_8_BITS;
     uart_cfg.parity    = UART_PARITY_DISABLE;
     uart_cfg.stop_bits = UART_STOP_BITS_1;
     uart_cfg.flow_ctrl = UART_HW_FLOWCTRL_DISABLE;
 
-    ESP_ERROR_CHECK(uart_param_config(UART_NUM, &uart_cfg));
-    ESP_ERROR_CHECK(uart_driver_install(UART_NUM, 2048, 0, 0, nullptr, 0));
+    INIT_CHECK("UART", uart_param_config(UART_NUM, &uart_cfg));
+    INIT_CHECK("UART", uart_driver_install(UART_NUM, UART_RX_BUF, UART_TX_BUF, UART_EVQ_LEN, &ctx_.uartEvQ, 0));
+
+    // One UART_PATTERN_DET per '\n' so a finished line wakes the task right away;
+    // partial lines still arrive as UART_DATA on rx timeout / FIFO threshold
+    INIT_CHECK("UART", uart_enable_pattern_det_baud_intr(UART_NUM, '\n', 1, 9, 0, 0));
+    INIT_CHECK("UART", uart_pattern_queue_reset(UART_NUM, UART_EVQ_LEN));
+    return true;
+}
 
+bool App::init_gpio(){
     //button setup
     gpio_config_t io_conf{};
     io_conf.intr_type = GPIO_INTR_NEGEDGE;          // falling edge (press)
@@ -88,7 +427,7 @@ bool App::start(){
     io_conf.pin_bit_mask = 1ULL << GPIO_NUM_4;
     io_conf.pull_up_en = GPIO_PULLUP_ENABLE;
     io_conf.pull_down_en = GPIO_PULLDOWN_DISABLE;
-    ESP_ERROR_CHECK(gpio_config(&io_conf));
+    INIT_CHECK("GPIO", gpio_config(&io_conf));
 
     //LED setup
     gpio_config_t led_conf{};
@@ -97,39 +436,82 @@ bool App::start(){
     led_conf.pin_bit_mask = 1ULL << GPIO_NUM_2;
     led_conf.pull_up_en = GPIO_PULLUP_DISABLE;
     led_conf.pull_down_en = GPIO_PULLDOWN_DISABLE;
-    ESP_ERROR_CHECK(gpio_config(&led_conf));
+    INIT_CHECK("GPIO", gpio_config(&led_conf));
 
     gpio_set_level(GPIO_NUM_2, 0); // start OFF
 
-    //Init I2C
-    ESP_LOGI(TAG, "i2c init");
-    ESP_ERROR_CHECK(i2c_master_init());
-    i2c_scan();
+    //intall and register ISR
+    INIT_CHECK("GPIO", gpio_install_isr_service(0));
+    INIT_CHECK("GPIO", gpio_isr_handler_add(GPIO_NUM_4, gpio_isr_handler, this));
+    return true;
+}
+
+bool App::init_nvs(){
+    // cached device map + calibration from the last good boot; without NVS
+    // the boot just takes the slow path, so this step never fails
+    boot_cache_dirty_ = false;
+    esp_err_t err = nvs_init();
+    if (err != ESP_OK) {
+        ESP_LOGW("NVS", "init failed: %s, no boot cache", esp_err_to_name(err));
+        boot_cache_reset(boot_cache_);
+        return true;
+    }
+    boot_cache_hit_ = APP_FAST_BOOT && boot_cache_load(&boot_cache_);
+    if (!boot_cache_hit_) boot_cache_reset(boot_cache_);
+    return true;
+}
+
+bool App::init_i2c(){
+    INIT_CHECK("I2C", i2c_master_init());
+    i2c_discover(APP_FORCE_I2C_SCAN || !boot_cache_hit_);
+    return true;
+}
 
-    ESP_ERROR_CHECK(ssd1306_init());
-    ESP_ERROR_CHECK(ssd1306_clear());
+bool App::init_oled(){
+    if (!oled().init() || !oled().clear_panel()) {
+        ESP_LOGE("OLED", "init failed");
+        return false;
+    }
     ESP_LOGI("OLED", "init+clear OK");
+    return true;
+}
 
-    //init SPI
+bool App::init_spi(){
     if(!spi_init_once()) return false;
-    force_spi_cs_high();
+    INIT_CHECK("SPI", force_spi_cs_high());
 
-    ESP_ERROR_CHECK(spl06_spi_init());
+    INIT_CHECK("SPL06", spl06_spi_init());
+    return true;
+}
 
-    if(!sd_mount()) return false;
+bool App::init_sd(){
+    // fast clock first, the 1 MHz that always worked as fallback
+    if (sd_mount(SD_FAST_KHZ)) return true;
+    ESP_LOGW("SD", "mount at %u kHz failed, retry at %u kHz", (unsigned)SD_FAST_KHZ, (unsigned)SD_SAFE_KHZ);
+    return sd_mount(SD_SAFE_KHZ);
     // sd_test();
+}
 
+bool App::init_spl06(){
     uint8_t id = 0;
-    ESP_ERROR_CHECK(spl06_read_reg(0x0D, &id));
+    INIT_CHECK("SPL06", spl06_read_reg(0x0D, &id));
     ESP_LOGI("SPL06", "CHIP_ID = 0x%02X", id);
 
+    // same chip as last time: its coefficients are fixed at the factory
     uint8_t calib[18];
-    ESP_ERROR_CHECK(spl06_read_burst(0x10, calib, sizeof(calib)));
+    if (boot_cache_hit_ && boot_cache_.spl06_id == id) {
+        memcpy(calib, boot_cache_.spl06_calib, sizeof(calib));
+        ESP_LOGI("SPL06", "calibration from NVS");
+    } else {
+        INIT_CHECK("SPL06", spl06_read_burst(0x10, calib, sizeof(calib)));
+        boot_cache_set_spl06(boot_cache_, id, calib);
+        boot_cache_dirty_ = true;
+    }
     spl06_parse_calib(calib, &spl_cal);
 
-    ESP_ERROR_CHECK(spl06_write_reg(0x06, 0x03)); // PRS_CFG: low oversampling
-    ESP_ERROR_CHECK(spl06_write_reg(0x07, 0x83)); // TMP_CFG: low oversampling, internal temp
-    ESP_ERROR_CHECK(spl06_write_reg(0x08, 0x07)); // MEAS_CFG: temp+pressure continuous
+    INIT_CHECK("SPL06", spl06_write_reg(0x06, 0x03)); // PRS_CFG: low oversampling
+    INIT_CHECK("SPL06", spl06_write_reg(0x07, 0x83)); // TMP_CFG: low oversampling, internal temp
+    INIT_CHECK("SPL06", spl06_write_reg(0x08, 0x07)); // MEAS_CFG: temp+pressure continuous
     vTaskDelay(pdMS_TO_TICKS(50));
 
     ESP_LOGI("SPL06", "c0=%ld c1=%ld", (long)spl_cal.c0, (long)spl_cal.c1);
@@ -137,118 +519,332 @@ bool App::start(){
     ESP_LOGI("SPL06", "c01=%ld c11=%ld c20=%ld c21=%ld c30=%ld",
             (long)spl_cal.c01, (long)spl_cal.c11, (long)spl_cal.c20,
             (long)spl_cal.c21, (long)spl_cal.c30);
+    return true;
+}
 
-    //intall and register ISR
-    ESP_ERROR_CHECK(gpio_install_isr_service(0));
-    ESP_ERROR_CHECK(gpio_isr_handler_add(GPIO_NUM_4, gpio_isr_handler, this));
-
-    if(ctx_.freeQ == nullptr || ctx_.dataQ == nullptr || ctx_.logQueue == nullptr || ctx_.buttonQ == nullptr || ctx_.cmdQ == nullptr){
-        ESP_LOGE(TAG, "Failed to create Queue");
+bool App::init_store_cache(){
+    if (!boot_cache_dirty_) return true;
+    esp_err_t err = boot_cache_store(boot_cache_);
+    if (err != ESP_OK) {
+        ESP_LOGW("NVS", "boot cache store failed: %s", esp_err_to_name(err));
         return false;
     }
+    return true;
+}
 
-    for(int i = 0; i < POOL_N; i++){
-        Sample* p = &pool_[i];
-        if (xQueueSend(ctx_.freeQ, &p, 0) != pdTRUE){
-            ESP_LOGE("INIT", "Failed to init freeQ queue");
-            return false;
-        }
+int App::boot_begin(const char* name){
+    // init workers on both cores record steps
+    portENTER_CRITICAL(&boot_mux_);
+    int step = boot_.begin(name, (uint32_t)esp_timer_get_time());
+    portEXIT_CRITICAL(&boot_mux_);
+    return step;
+}
+
+void App::boot_end(int step, bool ok){
+    portENTER_CRITICAL(&boot_mux_);
+    boot_.end(step, (uint32_t)esp_timer_get_time(), ok);
+    portEXIT_CRITICAL(&boot_mux_);
+}
+
+void App::boot_log(){
+#if APP_BOOT_PROFILE
+    for (size_t i = 0; i < boot_.size(); i++) {
+        const BootStep& s = boot_[i];
+        ESP_LOGI("BOOT", "%-8s +%6u us %6u us%s", s.name, (unsigned)s.start_us,
+                 (unsigned)s.dur_us, s.ok ? "" : " FAILED");
     }
+    ESP_LOGI("BOOT", "start() %u us (steps %u us serial), fast boot %s",
+             (unsigned)boot_.total_us(), (unsigned)boot_.busy_us(),
+             boot_cache_hit_ ? "hit" : "miss");
+#endif
+}
 
-    ctx_.settingsMutex = xSemaphoreCreateMutex();
-    if (ctx_.settingsMutex == NULL){
-        ESP_LOGE("INIT", "Failed to create settings Mutex");
-        return false;
+void App::handle_i2c_scan(){
+    if (!ctx_.have_i2c) {
+        ESP_LOGW("I2C", "bus not initialised");
+        return;
     }
+    // boot is over, only the UI task touches boot_cache_ now
+    i2c_discover(true);
+    esp_err_t err = boot_cache_store(boot_cache_);
+    ESP_LOGI("I2C", "device map saved (%u devices): %s",
+             (unsigned)boot_cache_.n_i2c, esp_err_to_name(err));
+}
 
-    if (xTaskCreate(&App::uart_trampoline, "uart", 3072, this, 3, &ctx_.uartHandle) != pdPASS) {
-        ESP_LOGE(TAG, "Failed to create uart task"); return false;
+// UART0 switches baud under the host's feet: the ack for this command goes out
+// at the old rate first, the host switches after it has seen the ack
+void App::handle_stream(bool on, uint32_t rate){
+    if (!ctx_.have_uart) return;
+    if (!on && !ctx_.stream.on) return;
+
+    // the uart task queued the command before writing the ack, give it a moment
+    vTaskDelay(pdMS_TO_TICKS(20));
+    uart_wait_tx_done(UART_NUM_0, pdMS_TO_TICKS(100));
+
+    const uint64_t now = (uint64_t)esp_timer_get_time();
+    if (on) {
+        // logs share the wire with the stream, keep warnings and 'status'
+        esp_log_level_set("*", ESP_LOG_WARN);
+        esp_log_level_set("STATUS", ESP_LOG_INFO);
+        uart_set_baudrate(UART_NUM_0, STREAM_BAUD);
+        portENTER_CRITICAL(&ctx_.stream_mux);
+        ctx_.stream.start(rate, STREAM_BURST, now);
+        portEXIT_CRITICAL(&ctx_.stream_mux);
+        return;
     }
 
-    if (xTaskCreate(&App::ui_trampoline, "ui", 2048, this, 4, &ctx_.uiHandle) != pdPASS) {
-        ESP_LOGE(TAG, "Failed to create ui task"); return false;
+    portENTER_CRITICAL(&ctx_.stream_mux);
+    ctx_.stream.stop(now);
+    BinStream st = ctx_.stream;
+    portEXIT_CRITICAL(&ctx_.stream_mux);
+
+    uart_wait_tx_done(UART_NUM_0, pdMS_TO_TICKS(500));
+    uart_set_baudrate(UART_NUM_0, CLI_BAUD);
+    esp_log_level_set("*", ESP_LOG_INFO);
+
+    ESP_LOGI("STREAM", "%u ms at %u baud, limit %u frames/s: frames=%u dropped=%u throttled=%u %u B/s",
+             (unsigned)(st.elapsed_us(now) / 1000), (unsigned)STREAM_BAUD, (unsigned)st.rate,
+             (unsigned)st.frames, (unsigned)st.dropped, (unsigned)st.throttled,
+             (unsigned)st.bytes_per_s(now));
+}
+
+void App::handle_set_layout(uint32_t layout){
+    if (layout >= LAYOUT_COUNT) return;
+    esp_err_t err = nvs_store_u8("layout", (uint8_t)layout);
+    if (err != ESP_OK) {
+        ESP_LOGW("TASKS", "layout not saved: %s", esp_err_to_name(err));
+        return;
     }
+    // pinning is fixed at creation, the new layout takes a restart
+    ESP_LOGI("TASKS", "layout %s saved, restarting", LAYOUTS[layout].name);
+    vTaskDelay(pdMS_TO_TICKS(100));
+    esp_restart();
+}
 
-    if(xTaskCreate(&App::button_trampoline, "Button", 2048, this, 4, &ctx_.buttonHandle) != pdPASS){
-        ESP_LOGE(TAG, "Failed to create button task");
-        return false;
+// Same load for every layout: 50 ms period, fresh latency histogram. Run it,
+// 'layout <n>', run it again, compare.
+void App::handle_bench(uint32_t seconds){
+    if (!bench_end_ms_) bench_prev_period_ = ctx_.settings.load().producer_period_us;
+    handle_set_period(50 * 1000);
+
+    portENTER_CRITICAL(&ctx_.stats_mux);
+    ctx_.latency.reset();
+    portEXIT_CRITICAL(&ctx_.stats_mux);
+
+    bench_end_ms_ = (uint32_t)(esp_timer_get_time() / 1000) + seconds * 1000;
+    if (!bench_end_ms_) bench_end_ms_ = 1;
+    ESP_LOGI("BENCH", "layout %s, %u s at 50 ms", LAYOUTS[layout_].name, (unsigned)seconds);
+}
+
+void App::bench_poll(){
+    const uint32_t now_ms = (uint32_t)(esp_timer_get_time() / 1000);
+    if ((int32_t)(now_ms - bench_end_ms_) < 0) return;
+    bench_end_ms_ = 0;
+
+    portENTER_CRITICAL(&ctx_.stats_mux);
+    LatencyStats l = ctx_.latency;
+    portEXIT_CRITICAL(&ctx_.stats_mux);
+    handle_set_period(bench_prev_period_);
+
+    ESP_LOGI("BENCH", "layout %s: batches=%u latency us min=%u mean=%u p50<=%u p99<=%u max=%u",
+             LAYOUTS[layout_].name, (unsigned)l.count, (unsigned)(l.count ? l.min_us : 0),
+             (unsigned)l.mean_us(), (unsigned)l.percentile_us(50), (unsigned)l.percentile_us(99),
+             (unsigned)l.max_us);
+}
+
+// Filter throughput with whichever kernels this build uses (esp-dsp on
+// target when the component is present). Blocks the ui task for well under
+// a second; the native test_dsp_bench numbers only compare settings.
+void App::handle_dsp_bench(){
+    static constexpr size_t BLOCK = 256;
+    static constexpr size_t TOTAL = 32768;
+    static float in[BLOCK], out[BLOCK], coefs[FirDecimator::MAX_TAPS];
+    for (size_t i = 0; i < BLOCK; i++) in[i] = (float)((i * 37) % 4096);
+
+    auto msps = [](int64_t us) { return us > 0 ? (float)TOTAL / (float)us : 0.0f; };
+    ESP_LOGI("BENCH", "dsp %s, %u-sample blocks", DSP_USE_ESP_DSP ? "esp-dsp" : "portable", (unsigned)BLOCK);
+
+    static const size_t taps[] = { 8, 16, 32, 64 };
+    static const size_t decims[] = { 1, 4 };
+    for (size_t t : taps) {
+        fir_lowpass(0.1f, coefs, t);
+        for (size_t d : decims) {
+            FirDecimator fir;
+            if (!fir.init(coefs, t, d)) continue;
+            const int64_t t0 = esp_timer_get_time();
+            for (size_t done = 0; done < TOTAL; done += BLOCK) fir.process(in, out, BLOCK);
+            const int64_t t1 = esp_timer_get_time();
+            ESP_LOGI("BENCH", "fir taps=%2u decim=%u %6.2f Msps", (unsigned)t, (unsigned)d, msps(t1 - t0));
+        }
     }
 
-    if (xTaskCreate(&App::health_trampoline, "health", 2048, this, 2, &ctx_.healthHandle) != pdPASS){
-        ESP_LOGE(TAG, "Failed to create health task");
-        return false;
+    float bq[BiquadCascade::MAX_SECTIONS][5];
+    for (size_t s = 0; s < BiquadCascade::MAX_SECTIONS; s++) biquad_lowpass(0.05f, 0.707f, bq[s]);
+    for (size_t s = 1; s <= BiquadCascade::MAX_SECTIONS; s++) {
+        BiquadCascade iir;
+        if (!iir.init(bq, s)) continue;
+        const int64_t t0 = esp_timer_get_time();
+        for (size_t done = 0; done < TOTAL; done += BLOCK) iir.process(in, out, BLOCK);
+        const int64_t t1 = esp_timer_get_time();
+        ESP_LOGI("BENCH", "biquad sections=%u %6.2f Msps", (unsigned)s, msps(t1 - t0));
     }
+}
 
-    if (xTaskCreate(&App::logger_trampoline, "logger", 2048, this, 5, &ctx_.loggerHandle) != pdPASS){
-        ESP_LOGE(TAG, "Failed to create logger task");
-        return false;
+// Everything is read from counters the kernel and the tick hook keep anyway;
+// the hot paths don't do anything extra. uxTaskGetSystemState() suspends the
+// scheduler while it copies the task list, which is why this isn't run often.
+void App::handle_stats(){
+#if configUSE_TRACE_FACILITY && configGENERATE_RUN_TIME_STATS
+    static TaskStatus_t ts[STATS_MAX_TASKS];
+    static TaskSample smp[STATS_MAX_TASKS];
+    static uint16_t pm[STATS_MAX_TASKS];
+
+    configRUN_TIME_COUNTER_TYPE total = 0;
+    const UBaseType_t n = uxTaskGetSystemState(ts, STATS_MAX_TASKS, &total);
+    if (n == 0) {
+        ESP_LOGW("STATS", "more than %u tasks, raise STATS_MAX_TASKS", (unsigned)STATS_MAX_TASKS);
+        return;
     }
 
-    if (xTaskCreate(&App::producer_trampoline, "producer", 2048, this, 3, &ctx_.producerHandle) != pdPASS){
-        ESP_LOGE(TAG, "Failed to create producer task");
-        return false;
+    for (UBaseType_t i = 0; i < n; i++) {
+        smp[i].id = ts[i].xTaskNumber;
+        smp[i].name = ts[i].pcTaskName;
+        smp[i].runtime = (uint32_t)ts[i].ulRunTimeCounter;
+        smp[i].stack_free = (uint32_t)ts[i].usStackHighWaterMark * sizeof(StackType_t);
+        smp[i].prio = (uint8_t)ts[i].uxCurrentPriority;
+        smp[i].core = ts[i].xCoreID == tskNO_AFFINITY ? -1 : (int8_t)ts[i].xCoreID;
     }
+    const uint32_t window = task_cpu_.update(smp, n, (uint32_t)total, pm);
 
-    if (xTaskCreate(&App::consumer_trampoline, "consumer", 2048, this, 6, &ctx_.consumerHandle) != pdPASS){
-        ESP_LOGE(TAG, "Failed to create consumer task");
-        return false;
+    if (window == 0) ESP_LOGI("STATS", "first snapshot, cpu%% is since boot next time");
+    else ESP_LOGI("STATS", "window %u ms, cpu%% of one core", (unsigned)(window / 1000));
+
+    ESP_LOGI("STATS", "%-16s core prio  cpu%%  stack_free", "task");
+    for (UBaseType_t i = 0; i < n; i++) {
+        ESP_LOGI("STATS", "%-16s %4d %4u %3u.%u %8u", smp[i].name, (int)smp[i].core, (unsigned)smp[i].prio,
+                 (unsigned)(pm[i] / 10), (unsigned)(pm[i] % 10), (unsigned)smp[i].stack_free);
+    }
+#else
+    ESP_LOGW("STATS", "needs CONFIG_FREERTOS_USE_TRACE_FACILITY + GENERATE_RUN_TIME_STATS");
+#endif
+
+    portENTER_CRITICAL(&ctx_.stats_mux);
+    LatencyStats lat = ctx_.latency;
+    portEXIT_CRITICAL(&ctx_.stats_mux);
+    ESP_LOGI("STATS", "pipeline latency us (layout %s): n=%u mean=%u p99<=%u max=%u", LAYOUTS[layout_].name,
+             (unsigned)lat.count, (unsigned)lat.mean_us(), (unsigned)lat.percentile_us(99), (unsigned)lat.max_us);
+
+    portENTER_CRITICAL(&ctx_.stats_mux);
+    const ClockJitter jit = ctx_.jitter;
+    portEXIT_CRITICAL(&ctx_.stats_mux);
+    ESP_LOGI("STATS", "clock %u us (%s): wakes=%u late mean=%u p99<=%u max=%u us missed=%u",
+             (unsigned)ctx_.settings.load().producer_period_us, PRODUCER_TIMER_ISR ? "isr" : "task",
+             (unsigned)jit.late.count, (unsigned)jit.late.mean_us(), (unsigned)jit.late.percentile_us(99),
+             (unsigned)jit.late.max_us, (unsigned)jit.missed);
+
+    ESP_LOGI("STATS", "heap free=%u min=%u largest=%u",
+             (unsigned)esp_get_free_heap_size(), (unsigned)esp_get_minimum_free_heap_size(),
+             (unsigned)heap_caps_get_largest_free_block(MALLOC_CAP_8BIT));
+
+    portENTER_CRITICAL(&s_heap_mux);
+    const uint32_t allocs = s_heap_allocs, alloc_bytes = s_heap_bytes;
+    portEXIT_CRITICAL(&s_heap_mux);
+    ESP_LOGI("STATS", "since boot (static alloc %s): free %+d B, allocs=%u (%u B)%s",
+             APP_STATIC_ALLOC ? "on" : "off",
+             (int)esp_get_free_heap_size() - (int)heap_after_boot_, (unsigned)allocs, (unsigned)alloc_bytes,
+             HEAP_HOOKS ? "" : " [allocs need CONFIG_HEAP_USE_HOOKS]");
+
+    struct { const char* name; QueueHandle_t q; } queues[] = {
+        { "data", ctx_.dataQ }, { "free", ctx_.freeQ }, { "log", ctx_.logQueue }, { "cmd", ctx_.cmdQ },
+        { "button", ctx_.buttonQ }, { "chart", ctx_.chartQ }, { "uart_ev", ctx_.uartEvQ },
+    };
+    char line[160];
+    int len = 0;
+    for (auto& q : queues) {
+        if (!q.q || len >= (int)sizeof(line)) continue;
+        const unsigned used = (unsigned)uxQueueMessagesWaiting(q.q);
+        len += snprintf(line + len, sizeof(line) - len, " %s=%u/%u", q.name, used,
+                        used + (unsigned)uxQueueSpacesAvailable(q.q));
     }
+    ESP_LOGI("STATS", "queues%s", line);
 
-    // if (xTaskCreate(&App::adc_trampoline, "ADC", 3072, this, 4, NULL) != pdPASS){
-    //     ESP_LOGE(TAG, "Failed to create ADC task");
-    //     return false;
-    // }
+    const uint32_t now_us = (uint32_t)esp_timer_get_time();
+    len = 0;
+    for (int c = 0; c < portNUM_PROCESSORS; c++) {
+        len += snprintf(line + len, sizeof(line) - len, " core%d=%u", c,
+                        (unsigned)switch_rate_[c].per_s(s_tick_switches[c], now_us));
+    }
+    ESP_LOGI("STATS", "ctx switches/s (tick sampled, max %u):%s", (unsigned)configTICK_RATE_HZ, line);
+}
 
-    return true;
+void App::i2c_discover(bool full_scan){
+    bool ok = !full_scan;
+
+    // fast path: only the addresses that answered last time
+    for (int i = 0; ok && i < boot_cache_.n_i2c; i++) {
+        if (!i2c_probe(boot_cache_.i2c_addr[i])) {
+            ESP_LOGW("I2C", "cached device 0x%02X missing, full scan", boot_cache_.i2c_addr[i]);
+            ok = false;
+        }
+    }
+    if (ok) {
+        ESP_LOGI("I2C", "%u cached devices present", (unsigned)boot_cache_.n_i2c);
+        return;
+    }
+
+    uint8_t found[BOOT_CACHE_MAX_I2C];
+    int n = i2c_scan(found, BOOT_CACHE_MAX_I2C);
+    if (n > BOOT_CACHE_MAX_I2C) n = BOOT_CACHE_MAX_I2C;
+
+    boot_cache_.n_i2c = 0;
+    for (int i = 0; i < n; i++) boot_cache_add_i2c(boot_cache_, found[i]);
+    boot_cache_dirty_ = true;
 }
 
 bool App::stop(){
     ctx_.stopRequested = true;
 
-    Sample* poison = nullptr;
+    SensorBatch* poison = nullptr;
     LogEvent logPoison{ LogType::STOP, 0, 0};
     xQueueSend(ctx_.dataQ, &poison, 0); //send poison-pill to break task
     xQueueSend(ctx_.freeQ, &poison, 0);
     xQueueSend(ctx_.logQueue, &logPoison, 0);
 
-    if(ctx_.producerHandle){
-        xTaskNotifyGive(ctx_.producerHandle);
+    // wake the tasks that block without a timeout (ui polls every 200 ms)
+    for (TaskHandle_t h : { ctx_.producerHandle, ctx_.buttonHandle, ctx_.renderHandle }) {
+        if (h) xTaskNotifyGive(h);
+    }
+    if(ctx_.uartEvQ){
+        uart_event_t wake{};
+        wake.type = UART_EVENT_MAX;
+        xQueueSend(ctx_.uartEvQ, &wake, 0);
     }
 
+    // join every task before deleting anything they use: render reads chartQ,
+    // ui takes rollupMutex, uart answers status frames from ctx_
+    auto any_running = [this] {
+        for (size_t i = 0; i < TASK_COUNT; i++) if (ctx_.*TASKS[i].handle) return true;
+        return false;
+    };
     const TickType_t start = xTaskGetTickCount();
-
-    while ((ctx_.producerHandle || ctx_.consumerHandle || ctx_.healthHandle || ctx_.loggerHandle) && (xTaskGetTickCount() - start < pdMS_TO_TICKS(2000)))
+    while (any_running() && (xTaskGetTickCount() - start < pdMS_TO_TICKS(2000)))
     {
         vTaskDelay(pdMS_TO_TICKS(10));
     }
-       
-    if (ctx_.healthHandle) { //still running, force stop
-        ESP_LOGE("APP", "Stop timeout: force-deleting health tasks");
-        // esp_task_wdt_delete(ctx_.healthHandle);
-        vTaskDelete(ctx_.healthHandle);
-        ctx_.healthHandle = nullptr;
-    }
-    if (ctx_.consumerHandle) {
-        ESP_LOGE("APP", "Stop timeout: force-deleting consumer tasks");
-        // esp_task_wdt_delete(ctx_.consumerHandle);
-        vTaskDelete(ctx_.consumerHandle);
-        ctx_.consumerHandle = nullptr;
-    }
-    if (ctx_.producerHandle) {
-        ESP_LOGE("APP", "Stop timeout: force-deleting producer tasks");
-        // esp_task_wdt_delete(ctx_.producerHandle);
-        vTaskDelete(ctx_.producerHandle);
-        ctx_.producerHandle = nullptr;
-        if(ctx_.producerTimer){
-            xTimerStop(ctx_.producerTimer, 0);
-            xTimerDelete(ctx_.producerTimer, 0);
-            ctx_.producerTimer = nullptr;
-        }
+
+    for (size_t i = 0; i < TASK_COUNT; i++) { //still running, force stop
+        TaskHandle_t& h = ctx_.*TASKS[i].handle;
+        if (!h) continue;
+        ESP_LOGE("APP", "Stop timeout: force-deleting %s task", TASKS[i].name);
+        // esp_task_wdt_delete(h);
+        vTaskDelete(h);
+        h = nullptr;
     }
-    if (ctx_.loggerHandle) {
-        ESP_LOGE("APP", "Stop timeout: force-deleting logger tasks");
-        vTaskDelete(ctx_.loggerHandle);
-        ctx_.loggerHandle = nullptr;
+
+    if(ctx_.producerTimer){
+        esp_timer_stop(ctx_.producerTimer);
+        esp_timer_delete(ctx_.producerTimer);
+        ctx_.producerTimer = nullptr;
     }
 
     if(ctx_.freeQ){
@@ -266,9 +862,19 @@ bool App::stop(){
         ctx_.logQueue = nullptr;
     }
 
-    if(ctx_.settingsMutex){
-        vSemaphoreDelete(ctx_.settingsMutex);
-        ctx_.settingsMutex = nullptr;
+    if(ctx_.chartQ){
+        vQueueDelete(ctx_.chartQ);
+        ctx_.chartQ = nullptr;
+    }
+
+    if(ctx_.statsMutex){
+        vSemaphoreDelete(ctx_.statsMutex);
+        ctx_.statsMutex = nullptr;
+    }
+
+    if(ctx_.rollupMutex){
+        vSemaphoreDelete(ctx_.rollupMutex);
+        ctx_.rollupMutex = nullptr;
     }
 
     return true;
@@ -295,7 +901,9 @@ void App::logger(){
                     ESP_LOGI("LOG", "SENT count= %d, t= %u", ev.count, ev.timestamp_ms);
                     break;
                 case LogType::RECEIVED:
-                    ESP_LOGI("LOG", "RECEIVED count= %d, t= %u", ev.count, ev.timestamp_ms);
+                    ESP_LOGI("LOG", "RECEIVED count= %d..%u n=%u batches=%u lat= %u..%u us, t= %u",
+                             ev.count, (unsigned)ev.last_count, (unsigned)ev.samples, (unsigned)ev.batches,
+                             (unsigned)ev.lat_min_us, (unsigned)ev.lat_max_us, (unsigned)ev.timestamp_ms);
                     break;
                 case LogType::DROPPED:
                     ESP_LOGW("LOG", "DROPPED count= %d, t= %u", ev.count, ev.timestamp_ms);
@@ -304,7 +912,7 @@ void App::logger(){
                     ESP_LOGE("LOG", "ERROR while sending sample");
                     break;
                 case LogType::CHANGED:
-                    ESP_LOGE("LOG", "period changed to: %d", ev.count);
+                    ESP_LOGE("LOG", "period changed to: %d us", ev.count);
                     break;
                 default:
                     break;
@@ -312,9 +920,14 @@ void App::logger(){
 
             char line[96];
             // keep it compact
-            snprintf(line, sizeof(line),
-                     "type=%d count=%d t=%u",
-                     (int)ev.type, ev.count, (int)ev.timestamp_ms);
+            if (ev.type == LogType::RECEIVED)
+                snprintf(line, sizeof(line), "type=%d count=%d..%u n=%u lat=%u..%u t=%u",
+                         (int)ev.type, ev.count, (unsigned)ev.last_count, (unsigned)ev.samples,
+                         (unsigned)ev.lat_min_us, (unsigned)ev.lat_max_us, (unsigned)ev.timestamp_ms);
+            else
+                snprintf(line, sizeof(line),
+                         "type=%d count=%d t=%u",
+                         (int)ev.type, ev.count, (int)ev.timestamp_ms);
             sd_log_append(line);
 
             uint32_t now_ms = (uint32_t)(esp_timer_get_time() / 1000);
@@ -339,6 +952,18 @@ void App::health(){
     // ESP_ERROR_CHECK(esp_task_wdt_add(NULL));
     uint32_t prev_hb = 0;
     uint8_t stuck_seconds = 0;
+    uint32_t stats_ticks = 0;
+    uint32_t prev_wakes = 0;
+    uint8_t jitter_flat_seconds = 0;
+
+    MovingAverage press_avg; // 1 Hz pressure, smooth over 8 s
+    press_avg.init(8);
+
+    Settings settings{};
+    uint32_t settings_seen = 0;     // version 0 is never published, first read copies
+
+    // SHT31: trigger at the end of an iteration, collect at the start of the next
+    if (ctx_.have_sht31) sht31_trigger();
 
     while(1){
         if (ctx_.stopRequested) break;
@@ -358,15 +983,60 @@ void App::health(){
                 vTaskDelete(ctx_.producerHandle);
                 ctx_.producerHandle = nullptr;
             }
-            xTaskCreate(&App::producer_trampoline, "producer", 2048, this, 3, &ctx_.producerHandle);
+            create_task(*find_task("producer"));
             stuck_seconds = 0;
         }
 
+        // every producer wake after the first lands in the jitter stats; if the
+        // heartbeat moves and they don't, the clock bookkeeping is broken
+        portENTER_CRITICAL(&ctx_.stats_mux);
+        const uint32_t wakes = ctx_.jitter.late.count;
+        portEXIT_CRITICAL(&ctx_.stats_mux);
+        if (stuck_seconds == 0 && !ctx_.producerPaused && wakes == prev_wakes) {
+            if (++jitter_flat_seconds == 3) ESP_LOGW("HEALTH", "producer running but no clock jitter samples");
+        } else {
+            jitter_flat_seconds = 0;
+        }
+        prev_wakes = wakes;
+
+        // periodic 'stats' into the log, run by the ui task like a typed command
+        if (APP_STATS_PERIOD_S && ++stats_ticks >= APP_STATS_PERIOD_S) {
+            CommandEvent ce{ CommandType::Stats, 0 };
+            xQueueSend(ctx_.cmdQ, &ce, 0);
+            stats_ticks = 0;
+        }
+
+        if (ctx_.have_sht31) {
+            float t, h;
+            esp_err_t e = sht31_poll(&t, &h);
+            if (e == ESP_OK) {
+                set_latest(SensorChannel::TempC, t);
+                set_latest(SensorChannel::Humidity, h);
+                ESP_LOGI("SHT31", "T=%.2f C  RH=%.1f %%", t, h);
+            } else if (e == ESP_ERR_INVALID_CRC){
+                ESP_LOGW("SHT31", "CRC error (noise on I2C?)");
+            } else if (e != ESP_ERR_NOT_FINISHED && e != ESP_ERR_INVALID_STATE) {
+                ESP_LOGW("SHT31", "read failed: %s", esp_err_to_name(e));
+            }
+            if (e != ESP_ERR_NOT_FINISHED) sht31_trigger();
+        }
+
+        // degraded: no barometer, keep the rest of the health loop going
+        if (!ctx_.have_spl06) {
+            vTaskDelay(pdMS_TO_TICKS(1000));
+            continue;
+        }
+
         //SPL06 read
         uint8_t raw[6];
         uint8_t prs_cfg = 0x03;
         uint8_t tmp_cfg = 0x83;
-        ESP_ERROR_CHECK(spl06_read_burst(0x00, raw, 6));
+        esp_err_t err = spl06_read_burst(0x00, raw, 6);
+        if (err != ESP_OK) {
+            ESP_LOGE("SPL06", "read failed: %s, running without barometer", esp_err_to_name(err));
+            ctx_.have_spl06 = false;
+            continue;
+        }
 
         int32_t p_raw = (int32_t)((raw[0] << 16) | (raw[1] << 8) | raw[2]);
         int32_t t_raw = (int32_t)((raw[3] << 16) | (raw[4] << 8) | raw[5]);
@@ -379,13 +1049,18 @@ void App::health(){
         spl06_compensate(p_raw, t_raw, prs_cfg, tmp_cfg, &tc, &pa);
 
         float p_hpa = pa / 100.0f;
+        press_avg.process(&p_hpa, &p_hpa, 1);
 
-        xSemaphoreTake(ctx_.settingsMutex, portMAX_DELAY);
-        float p0 = ctx_.settings.sea_level_hpa;
-        xSemaphoreGive(ctx_.settingsMutex);
+        ctx_.settings.load_if_changed(&settings_seen, &settings);
+        float p0 = settings.sea_level_hpa;
 
         float alt_m = altitude_from_hpa(p_hpa, p0);
 
+        // one chart column per reading; render drains it, drop if it lags
+        xQueueSend(ctx_.chartQ, &p_hpa, 0);
+        set_latest(SensorChannel::PressureHpa, p_hpa);
+        set_latest(SensorChannel::AltitudeM, alt_m);
+
         // ESP_LOGI("SPL06", "T=%.2f C  P=%.2f hPa Alt=%.1f m (P0=%.2f)", tc, p_hpa, alt_m, p0);
         
         // ESP_LOGI("HEALTH", "dropped_logs= %u, stage=%d", v, ctx_.producer_stage);
@@ -406,52 +1081,72 @@ void App::producer_trampoline(void *pv){
 void App::producer(){
     // ESP_ERROR_CHECK(esp_task_wdt_add(NULL)); //null = current task
 
-    Sample *p = nullptr;
+    SensorBatch *p = nullptr; // batch being filled, kept across timer ticks
+    Settings settings{};
+    uint32_t settings_seen = 0;
+    bool clock_synced = false;  // false after boot kick or pause: ticks were dropped
     while (true){
         if (ctx_.stopRequested) break;
 
         if(ctx_.producerPaused){
             vTaskDelay(pdMS_TO_TICKS(50));
+            ulTaskNotifyTake(pdTRUE, 0);    // ticks while paused aren't misses
+            clock_synced = false;
             // ESP_ERROR_CHECK(esp_task_wdt_reset());
             continue;
         }
 
-        ulTaskNotifyTake(pdTRUE, portMAX_DELAY); //waiting for timer ping
+        const uint32_t ticks = ulTaskNotifyTake(pdTRUE, portMAX_DELAY); //waiting for timer ping
+        const int64_t woke_us = esp_timer_get_time();
 
-        if (xQueueReceive(ctx_.freeQ, &p, portMAX_DELAY) != pdTRUE){
-            ESP_LOGE("PRODUCER", "Failed to recive freeQ data");
-            continue;
-        }
-        else if (p == nullptr){
-            break;
+        ctx_.settings.load_if_changed(&settings_seen, &settings);
+        portENTER_CRITICAL(&ctx_.stats_mux);
+        if (!clock_synced) ctx_.jitter.resync();
+        ctx_.jitter.add((uint64_t)woke_us, ticks);
+        portEXIT_CRITICAL(&ctx_.stats_mux);
+        clock_synced = true;
+
+        if (p == nullptr){
+            if (xQueueReceive(ctx_.freeQ, &p, portMAX_DELAY) != pdTRUE){
+                ESP_LOGE("PRODUCER", "Failed to recive freeQ data");
+                p = nullptr;
+                continue;
+            }
+            else if (p == nullptr){
+                break;
+            }
+            p->clear();
         }
 
-        LogEvent ev;
-        p->count = ctx_.producer_heartbeat;
-        p->timestamp_ms = (uint32_t)(esp_timer_get_time() / 1000);
-        ev.count = p->count;
-        ev.timestamp_ms = p->timestamp_ms;
+        SensorRecord rec = get_latest();
+        rec.timestamp_ms = (uint32_t)(woke_us / 1000);
+        p->push(ctx_.producer_heartbeat, rec);
+        ctx_.producer_heartbeat++;
+
+        // slow periods publish every record, fast ones fill the batch
+        if (!p->full() && settings.producer_period_us < BATCH_MAX_AGE_MS * 1000 &&
+            p->age_ms(rec.timestamp_ms) < BATCH_MAX_AGE_MS){
+            continue;
+        }
 
+        // only failures are logged here, the consumer's RECEIVED summary covers the rest
+        const uint32_t first = p->first_count;
+        p->sent_us = (uint32_t)esp_timer_get_time();
         if(xQueueSend(ctx_.dataQ, &p, portMAX_DELAY) != pdTRUE){ //sending data
             xQueueSend(ctx_.freeQ, &p, 0);
-            ev.type = LogType::ERROR;
-        }
-        else{
-            ev.type = LogType::SENT;
-            ctx_.producer_heartbeat++;
+            LogEvent ev{ LogType::ERROR, (int)first, rec.timestamp_ms };
+            if(xQueueSend(ctx_.logQueue, &ev, 0) != pdTRUE){
+                inc_dropped_logs();
+            }
         }
-        if(xQueueSend(ctx_.logQueue, &ev, 0) != pdTRUE){
-            inc_dropped_logs();
-        }   
-
-        //Testing mutex
-        xSemaphoreTake(ctx_.settingsMutex, portMAX_DELAY);
-        uint32_t p = ctx_.settings.producer_period_ms;
-        xSemaphoreGive(ctx_.settingsMutex);
+#if APP_BOOT_PROFILE
+        else if (first == 0) ESP_LOGI("BOOT", "first sample %u ms after reset", (unsigned)rec.timestamp_ms);
+#endif
+        p = nullptr;
 
         // ESP_ERROR_CHECK(esp_task_wdt_reset());
-        // vTaskDelay(pdMS_TO_TICKS(p));
     }
+    if (p) xQueueSend(ctx_.freeQ, &p, 0);
     // esp_task_wdt_delete(NULL);
     ctx_.producerHandle = nullptr;
     vTaskDelete(NULL);
@@ -465,17 +1160,46 @@ void App::consumer_trampoline(void *pv){
 void App::consumer(){
     // ESP_ERROR_CHECK(esp_task_wdt_add(NULL)); //null = current task
 
-    Sample* p = nullptr;
-    while(1){
+    SensorBatch* p = nullptr;
+    bool poisoned = false;
+    while(!poisoned){
         if (ctx_.stopRequested) break;
 
-        LogEvent ev;
-        if(xQueueReceive(ctx_.dataQ, &p, pdMS_TO_TICKS(200)) == pdTRUE){ 
-            if(p == nullptr) break;
-            ev.count = p->count;
-            ev.timestamp_ms = p->timestamp_ms;     
-            ev.type = LogType::RECEIVED;
-            xQueueSend(ctx_.freeQ, &p, 0);
+        if(xQueueReceive(ctx_.dataQ, &p, pdMS_TO_TICKS(200)) != pdTRUE) continue;
+
+        // Drain what is already queued, one log event for all of it. Capped
+        // at the pool size so a producer refilling as fast as we empty can't
+        // keep us in here forever.
+        DrainSummary sum;
+        int taken = 0;
+        do {
+            if(p == nullptr){
+                poisoned = true;
+                break;
+            }
+
+            xSemaphoreTake(ctx_.statsMutex, portMAX_DELAY);
+            for (size_t c = 0; c < SENSOR_CH_COUNT; c++)      // a column at a time
+                ctx_.stats.update((SensorChannel)c, p->timestamp_ms, p->channel((SensorChannel)c), p->len);
+            xSemaphoreGive(ctx_.statsMutex);
+
+            xSemaphoreTake(ctx_.rollupMutex, portMAX_DELAY);
+            for (size_t i = 0; i < p->len; i++) ctx_.rollup.push(p->at(i));
+            xSemaphoreGive(ctx_.rollupMutex);
+
+            if (ctx_.stream.on) stream_batch(*p);
+
+            const uint32_t lat_us = (uint32_t)esp_timer_get_time() - p->sent_us;
+            portENTER_CRITICAL(&ctx_.stats_mux);
+            ctx_.latency.add(lat_us);
+            portEXIT_CRITICAL(&ctx_.stats_mux);
+
+            sum.add(*p, lat_us);
+            xQueueSend(ctx_.freeQ, &p, 0);      // back to the producer before the next one
+        } while (++taken < POOL_N && xQueueReceive(ctx_.dataQ, &p, 0) == pdTRUE);
+
+        if (!sum.empty()) {
+            LogEvent ev = sum.event();
             if(xQueueSend(ctx_.logQueue, &ev, 0) != pdTRUE){
                 inc_dropped_logs();
             }
@@ -488,6 +1212,39 @@ void App::consumer(){
     vTaskDelete(NULL);
 }
 
+// Frames into the UART tx ring, the driver ISR drains it. Never waits: a full
+// ring or the rate limit drops the frame and it is counted instead.
+void App::stream_batch(const SensorBatch& b){
+    static uint8_t wire[BIN_MAX_WIRE];
+    uint8_t payload[BIN_MAX_PAYLOAD];
+    SensorRecord rec[BIN_MAX_STREAM_RECORDS];
+
+    for (size_t off = 0; off < b.len; off += BIN_MAX_STREAM_RECORDS) {
+        const size_t k = b.len - off < BIN_MAX_STREAM_RECORDS ? b.len - off : BIN_MAX_STREAM_RECORDS;
+        const uint64_t now = (uint64_t)esp_timer_get_time();
+
+        portENTER_CRITICAL(&ctx_.stream_mux);
+        const bool go = ctx_.stream.admit(now);
+        const uint8_t seq = ctx_.stream.seq;
+        portEXIT_CRITICAL(&ctx_.stream_mux);
+        if (!go) continue;
+
+        for (size_t i = 0; i < k; i++) rec[i] = b.at(off + i);
+        size_t len = bin_put_stream(b.first_count + (uint32_t)off, rec, k, payload, sizeof(payload));
+        size_t n = bin_encode(BinMsg::Stream, seq, payload, len, wire, sizeof(wire));
+
+        size_t room = 0;
+        uart_get_tx_buffer_free_size(UART_NUM_0, &room);
+        const bool fits = n > 0 && room >= n;
+        if (fits) uart_write_bytes(UART_NUM_0, wire, n);
+
+        portENTER_CRITICAL(&ctx_.stream_mux);
+        if (fits) ctx_.stream.sent(n);
+        else ctx_.stream.drop();
+        portEXIT_CRITICAL(&ctx_.stream_mux);
+    }
+}
+
 void App::button_trampoline(void *pv){
     auto *self = static_cast<App*>(pv);
     self->button();
@@ -541,6 +1298,7 @@ void App::ui_task(){
         if(ctx_.stopRequested) break;
 
         QueueSetMemberHandle_t active = xQueueSelectFromSet(ctx_.uiSet, pdMS_TO_TICKS(200));
+        if (bench_end_ms_) bench_poll();
 
         if(active == nullptr) continue;
 
@@ -550,7 +1308,7 @@ void App::ui_task(){
                 if(ev == ButtonEvent::ShortPress){
                     led = !led;
                     gpio_set_level(GPIO_NUM_2, led);
-                    handle_toggle_period(1000);
+                    handle_set_period(1000 * 1000);
                 }
                 else if(ev == ButtonEvent::LongPress){
                     handle_toggle_pause();
@@ -563,7 +1321,10 @@ void App::ui_task(){
                 switch (ce.type)
                 {
                 case CommandType::SetPeriod:
-                    handle_toggle_period(ce.value);
+                    handle_set_period(ce.value * 1000);
+                    break;
+                case CommandType::SetPeriodUs:
+                    handle_set_period(ce.value);
                     break;
                 case CommandType::PauseToggle:
                     handle_toggle_pause();
@@ -581,34 +1342,151 @@ void App::ui_task(){
                 case CommandType::Status:
                     handle_status();
                     break;
+                case CommandType::SensorStats:
+                    handle_sensor_stats(ce.value);
+                    break;
+                case CommandType::History:
+                    handle_history(ce.value);
+                    break;
+                case CommandType::SetFps:
+                    handle_set_fps(ce.value);
+                    break;
+                case CommandType::I2cScan:
+                    handle_i2c_scan();
+                    break;
+                case CommandType::StreamOn:
+                    handle_stream(true, ce.value);
+                    break;
+                case CommandType::StreamOff:
+                    handle_stream(false, 0);
+                    break;
+                case CommandType::Stats:
+                    handle_stats();
+                    break;
+                case CommandType::SetLayout:
+                    handle_set_layout(ce.value);
+                    break;
+                case CommandType::Bench:
+                    handle_bench(ce.value);
+                    break;
+                case CommandType::DspBench:
+                    handle_dsp_bench();
+                    break;
                 default:
                     break;
                 }
             }
         }
 
-        float t, h;
-        esp_err_t e = sht31_read(&t, &h);
+        request_render();
+    }
+
+    ctx_.uiHandle = nullptr;
+    vTaskDelete(NULL);
+}
+
+void App::render_trampoline(void* pv){
+    static_cast<App*>(pv)->render();
+}
+
+App::DisplaySnapshot App::take_snapshot(){
+    SensorRecord r = get_latest();
+    StatAgg ts = query_stats(SensorChannel::TempC, StatWindow::Short);
+
+    DisplaySnapshot s{};
+    s.temp_dc = (int16_t)lrintf(r.temp_c * 10.0f);
+    s.rh_pct = (int16_t)lrintf(r.rh);
+    s.press_hpa = (int16_t)lrintf(r.press_hpa);
+    s.have_stats = ts.n > 0;
+    if (s.have_stats) {
+        s.tmin_dc = (int16_t)lrintf(ts.min * 10.0f);
+        s.tmean_dc = (int16_t)lrintf(ts.mean * 10.0f);
+        s.tmax_dc = (int16_t)lrintf(ts.max * 10.0f);
+    }
+    s.paused = ctx_.producerPaused;
+    return s;
+}
+
+void App::draw_snapshot(const DisplaySnapshot& s){
+    Ssd1306Display& d = oled();
+    d.clear_pages(0, CHART_PAGE);   // chart pages are drawn incrementally
+
+    // temperature large on pages 0-1, the rest in the 6x8 font
+    char line[32];
+    snprintf(line, sizeof(line), "%.1fC", s.temp_dc / 10.0f);
+    d.draw_text_2x(0, 0, line);
+
+    snprintf(line, sizeof(line), "RH %d%%  %dhPa", s.rh_pct, s.press_hpa);
+    d.draw_text(0, 3, line);
+
+    // temperature min / mean / max over the last minute
+    if (s.have_stats) {
+        snprintf(line, sizeof(line), "lo%.1f av%.1f hi%.1f", s.tmin_dc / 10.0f, s.tmean_dc / 10.0f, s.tmax_dc / 10.0f);
+        d.draw_text(0, 4, line);
+    }
+    if (s.paused) d.fill_rect(124, 0, 4, 4);
+}
+
+void App::request_render(){
+    if (ctx_.renderHandle) xTaskNotifyGive(ctx_.renderHandle);
+}
+
+void App::render(){
+    DisplaySnapshot last{};
+    bool first = true;
+    TickType_t last_frame = xTaskGetTickCount();
 
-        memset(fb, 0, sizeof(fb));
+    // pressure trend, one column per health() reading
+    StripChart chart(0, CHART_PAGE, Ssd1306Display::WIDTH, Ssd1306Display::PAGES - CHART_PAGE);
+    chart.set_autoscale(0.5f);
 
-        char line[32];
-        snprintf(line, sizeof(line), "T:%.1fC H:%.0f%%", t, h);
+    uint32_t bus_epoch = i2c_bus_epoch();
+    Settings settings{};
+    uint32_t settings_seen = 0;
 
-        draw_text(0, 3, line);
-        ssd1306_flush();
+    while (true){
+        if (ctx_.stopRequested) break;
 
-        if (e == ESP_OK) {
-            ESP_LOGI("SHT31", "T=%.2f C  RH=%.1f %%", t, h);
-        } else if (e == ESP_ERR_INVALID_CRC){
-            ESP_LOGW("SHT31", "CRC error (noise on I2C?)");
+        // woken by data changes, 1 s timeout as a safety net
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(1000));
+
+        // frame cap: never closer than 1/fps apart
+        ctx_.settings.load_if_changed(&settings_seen, &settings);
+        uint32_t fps = settings.render_max_fps;
+        TickType_t min_gap = pdMS_TO_TICKS(1000 / (fps ? fps : 1));
+        TickType_t since = xTaskGetTickCount() - last_frame;
+        if (since < min_gap) vTaskDelay(min_gap - since);
+
+        int samples = 0;
+        float v;
+        while (xQueueReceive(ctx_.chartQ, &v, 0) == pdTRUE) {
+            chart.push(oled(), v);
+            samples++;
         }
-         else {
-            ESP_LOGW("SHT31", "read failed: %s", esp_err_to_name(e));
+
+        // bus was reset under the panel: re-init it and resend the whole frame
+        bool reinit = i2c_bus_epoch() != bus_epoch;
+        if (reinit) {
+            bus_epoch = i2c_bus_epoch();
+            oled().init();
+            oled().invalidate();
         }
+
+        // a queued chunk failed on the bus: flush() resends the whole frame
+        const bool resend = oled().stale();
+
+        DisplaySnapshot s = take_snapshot();
+        bool changed = first || s != last;
+        if (!changed && samples == 0 && !reinit && !resend) continue;
+
+        if (changed) draw_snapshot(s);
+        oled().flush();
+        last = s;
+        first = false;
+        last_frame = xTaskGetTickCount();
     }
 
-    ctx_.uiHandle = nullptr;
+    ctx_.renderHandle = nullptr;
     vTaskDelete(NULL);
 }
 
@@ -632,82 +1510,134 @@ static bool starts_with(const char* s, const char* pref){
     return true;
 }
 
-void App::uart(){
-    char buf[64];
-    int len = 0;
+void App::handle_line(char* raw, bool overflow){
+    if (overflow) {
+        ctx_.uart_long_lines++;
+        ESP_LOGW("UART", "line too long (max %d), dropped", UART_LINE_MAX - 1);
+        return;
+    }
 
-    while(true){
-        if(ctx_.stopRequested) break;
+    char* line = trim(raw);
+    CommandEvent ev;
 
-        uint8_t ch;
-        CommandEvent ev;
-        bool ok = true;
-        int n = uart_read_bytes(UART_NUM_0, &ch, 1, pdMS_TO_TICKS(200));
-        
-        //normalize
-        if(n != 1){
-            continue;
+    if (parse_command_line(line, &ev)) {
+        if (xQueueSend(ctx_.cmdQ, &ev, pdMS_TO_TICKS(50)) != pdTRUE) {
+            ESP_LOGW("UART", "cmdQ full, drop");
         }
+    }
+    else if(!strcmp(line, "help")){
+        char help[112];
+        ESP_LOGI("UART", "Commands:");
+        for (const CommandSpec& c : COMMANDS) {
+            command_help_line(c, help, sizeof(help));
+            ESP_LOGI("UART", "  %s", help);
+        }
+        return; // don’t send to cmdQ
+    }
 
-        //enter pressed
-        if(ch == '\r' || ch == '\n'){
-            if(len == 0) continue;
-            const char nl[] = "\r\n";
-            uart_write_bytes(UART_NUM_0, nl, 2);
+    const char prompt[] = "> ";
+    uart_write_bytes(UART_NUM_0, prompt, 2);
+}
 
-            buf[len] = '\0';
-            char* line = trim(buf);
-            len = 0;
+// Requests from host tools end up in the same cmdQ as typed commands
+struct App::BinLink : BinDevice {
+    App& app;
+    explicit BinLink(App& a) : app(a) {}
 
-            if (parse_command_line(line, &ev)) {
-                if (xQueueSend(ctx_.cmdQ, &ev, pdMS_TO_TICKS(50)) != pdTRUE) {
-                    ESP_LOGW("UART", "cmdQ full, drop");
-                }
-            }
-            else if(!strcmp(line, "help")){
-                ESP_LOGI("UART", "Commands:");
-                ESP_LOGI("UART", "  status");
-                ESP_LOGI("UART", "  period <50..10000>");
-                ESP_LOGI("UART", "  pause on|off|toggle");
-                continue; // don’t send to cmdQ
-            }
+    bool submit(const CommandEvent& ev) override {
+        return xQueueSend(app.ctx_.cmdQ, &ev, 0) == pdTRUE;
+    }
 
+    void status(BinStatus* s) override {
+        AppContext& c = app.ctx_;
+        const Settings set = c.settings.load();
+        s->period_ms = set.producer_period_us / 1000;
+        s->fps = (uint8_t)set.render_max_fps;
+
+        s->uptime_ms = (uint32_t)(esp_timer_get_time() / 1000);
+        s->heartbeat = c.producer_heartbeat;
+        s->dropped_logs = app.get_dropped_logs();
+        s->free_heap = esp_get_free_heap_size();
+        s->i2c_errors = c.have_i2c ? i2c_get_counters().errors : 0;
+        s->paused = c.producerPaused;
+        s->devices = (c.have_adc ? BIN_DEV_ADC : 0) | (c.have_i2c ? BIN_DEV_I2C : 0) |
+                     (c.have_oled ? BIN_DEV_OLED : 0) | (c.have_sd ? BIN_DEV_SD : 0) |
+                     (c.have_spl06 ? BIN_DEV_SPL06 : 0) | (c.have_sht31 ? BIN_DEV_SHT31 : 0);
+    }
 
-            const char prompt[] = "> ";
-            uart_write_bytes(UART_NUM_0, prompt, 2);
-            continue;
-        }
+    void latest(SensorRecord* r) override { *r = app.get_latest(); }
+};
 
-        if(len < (int)sizeof(buf) - 1){
-            //write back
-            if (ch == 0x08 || ch == 0x7F) { // backspace keys
-                if (len > 0) {
-                    len--;
-                    // erase last char on terminal: back, space, back
-                    const char bs[] = "\b \b";
-                    uart_write_bytes(UART_NUM_0, bs, 3);
-                }
-                continue;
-            }
+void App::handle_frame(const BinFrame& f){
+    static uint8_t out[BIN_MAX_WIRE];
+    BinLink link(*this);
 
-            if (ch >= 32 && ch <= 126) { // printable ASCII
-                if (len < (int)sizeof(buf) - 1) {
-                    buf[len++] = (char)ch;
-                    uart_write_bytes(UART_NUM_0, (const char*)&ch, 1); // echo
-                } else {
-                    ESP_LOGW("UART", "Line too long");
-                    len = 0;
-                    const char nl[] = "\r\n";
-                    uart_write_bytes(UART_NUM_0, nl, 2);
-                }
+    // one write per frame; a log line printed from another core can still land
+    // inside it, the host drops that frame on the crc and retries
+    size_t n = bin_serve(f, link, out, sizeof(out));
+    if (n) uart_write_bytes(UART_NUM_0, out, n);
+}
+
+// Sleeps on the driver event queue, no polling. Every wakeup drains all buffered
+// bytes in one read, so a pasted script costs one wakeup per rx burst, not per byte.
+void App::uart(){
+    static LineAssembler<UART_LINE_MAX> lines;
+    static FrameDemux demux;      // 0x00 delimited frames vs typed text
+    uint8_t rx[128];
+    uart_event_t e;
+
+    while(true){
+        if (xQueueReceive(ctx_.uartEvQ, &e, portMAX_DELAY) != pdTRUE) continue;
+        if(ctx_.stopRequested) break;
+
+        switch (e.type) {
+        case UART_DATA:
+        case UART_PATTERN_DET: {
+            // pattern positions are not needed, the assembler finds the '\n' itself;
+            // binary frames end in 0x00 and come in as UART_DATA on rx timeout
+            if (e.type == UART_PATTERN_DET) uart_pattern_queue_reset(UART_NUM_0, UART_EVQ_LEN);
+
+            size_t avail = 0;
+            uart_get_buffered_data_len(UART_NUM_0, &avail);
+            while (avail > 0) {
+                int n = uart_read_bytes(UART_NUM_0, rx, avail < sizeof(rx) ? avail : sizeof(rx), 0);
+                if (n <= 0) break;
+                avail -= (size_t)n;
+
+                demux.feed(rx, (size_t)n,
+                    [this](const uint8_t* text, size_t len) {
+                        lines.feed(text, len,
+                            [this](char* line, size_t, bool overflow) {
+                                ctx_.uart_lines++;
+                                handle_line(line, overflow);
+                            },
+                            [](const char* echo, size_t k) {
+                                uart_write_bytes(UART_NUM_0, echo, k);
+                            });
+                    },
+                    [this](const BinFrame& f) {
+                        ctx_.uart_frames++;
+                        handle_frame(f);
+                    });
             }
-        } 
-        else{ //overflow
-            len = 0;
-            ESP_LOGW("UART", "line too long");
+            break;
+        }
+        case UART_FIFO_OVF:
+        case UART_BUFFER_FULL:
+            // bytes are already lost, the half line in the assembler is garbage too
+            ctx_.uart_rx_overflows++;
+            ESP_LOGW("UART", "rx overflow, input flushed");
+            uart_flush_input(UART_NUM_0);
+            xQueueReset(ctx_.uartEvQ);
+            lines.reset();
+            demux.reset();
+            break;
+        default:
+            break;
         }
     }
 
+    ctx_.uartHandle = nullptr;
     vTaskDelete(NULL);
 }
 
@@ -716,7 +1646,13 @@ void App::adc_trampoline(void* pv){
 }
 
 void App::adc(){
-    adc_task();
+    esp_err_t err = adc_task(ctx_.stopRequested);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG_ADC, "stopped: %s, running without ADC", esp_err_to_name(err));
+        ctx_.have_adc = false;
+    }
+    ctx_.adcHandle = nullptr;
+    vTaskDelete(NULL);
 }
 
 bool App::spi_init_once()
@@ -738,19 +1674,21 @@ bool App::spi_init_once()
     return true;
 }
 
-void App::force_spi_cs_high()
+esp_err_t App::force_spi_cs_high()
 {
     gpio_config_t cfg{};
     cfg.mode = GPIO_MODE_OUTPUT;
     cfg.pin_bit_mask = (1ULL << GPIO_NUM_5) | (1ULL << GPIO_NUM_17); // SPL06_CS + SD_CS
     cfg.pull_up_en = GPIO_PULLUP_ENABLE;
-    ESP_ERROR_CHECK(gpio_config(&cfg));
+    esp_err_t err = gpio_config(&cfg);
+    if (err != ESP_OK) return err;
 
     gpio_set_level(GPIO_NUM_5, 1);   // SPL06 deselect
     gpio_set_level(GPIO_NUM_17, 1);  // SD deselect
+    return ESP_OK;
 }
 
-bool App::sd_mount(){
+bool App::sd_mount(uint32_t khz){
 
     esp_vfs_fat_sdmmc_mount_config_t mount_cfg = {
         .format_if_mount_failed = false,
@@ -762,7 +1700,7 @@ bool App::sd_mount(){
 
     sdmmc_host_t host = SDSPI_HOST_DEFAULT();
     host.slot = SPI3_HOST;
-    host.max_freq_khz = 1000;
+    host.max_freq_khz = khz;
 
     sdspi_device_config_t slot_cfg = SDSPI_DEVICE_CONFIG_DEFAULT();
     slot_cfg.host_id = SPI3_HOST;
@@ -805,6 +1743,7 @@ void App::sd_test(){
 }
 
 void App::sd_log_append(const char* line) {
+    if (!ctx_.have_sd) return;  // no card at boot, serial log only
     size_t n = strlen(line);
     if (n==0) return;
 
@@ -824,18 +1763,19 @@ void App::sd_log_flush(){
 
     if (ctx_.sd_buf_len == 0) return;
 
-    FILE* f = fopen("/sdcard/log.txt", "a");
-    if (!f) {
+    // plain fd, no FILE: stdio would malloc a FILE and its buffer every flush.
+    // FatFs file objects are preallocated at mount (max_files).
+    int fd = open("/sdcard/log.txt", O_WRONLY | O_CREAT | O_APPEND, 0644);
+    if (fd < 0) {
         ESP_LOGE("SD", "open write failed");
         ctx_.sd_buf_len = 0;
         return;
     }
 
-    size_t written = fwrite(ctx_.sd_buf, 1, ctx_.sd_buf_len, f);
-
-    int fd = fileno(f);
-    if (fd >= 0) fsync(fd);
-    fclose(f);
+    ssize_t w = write(fd, ctx_.sd_buf, ctx_.sd_buf_len);
+    size_t written = w < 0 ? 0 : (size_t)w;
+    fsync(fd);
+    close(fd);
 
     if (written != ctx_.sd_buf_len) {
         ESP_LOGE("SD", "short write: %u/%u", (unsigned)written, (unsigned)ctx_.sd_buf_len);
@@ -844,13 +1784,44 @@ void App::sd_log_flush(){
     ctx_.sd_buf_len = 0;
 }
 
-void App::producer_timer_cb(TimerHandle_t xTimer){
-    auto *self = static_cast<App*>(pvTimerGetTimerID(xTimer)); //stores this in timer ID
-    if (!self) return;
+// esp_timer ISR (PRODUCER_TIMER_ISR) or esp_timer task: just wake the producer
+void IRAM_ATTR App::producer_timer_cb(void* arg){
+    auto *self = static_cast<App*>(arg);
+    TaskHandle_t h = self->ctx_.producerHandle;
+    if (!h) return;
+
+#if PRODUCER_TIMER_ISR
+    BaseType_t woken = pdFALSE;
+    vTaskNotifyGiveFromISR(h, &woken);
+    if (woken) esp_timer_isr_dispatch_need_yield();
+#else
+    xTaskNotifyGive(h);
+#endif
+}
 
-    if(self->ctx_.producerHandle){
-        xTaskNotifyGive(self->ctx_.producerHandle);
+void App::set_latest(SensorChannel c, float v){
+    portENTER_CRITICAL(&ctx_.latest_mux);
+    switch (c) {
+        case SensorChannel::TempC:       ctx_.latest.temp_c = v; break;
+        case SensorChannel::Humidity:    ctx_.latest.rh = v; break;
+        case SensorChannel::PressureHpa: ctx_.latest.press_hpa = v; break;
+        case SensorChannel::AltitudeM:   ctx_.latest.alt_m = v; break;
+        case SensorChannel::Adc:         ctx_.latest.adc = v; break;
+        default: break;
     }
+    portEXIT_CRITICAL(&ctx_.latest_mux);
+    request_render();
+}
+
+SensorRecord App::get_latest(){
+    // ADC task is a plain function, pull its value here (not displayed, no render request)
+    int raw = adc_latest_raw();
+
+    portENTER_CRITICAL(&ctx_.latest_mux);
+    if (raw >= 0) ctx_.latest.adc = (float)raw;
+    SensorRecord r = ctx_.latest;
+    portEXIT_CRITICAL(&ctx_.latest_mux);
+    return r;
 }
 
 void App::inc_dropped_logs(){
@@ -867,41 +1838,122 @@ uint32_t App::get_dropped_logs() {
 }
 
 void App::handle_status() {
-    uint32_t period;
-    xSemaphoreTake(ctx_.settingsMutex, portMAX_DELAY);
-    period = ctx_.settings.producer_period_ms;
-    xSemaphoreGive(ctx_.settingsMutex);
+    Settings set;
+    uint32_t ver = ctx_.settings.load(&set);
 
-    ESP_LOGI("STATUS", "paused=%d period_ms=%u hb=%u dropped=%u",
-             (int)ctx_.producerPaused, (unsigned)period,
+    ESP_LOGI("STATUS", "paused=%d period_us=%u fps=%u settings_v=%u hb=%u dropped=%u",
+             (int)ctx_.producerPaused.load(), (unsigned)set.producer_period_us,
+             (unsigned)set.render_max_fps, (unsigned)ver,
              (unsigned)ctx_.producer_heartbeat,
              (unsigned)get_dropped_logs());
+    ESP_LOGI("STATUS", "uart lines=%u too_long=%u frames=%u rx_overflows=%u",
+             (unsigned)ctx_.uart_lines, (unsigned)ctx_.uart_long_lines,
+             (unsigned)ctx_.uart_frames, (unsigned)ctx_.uart_rx_overflows);
+    if (ctx_.stream.on) {
+        const uint64_t now = (uint64_t)esp_timer_get_time();
+        portENTER_CRITICAL(&ctx_.stream_mux);
+        BinStream st = ctx_.stream;
+        portEXIT_CRITICAL(&ctx_.stream_mux);
+        ESP_LOGI("STATUS", "stream %u B/s frames=%u dropped=%u throttled=%u",
+                 (unsigned)st.bytes_per_s(now), (unsigned)st.frames,
+                 (unsigned)st.dropped, (unsigned)st.throttled);
+    }
+
+    const Ssd1306Stats& os = oled().stats();
+    ESP_LOGI("STATUS", "oled frames=%u last: bytes=%u tx=%u pages=%u total=%llu",
+             (unsigned)os.frames, (unsigned)os.bytes_last, (unsigned)os.tx_last,
+             (unsigned)os.pages_last, (unsigned long long)os.bytes_total);
+
+    I2cCounters ic = i2c_get_counters();
+    ESP_LOGI("STATUS", "i2c done=%u errors=%u recoveries=%u",
+             (unsigned)ic.done, (unsigned)ic.errors, (unsigned)ic.recoveries);
+    for (int i = 0; i < I2C_DEV_COUNT; i++) {
+        I2cDevStats ds = i2c_get_dev_stats((I2cDev)i);
+        uint32_t n = ds.ok + ds.errors;
+        ESP_LOGI("STATUS", "  %s 0x%02X ok=%u err=%u wait avg/max=%u/%u us xfer avg/max=%u/%u us",
+                 ds.name, ds.addr, (unsigned)ds.ok, (unsigned)ds.errors,
+                 (unsigned)(n ? ds.wait_total_us / n : 0), (unsigned)ds.wait_max_us,
+                 (unsigned)(n ? ds.xfer_total_us / n : 0), (unsigned)ds.xfer_max_us);
+    }
+}
+
+StatAgg App::query_stats(SensorChannel c, StatWindow w) {
+    xSemaphoreTake(ctx_.statsMutex, portMAX_DELAY);
+    StatAgg a = ctx_.stats.query(c, w);
+    xSemaphoreGive(ctx_.statsMutex);
+    return a;
+}
+
+void App::handle_sensor_stats(uint32_t channel) {
+    // time windows, the same span at any producer period
+    const uint32_t short_s = decltype(ctx_.stats)::SHORT_SECONDS;
+    const uint32_t long_s = decltype(ctx_.stats)::LONG_SECONDS;
+
+    for (size_t i = 0; i < SENSOR_CH_COUNT; i++) {
+        if (channel != SENSOR_ALL && channel != i) continue;
+
+        StatAgg s = query_stats((SensorChannel)i, StatWindow::Short);
+        StatAgg l = query_stats((SensorChannel)i, StatWindow::Long);
+        ESP_LOGI("STATS", "%-5s %5us n=%u min=%.2f max=%.2f mean=%.2f sd=%.3f",
+                 SENSOR_CH_NAMES[i], (unsigned)short_s, (unsigned)s.n, s.min, s.max, s.mean, s.stddev());
+        ESP_LOGI("STATS", "%-5s %5us n=%u min=%.2f max=%.2f mean=%.2f sd=%.3f",
+                 SENSOR_CH_NAMES[i], (unsigned)long_s, (unsigned)l.n, l.min, l.max, l.mean, l.stddev());
+    }
+}
+
+void App::handle_history(uint32_t value) {
+    SensorChannel c = (SensorChannel)(value >> 24);
+    uint32_t secs = value & 0xFFFFFF;
+    if ((size_t)c >= SENSOR_CH_COUNT) return;
+
+    uint32_t now_ms = (uint32_t)(esp_timer_get_time() / 1000);
+    xSemaphoreTake(ctx_.rollupMutex, portMAX_DELAY);
+    StatAgg a = ctx_.rollup.query(c, now_ms, secs * 1000);
+    xSemaphoreGive(ctx_.rollupMutex);
+
+    ESP_LOGI("HISTORY", "%s last %us n=%u min=%.2f max=%.2f mean=%.2f",
+             SENSOR_CH_NAMES[(size_t)c], (unsigned)secs, (unsigned)a.n, a.min, a.max, a.mean);
 }
 
-void App::handle_toggle_period(uint32_t ms) {
-    if(ms < 50 || ms > 10000){
-        ESP_LOGW("UI", "period out of range: %u", (unsigned)ms);
+void App::handle_set_period(uint32_t us) {
+    if(us < PERIOD_MIN_US || us > PERIOD_MAX_US){
+        ESP_LOGW("UI", "period out of range: %u us", (unsigned)us);
         return;
     }
 
-    xSemaphoreTake(ctx_.settingsMutex, portMAX_DELAY);
-    ctx_.settings.producer_period_ms = ms;
-    xSemaphoreGive(ctx_.settingsMutex);
+    ctx_.settings.update([us](Settings& st) { st.producer_period_us = us; });
 
-    xTimerChangePeriod(ctx_.producerTimer, pdMS_TO_TICKS(ms), 0);
+    // restart = stop + start, the new schedule is now + k * us
+    const uint64_t start_us = (uint64_t)esp_timer_get_time();
+    if (esp_timer_restart(ctx_.producerTimer, us) != ESP_OK)
+        ESP_LOGE("UI", "producer timer restart failed");
 
-    LogEvent le{LogType::CHANGED, (int)ms, (uint32_t)(esp_timer_get_time() / 1000)};
+    portENTER_CRITICAL(&ctx_.stats_mux);
+    ctx_.jitter.restart(start_us, us);  // 'stats' reports the current period only
+    portEXIT_CRITICAL(&ctx_.stats_mux);
+
+    LogEvent le{LogType::CHANGED, (int)us, (uint32_t)(esp_timer_get_time() / 1000)};
     if(xQueueSend(ctx_.logQueue, &le, 0) != pdTRUE){
         inc_dropped_logs();
     }  
 }
 
+void App::handle_set_fps(uint32_t fps) {
+    if (fps < 1 || fps > 30) {
+        ESP_LOGW("UI", "fps out of range: %u", (unsigned)fps);
+        return;
+    }
+    ctx_.settings.update([fps](Settings& st) { st.render_max_fps = fps; });
+}
+
 void App::handle_toggle_pause() {
-    ctx_.producerPaused = !ctx_.producerPaused;
+    // only the ui task flips it, readers just poll
+    const bool paused = !ctx_.producerPaused.load();
+    ctx_.producerPaused.store(paused);
 
     LogEvent le{};
     le.type = LogType::PAUSED;
-    le.count = ctx_.producerPaused ? 1 : 0;
+    le.count = paused ? 1 : 0;
     le.timestamp_ms = (uint32_t)(esp_timer_get_time() / 1000);
     if(xQueueSend(ctx_.logQueue, &le, 0) != pdTRUE){
         inc_dropped_logs();
@@ -1,75 +1,237 @@
 #include "i2c_helper.h"
-#include <rom/ets_sys.h>
+#include "esp_timer.h"
+
+// The bus manager task is the only code that touches the bus after boot.
+// Everyone else submits requests; sensor requests always go before display
+// chunks, and recovery happens between transfers, never under one.
+static i2c_master_bus_handle_t i2c_bus = nullptr;
+static i2c_master_dev_handle_t i2c_devs[I2C_DEV_COUNT] = {};
+
+enum class I2cOp : uint8_t { Write, Read, Recover };
+
+struct I2cReq {
+    I2cOp op;
+    I2cDev dev;
+    uint16_t len;
+    const uint8_t* tx;
+    uint8_t* rx;
+    int64_t submit_us;
+};
 
-static int i2c_fail_count = 0;
+static StaticQueue_t sensor_q_buf, display_q_buf;
+static uint8_t sensor_q_storage[I2C_SENSOR_QUEUE_DEPTH * sizeof(I2cReq)];
+static uint8_t display_q_storage[I2C_TRANS_QUEUE_DEPTH * sizeof(I2cReq)];
+static QueueHandle_t sensor_q = nullptr;    // high priority
+static QueueHandle_t display_q = nullptr;   // low priority
+
+static constexpr uint32_t I2C_BUS_TASK_STACK = 3072;
+static StaticTask_t bus_task_buf;
+static StackType_t bus_task_stack[I2C_BUS_TASK_STACK];
+static TaskHandle_t bus_task = nullptr;
+
+// Static TX slots, one per queued display transfer. Buffers stay valid until
+// the manager is done with them; it takes display requests in order, so slots
+// are reused FIFO.
+static constexpr size_t I2C_TX_SLOT_SZ = 1 + 128 + 3;   // control byte + one page
+static uint8_t tx_slots[I2C_TRANS_QUEUE_DEPTH][I2C_TX_SLOT_SZ];
+static uint32_t tx_slot_next = 0;
+static StaticSemaphore_t tx_sem_buf;
+static SemaphoreHandle_t tx_sem = nullptr;   // counts free slots
+
+static portMUX_TYPE i2c_stats_mux = portMUX_INITIALIZER_UNLOCKED;
+static I2cCounters i2c_counters = {};
+static I2cDevStats dev_stats[I2C_DEV_COUNT] = {
+    { "sht31", 0x44, 0, 0, 0, 0, 0, 0 },
+    { "oled",  0x3C, 0, 0, 0, 0, 0, 0 },
+};
+static volatile uint32_t bus_epoch = 0;
+static volatile uint32_t oled_fail_epoch = 0;  // display writes that failed or were dropped
+
+// SHT31 single shot state machine, owned by the caller of trigger/poll
+enum class Sht31State : uint8_t { Idle, CmdQueued, ReadQueued };
+static Sht31State sht31_state = Sht31State::Idle;
+static volatile bool sht31_xfer_done = false;
+static volatile bool sht31_xfer_err = false;
+static int64_t sht31_cmd_us = 0;
+static uint8_t sht31_rx[6];
+
+static uint8_t* tx_slot_acquire(TickType_t to){
+    if (xSemaphoreTake(tx_sem, to) != pdTRUE) return nullptr;
+    uint8_t* slot = tx_slots[tx_slot_next % I2C_TRANS_QUEUE_DEPTH];
+    tx_slot_next++;
+    return slot;
+}
 
-esp_err_t i2c_master_init(){
-    i2c_config_t conf{};
-    conf.mode = I2C_MODE_MASTER;
-    conf.sda_io_num = GPIO_NUM_21;
-    conf.scl_io_num = GPIO_NUM_22;
-    conf.sda_pullup_en = GPIO_PULLUP_ENABLE;
-    conf.scl_pullup_en = GPIO_PULLUP_ENABLE;
-    conf.master.clk_speed = 100000;
-
-    ESP_ERROR_CHECK(i2c_param_config(I2C_NUM_0, &conf));
-    return i2c_driver_install(I2C_NUM_0, conf.mode, 0, 0, 0);
+static esp_err_t i2c_submit(const I2cReq& r){
+    I2cReq q = r;
+    q.submit_us = esp_timer_get_time();
+    QueueHandle_t target = q.dev == I2cDev::Oled ? display_q : sensor_q;
+    if (xQueueSend(target, &q, 0) != pdTRUE) return ESP_ERR_TIMEOUT;
+    xTaskNotifyGive(bus_task);
+    return ESP_OK;
 }
 
-void i2c_scan(){
-    ESP_LOGI("I2C", "Scanning....");
-    int found = 0;
+// sht31_poll() and the render task's next flush pick the results up, nobody waits
+static void i2c_complete(const I2cReq& r, bool ok){
+    if (r.dev == I2cDev::Sht31) {
+        sht31_xfer_err = !ok;
+        sht31_xfer_done = true;
+    } else {
+        if (!ok) oled_fail_epoch++;  // the panel's shadow copy is wrong now
+        xSemaphoreGive(tx_sem);    // display transfers own a TX slot
+    }
+}
 
-    for(int addr = 1; addr < 127; addr++){
-        i2c_cmd_handle_t cmd = i2c_cmd_link_create();
-        i2c_master_start(cmd);
-        i2c_master_write_byte(cmd, (addr << 1) | I2C_MASTER_WRITE, true);
-        i2c_master_stop(cmd);
+static void i2c_recover_bus(){
+    // queued display chunks were meant for the old panel state, drop them;
+    // the display owner re-inits and resends on the epoch change
+    I2cReq r;
+    while (xQueueReceive(display_q, &r, 0) == pdTRUE) i2c_complete(r, false);
 
-        esp_err_t err = i2c_master_cmd_begin(I2C_NUM_0, cmd, pdMS_TO_TICKS(20));
-        i2c_cmd_link_delete(cmd);
+    esp_err_t err = i2c_master_bus_reset(i2c_bus);
+    if (err != ESP_OK) {
+        ESP_LOGE("I2C", "bus reset failed: %s", esp_err_to_name(err));
+    }
 
-        if (err == ESP_OK) {
-            ESP_LOGI("I2C", "Found device at 0x%02X", addr);
-            found++;
+    portENTER_CRITICAL(&i2c_stats_mux);
+    i2c_counters.recoveries++;
+    portEXIT_CRITICAL(&i2c_stats_mux);
+    bus_epoch++;
+}
+
+static void i2c_bus_task(void*){
+    int fails = 0;
+    I2cReq r;
+
+    while (true) {
+        // sensor first, then display, else sleep until something is submitted
+        if (xQueueReceive(sensor_q, &r, 0) != pdTRUE &&
+            xQueueReceive(display_q, &r, 0) != pdTRUE) {
+            ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+            continue;
+        }
+
+        if (r.op == I2cOp::Recover) {
+            ESP_LOGW("I2C", "recovery requested");
+            i2c_recover_bus();
+            fails = 0;
+            continue;
+        }
+
+        const int64_t t0 = esp_timer_get_time();
+        i2c_master_dev_handle_t dev = i2c_devs[(int)r.dev];
+        esp_err_t err = r.op == I2cOp::Write
+            ? i2c_master_transmit(dev, r.tx, r.len, 50)
+            : i2c_master_receive(dev, r.rx, r.len, 50);
+        const int64_t t1 = esp_timer_get_time();
+        const bool ok = err == ESP_OK;
+
+        const uint32_t wait_us = (uint32_t)(t0 - r.submit_us);
+        const uint32_t xfer_us = (uint32_t)(t1 - t0);
+        portENTER_CRITICAL(&i2c_stats_mux);
+        I2cDevStats& s = dev_stats[(int)r.dev];
+        if (ok) s.ok++; else s.errors++;
+        if (wait_us > s.wait_max_us) s.wait_max_us = wait_us;
+        if (xfer_us > s.xfer_max_us) s.xfer_max_us = xfer_us;
+        s.wait_total_us += wait_us;
+        s.xfer_total_us += xfer_us;
+        i2c_counters.done++;
+        if (!ok) i2c_counters.errors++;
+        portEXIT_CRITICAL(&i2c_stats_mux);
+
+        i2c_complete(r, ok);
+
+        fails = ok ? 0 : fails + 1;
+        if (fails >= I2C_FAILS_BEFORE_RECOVERY) {
+            ESP_LOGW("I2C", "Too many failures, recovering bus...");
+            i2c_recover_bus();
+            fails = 0;
         }
     }
+}
 
-    ESP_LOGI("I2C", "Scan done, found=%d", found);
+static esp_err_t add_device(I2cDev dev){
+    i2c_device_config_t dev_cfg = {};
+    dev_cfg.dev_addr_length = I2C_ADDR_BIT_LEN_7;
+    dev_cfg.device_address = dev_stats[(int)dev].addr;
+    dev_cfg.scl_speed_hz = I2C_BUS_HZ;
+    return i2c_master_bus_add_device(i2c_bus, &dev_cfg, &i2c_devs[(int)dev]);
 }
 
-static void i2c_recover_bus() {
-    // 1) Stop driver
-    i2c_driver_delete(I2C_NUM_0);
-
-    // 2) Bit-bang SCL to release stuck SDA
-    // Configure SDA/SCL as GPIO open-drain-ish outputs temporarily
-    gpio_set_direction(GPIO_NUM_21, GPIO_MODE_INPUT_OUTPUT_OD);
-    gpio_set_direction(GPIO_NUM_22, GPIO_MODE_INPUT_OUTPUT_OD);
-    gpio_set_pull_mode(GPIO_NUM_21, GPIO_PULLUP_ONLY);
-    gpio_set_pull_mode(GPIO_NUM_22, GPIO_PULLUP_ONLY);
-
-    // Try clocking SCL 9 times (common I2C recovery)
-    for (int i = 0; i < 9; i++) {
-        gpio_set_level(GPIO_NUM_22, 1);
-        ets_delay_us(5);
-        gpio_set_level(GPIO_NUM_22, 0);
-        ets_delay_us(5);
+esp_err_t i2c_master_init(){
+    if (!tx_sem) {
+        tx_sem = xSemaphoreCreateCountingStatic(I2C_TRANS_QUEUE_DEPTH, I2C_TRANS_QUEUE_DEPTH, &tx_sem_buf);
+        sensor_q = xQueueCreateStatic(I2C_SENSOR_QUEUE_DEPTH, sizeof(I2cReq), sensor_q_storage, &sensor_q_buf);
+        display_q = xQueueCreateStatic(I2C_TRANS_QUEUE_DEPTH, sizeof(I2cReq), display_q_storage, &display_q_buf);
     }
 
-    // Generate a STOP condition: SDA low->high while SCL high
-    gpio_set_level(GPIO_NUM_21, 0);
-    ets_delay_us(5);
-    gpio_set_level(GPIO_NUM_22, 1);
-    ets_delay_us(5);
-    gpio_set_level(GPIO_NUM_21, 1);
-    ets_delay_us(5);
+    i2c_master_bus_config_t bus_cfg = {};
+    bus_cfg.i2c_port = I2C_NUM_0;
+    bus_cfg.sda_io_num = GPIO_NUM_21;
+    bus_cfg.scl_io_num = GPIO_NUM_22;
+    bus_cfg.clk_source = I2C_CLK_SRC_DEFAULT;
+    bus_cfg.glitch_ignore_cnt = 7;
+    bus_cfg.trans_queue_depth = 0;  // blocking transfers, the manager task does the queueing
+    bus_cfg.flags.enable_internal_pullup = true;
+
+    esp_err_t err = i2c_new_master_bus(&bus_cfg, &i2c_bus);
+    if (err != ESP_OK) return err;
+
+    err = add_device(I2cDev::Sht31);
+    if (err != ESP_OK) return err;
+    err = add_device(I2cDev::Oled);
+    if (err != ESP_OK) return err;
+
+    // above the sensor and render tasks so a submitted chunk never waits on them
+    bus_task = xTaskCreateStatic(i2c_bus_task, "i2c_bus", I2C_BUS_TASK_STACK, nullptr, 5,
+                                 bus_task_stack, &bus_task_buf);
+    return bus_task ? ESP_OK : ESP_FAIL;
+}
+
+I2cCounters i2c_get_counters(){
+    portENTER_CRITICAL(&i2c_stats_mux);
+    I2cCounters c = i2c_counters;
+    portEXIT_CRITICAL(&i2c_stats_mux);
+    return c;
+}
+
+I2cDevStats i2c_get_dev_stats(I2cDev dev){
+    portENTER_CRITICAL(&i2c_stats_mux);
+    I2cDevStats s = dev_stats[(int)dev];
+    portEXIT_CRITICAL(&i2c_stats_mux);
+    return s;
+}
+
+void i2c_request_recovery(){
+    I2cReq r = {};
+    r.op = I2cOp::Recover;
+    r.dev = I2cDev::Sht31;  // sensor queue, runs before pending display chunks
+    i2c_submit(r);
+}
 
-    // 3) Re-init I2C peripheral
-    ESP_ERROR_CHECK(i2c_master_init());
+uint32_t i2c_bus_epoch(){
+    return bus_epoch;
+}
 
-    // Optional: re-init OLED after recovery (safe)
-    ssd1306_init();
+bool i2c_probe(uint8_t addr){
+    // the driver's bus lock serialises this against the manager's transfers
+    return i2c_master_probe(i2c_bus, addr, 20) == ESP_OK;
+}
+
+int i2c_scan(uint8_t* found, int max){
+    ESP_LOGI("I2C", "Scanning....");
+    int n = 0;
+
+    for(int addr = 1; addr < 127; addr++){
+        if (i2c_probe((uint8_t)addr)) {
+            ESP_LOGI("I2C", "Found device at 0x%02X", addr);
+            if (n < max) found[n] = (uint8_t)addr;
+            n++;
+        }
+    }
+
+    ESP_LOGI("I2C", "Scan done, found=%d", n);
+    return n;
 }
 
 static uint8_t sht31_crc8(const uint8_t * data, int len){
@@ -83,49 +245,63 @@ static uint8_t sht31_crc8(const uint8_t * data, int len){
     return crc;
 }
 
-esp_err_t sht31_read(float *temp_c, float *rh) {
-    const uint8_t addr = 0x44;
+esp_err_t sht31_trigger() {
     // Single shot, high repeatability, clock stretching disabled:
-    const uint8_t cmd[2] = { 0x24, 0x00 };
+    static const uint8_t cmd[2] = { 0x24, 0x00 };
+
+    if (sht31_state != Sht31State::Idle) return ESP_ERR_INVALID_STATE;
+
+    sht31_xfer_done = false;
+    I2cReq r = {};
+    r.op = I2cOp::Write;
+    r.dev = I2cDev::Sht31;
+    r.tx = cmd;
+    r.len = sizeof(cmd);
+    esp_err_t err = i2c_submit(r);
+    if (err != ESP_OK) return err;
+    sht31_cmd_us = esp_timer_get_time();
+    sht31_state = Sht31State::CmdQueued;
+    return ESP_OK;
+}
 
-    if (i2c_fail_count >= 3){
-        ESP_LOGW("I2C", "Too many failures, recovering bus...");
-        i2c_recover_bus();
-        i2c_fail_count = 0;
-    }
+esp_err_t sht31_poll(float *temp_c, float *rh) {
+    switch (sht31_state) {
+    case Sht31State::Idle:
+        return ESP_ERR_INVALID_STATE;
 
-    // Write command
-    i2c_cmd_handle_t w = i2c_cmd_link_create();
-    i2c_master_start(w);
-    i2c_master_write_byte(w, (addr << 1) | I2C_MASTER_WRITE, true);
-    i2c_master_write(w, cmd, sizeof(cmd), true);
-    i2c_master_stop(w);
-    esp_err_t err = i2c_master_cmd_begin(I2C_NUM_0, w, pdMS_TO_TICKS(50));
-    i2c_cmd_link_delete(w);
-    if (err != ESP_OK){
-        i2c_fail_count++;       
-        return err;
+    case Sht31State::CmdQueued: {
+        if (!sht31_xfer_done) return ESP_ERR_NOT_FINISHED;
+        if (sht31_xfer_err) {
+            sht31_state = Sht31State::Idle;
+            return ESP_FAIL;
+        }
+        // measurement time (high repeatability ~15 ms)
+        if (esp_timer_get_time() - sht31_cmd_us < 20000) return ESP_ERR_NOT_FINISHED;
+
+        // Read 6 bytes: T(msb,lsb,crc) RH(msb,lsb,crc)
+        sht31_xfer_done = false;
+        I2cReq r = {};
+        r.op = I2cOp::Read;
+        r.dev = I2cDev::Sht31;
+        r.rx = sht31_rx;
+        r.len = sizeof(sht31_rx);
+        esp_err_t err = i2c_submit(r);
+        if (err != ESP_OK) {
+            sht31_state = Sht31State::Idle;
+            return err;
+        }
+        sht31_state = Sht31State::ReadQueued;
+        return ESP_ERR_NOT_FINISHED;
     }
 
-    vTaskDelay(pdMS_TO_TICKS(20)); // measurement time
-
-    // Read 6 bytes: T(msb,lsb,crc) RH(msb,lsb,crc)
-    uint8_t data[6] = {0};
-
-    i2c_cmd_handle_t r = i2c_cmd_link_create();
-    i2c_master_start(r);
-    i2c_master_write_byte(r, (addr << 1) | I2C_MASTER_READ, true);
-    i2c_master_read(r, data, 6, I2C_MASTER_LAST_NACK);
-    i2c_master_stop(r);
-    err = i2c_master_cmd_begin(I2C_NUM_0, r, pdMS_TO_TICKS(50));
-    i2c_cmd_link_delete(r);
-
-    if (err != ESP_OK){
-        i2c_fail_count++;
-        return err;
+    case Sht31State::ReadQueued:
+        if (!sht31_xfer_done) return ESP_ERR_NOT_FINISHED;
+        sht31_state = Sht31State::Idle;
+        if (sht31_xfer_err) return ESP_FAIL;
+        break;
     }
-    i2c_fail_count = 0;
 
+    const uint8_t* data = sht31_rx;
     uint8_t crcT = sht31_crc8(&data[0], 2); //CRC check
     uint8_t crcH = sht31_crc8(&data[3], 2);
 
@@ -133,7 +309,7 @@ esp_err_t sht31_read(float *temp_c, float *rh) {
         return ESP_ERR_INVALID_CRC;
     }
 
-    // Convert raw values (ignore CRC for now)
+    // Convert raw values
     uint16_t rawT = (uint16_t(data[0]) << 8) | data[1];
     uint16_t rawH = (uint16_t(data[3]) << 8) | data[4];
 
@@ -143,150 +319,48 @@ esp_err_t sht31_read(float *temp_c, float *rh) {
     return ESP_OK;
 }
 
-esp_err_t ssd1306_cmd(uint8_t addr, const uint8_t *cmds, size_t n) {
-    // control byte 0x00 = commands
-    uint8_t buf[32];
-    if (n + 1 > sizeof(buf)) return ESP_ERR_INVALID_SIZE;
-
-    buf[0] = 0x00;
-    for (size_t i = 0; i < n; i++) buf[i + 1] = cmds[i];
-
-    i2c_cmd_handle_t c = i2c_cmd_link_create();
-    i2c_master_start(c);
-    i2c_master_write_byte(c, (addr << 1) | I2C_MASTER_WRITE, true);
-    i2c_master_write(c, buf, n + 1, true);
-    i2c_master_stop(c);
-    esp_err_t err = i2c_master_cmd_begin(I2C_NUM_0, c, pdMS_TO_TICKS(50));
-    i2c_cmd_link_delete(c);
-    return err;
-}
+static esp_err_t ssd1306_queue(uint8_t control, const uint8_t *bytes, size_t n) {
+    if (n + 1 > I2C_TX_SLOT_SZ) return ESP_ERR_INVALID_SIZE;
 
-esp_err_t ssd1306_data(uint8_t addr, const uint8_t *data, size_t n) {
-    // control byte 0x40 = data
-    i2c_cmd_handle_t c = i2c_cmd_link_create();
-    i2c_master_start(c);
-    i2c_master_write_byte(c, (addr << 1) | I2C_MASTER_WRITE, true);
-    uint8_t control = 0x40;
-    i2c_master_write(c, &control, 1, true);
-    i2c_master_write(c, data, n, true);
-    i2c_master_stop(c);
-    esp_err_t err = i2c_master_cmd_begin(I2C_NUM_0, c, pdMS_TO_TICKS(100));
-    i2c_cmd_link_delete(c);
-    return err;
-}
+    uint8_t* slot = tx_slot_acquire(pdMS_TO_TICKS(100));
+    if (!slot) return ESP_ERR_TIMEOUT;
 
-esp_err_t ssd1306_init() {
-    const uint8_t addr = 0x3C;
-    const uint8_t init[] = {
-        0xAE,       // display off
-        0xD5, 0x80, // clock
-        0xA8, 0x3F, // multiplex 1/64
-        0xD3, 0x00, // offset
-        0x40,       // start line
-        0x8D, 0x14, // charge pump
-        0x20, 0x00, // memory mode = horizontal
-        0xA1,       // segment remap
-        0xC8,       // COM scan dec
-        0xDA, 0x12, // COM pins
-        0x81, 0x7F, // contrast
-        0xD9, 0xF1, // precharge
-        0xDB, 0x40, // vcomh
-        0xA4,       // resume RAM
-        0xA6,       // normal display
-        0xAF        // display on
-    };
-    return ssd1306_cmd(addr, init, sizeof(init));
-}
+    slot[0] = control;
+    memcpy(&slot[1], bytes, n);
 
-esp_err_t ssd1306_clear() {
-    const uint8_t addr = 0x3C;
-    uint8_t set_addr[] = {
-        0x21, 0x00, 0x7F, // col 0..127
-        0x22, 0x00, 0x07  // page 0..7
-    };
-    ESP_ERROR_CHECK(ssd1306_cmd(addr, set_addr, sizeof(set_addr)));
-
-    static uint8_t oled_zero[128]; // one page row
-    memset(oled_zero, 0, sizeof(oled_zero));
-
-    // 8 pages * 128 bytes
-    for (int page = 0; page < 8; page++) {
-        esp_err_t e = ssd1306_data(addr, oled_zero, sizeof(oled_zero));
-        if (e != ESP_OK) return e;
-    }
-    return ESP_OK;
+    I2cReq r = {};
+    r.op = I2cOp::Write;
+    r.dev = I2cDev::Oled;
+    r.tx = slot;
+    r.len = (uint16_t)(n + 1);
+    esp_err_t err = i2c_submit(r);
+    if (err != ESP_OK) xSemaphoreGive(tx_sem); // not queued, slot is free again
+    return err;
 }
 
-esp_err_t ssd1306_flush() {
-    const uint8_t addr = 0x3C;
-    uint8_t set_addr[] = { 0x21, 0x00, 0x7F, 0x22, 0x00, 0x07 };
-    ESP_ERROR_CHECK(ssd1306_cmd(addr, set_addr, sizeof(set_addr)));
-
-    // Send in chunks of 16..32 bytes is safer on I2C; we'll do 16
-    for (int i = 0; i < (int)sizeof(fb); i += 16) {
-        esp_err_t e = ssd1306_data(addr, &fb[i], 16);
-        if (e != ESP_OK) return e;
-    }
-    return ESP_OK;
+esp_err_t ssd1306_cmd(uint8_t addr, const uint8_t *cmds, size_t n) {
+    // control byte 0x00 = commands
+    (void)addr; // one panel, address lives in its device handle
+    return ssd1306_queue(0x00, cmds, n);
 }
 
-static const uint8_t font5x7[][5] = {
-    // ' ' (space)
-    {0x00,0x00,0x00,0x00,0x00},
-    // '%' (we'll use a simple pattern)
-    {0x62,0x64,0x08,0x13,0x23},
-    // '.' 
-    {0x00,0x00,0x60,0x60,0x00},
-    // ':' 
-    {0x00,0x36,0x36,0x00,0x00},
-    // '0'..'9'
-    {0x3E,0x51,0x49,0x45,0x3E}, // 0
-    {0x00,0x42,0x7F,0x40,0x00}, // 1
-    {0x42,0x61,0x51,0x49,0x46}, // 2
-    {0x21,0x41,0x45,0x4B,0x31}, // 3
-    {0x18,0x14,0x12,0x7F,0x10}, // 4
-    {0x27,0x45,0x45,0x45,0x39}, // 5
-    {0x3C,0x4A,0x49,0x49,0x30}, // 6
-    {0x01,0x71,0x09,0x05,0x03}, // 7
-    {0x36,0x49,0x49,0x49,0x36}, // 8
-    {0x06,0x49,0x49,0x29,0x1E}, // 9
-    // 'C'
-    {0x3E,0x41,0x41,0x41,0x22},
-    // 'H'
-    {0x7F,0x08,0x08,0x08,0x7F},
-    // 'T'
-    {0x01,0x01,0x7F,0x01,0x01},
-};
-
-static const uint8_t* glyph(char ch) {
-    if (ch == ' ') return font5x7[0];
-    if (ch == '%') return font5x7[1];
-    if (ch == '.') return font5x7[2];
-    if (ch == ':') return font5x7[3];
-    if (ch >= '0' && ch <= '9') return font5x7[4 + (ch - '0')];
-    if (ch == 'C') return font5x7[14];
-    if (ch == 'H') return font5x7[15];
-    if (ch == 'T') return font5x7[16];
-    return font5x7[0];
+esp_err_t ssd1306_data(uint8_t addr, const uint8_t *data, size_t n) {
+    // control byte 0x40 = data
+    (void)addr;
+    return ssd1306_queue(0x40, data, n);
 }
 
-static void draw_char(int x, int page, char ch) {
-    if (page < 0 || page > 7) return;
-    if (x < 0 || x > 127) return;
-
-    const uint8_t* g = glyph(ch);
-    int base = page * 128 + x;
-
-    for (int i = 0; i < 5; i++) {
-        if (x + i < 128) fb[base + i] = g[i];
+// Display writes go through the static slots above
+class I2cOledTransport : public Ssd1306Transport {
+public:
+    bool write(uint8_t control, const uint8_t* bytes, size_t n) override {
+        return ssd1306_queue(control, bytes, n) == ESP_OK;
     }
-    // 1 column spacing
-    if (x + 5 < 128) fb[base + 5] = 0x00;
-}
+    uint32_t fail_epoch() const override { return oled_fail_epoch; }
+};
 
-void draw_text(int x, int page, const char* s) {
-    while (*s && x < 128) {
-        draw_char(x, page, *s++);
-        x += 6;
-    }
+Ssd1306Display& oled() {
+    static I2cOledTransport transport;
+    static Ssd1306Display display(transport);
+    return display;
 }
@@ -10,7 +10,9 @@ extern "C" void app_main(void) {
     //     .trigger_panic = false //reset on timeout
     // };
 
+#if !APP_FAST_BOOT
     vTaskDelay(pdMS_TO_TICKS(1000));
+#endif
     ESP_LOGI("BOOT", "Hello, serial OK");
 
     static App app;
@@ -0,0 +1,68 @@
+#include "nvs_helper.h"
+#include "nvs_flash.h"
+#include "nvs.h"
+#include "esp_log.h"
+
+static const char* NVS_NS = "boot";
+static const char* NVS_KEY_CACHE = "cache";
+static const char* NVS_NS_APP = "app";
+
+esp_err_t nvs_init(){
+    esp_err_t err = nvs_flash_init();
+    if (err == ESP_ERR_NVS_NO_FREE_PAGES || err == ESP_ERR_NVS_NEW_VERSION_FOUND) {
+        ESP_LOGW("NVS", "erasing partition: %s", esp_err_to_name(err));
+        err = nvs_flash_erase();
+        if (err != ESP_OK) return err;
+        err = nvs_flash_init();
+    }
+    return err;
+}
+
+bool boot_cache_load(BootCache* out){
+    nvs_handle_t h;
+    if (nvs_open(NVS_NS, NVS_READONLY, &h) != ESP_OK) return false;
+
+    size_t len = sizeof(*out);
+    esp_err_t err = nvs_get_blob(h, NVS_KEY_CACHE, out, &len);
+    nvs_close(h);
+
+    if (err != ESP_OK || len != sizeof(*out)) return false;
+    if (!boot_cache_valid(*out)) {
+        ESP_LOGW("NVS", "boot cache corrupt, ignoring");
+        return false;
+    }
+    return true;
+}
+
+esp_err_t boot_cache_store(const BootCache& c){
+    BootCache sealed = c;
+    boot_cache_seal(sealed);
+
+    nvs_handle_t h;
+    esp_err_t err = nvs_open(NVS_NS, NVS_READWRITE, &h);
+    if (err != ESP_OK) return err;
+
+    err = nvs_set_blob(h, NVS_KEY_CACHE, &sealed, sizeof(sealed));
+    if (err == ESP_OK) err = nvs_commit(h);
+    nvs_close(h);
+    return err;
+}
+
+bool nvs_load_u8(const char* key, uint8_t* out){
+    nvs_handle_t h;
+    if (nvs_open(NVS_NS_APP, NVS_READONLY, &h) != ESP_OK) return false;
+    esp_err_t err = nvs_get_u8(h, key, out);
+    nvs_close(h);
+    return err == ESP_OK;
+}
+
+esp_err_t nvs_store_u8(const char* key, uint8_t v){
+    nvs_handle_t h;
+    esp_err_t err = nvs_open(NVS_NS_APP, NVS_READWRITE, &h);
+    if (err != ESP_OK) return err;
+
+    err = nvs_set_u8(h, key, v);
+    if (err == ESP_OK) err = nvs_commit(h);
+    nvs_close(h);
+    return err;
+}
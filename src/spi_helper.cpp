@@ -1,6 +1,8 @@
 #include "spi_helper.h"
+#include "esp_attr.h"
 
 Spl06Cal spl_cal;
+spi_device_handle_t spl06_dev = nullptr;
 
 esp_err_t spl06_spi_init(){
 
@@ -13,34 +15,37 @@ esp_err_t spl06_spi_init(){
     return spi_bus_add_device(SPI3_HOST, &devcfg, &spl06_dev);
 }
 
+// The bus runs with DMA (shared with the SD card). The driver mallocs a bounce
+// buffer for any rx buffer that isn't word aligned and a multiple of 4 bytes,
+// so short transfers use the in-transaction tx_data/rx_data and bursts a static
+// aligned buffer. Only the health task talks to the SPL06 after boot.
 esp_err_t spl06_read_reg(uint8_t reg, uint8_t *out){
-    uint8_t tx[2] = { (uint8_t)((reg & 0x7F) | 0x80), 0x00 };
-    uint8_t rx[2] = {0};
-
     spi_transaction_t t = {};
-    t.length = 8 * sizeof(tx);
-    t.tx_buffer = tx;
-    t.rx_buffer = rx;
+    t.flags = SPI_TRANS_USE_TXDATA | SPI_TRANS_USE_RXDATA;
+    t.length = 8 * 2;
+    t.tx_data[0] = (uint8_t)((reg & 0x7F) | 0x80);
+    t.tx_data[1] = 0x00;
 
     esp_err_t err = spi_device_transmit(spl06_dev, &t);
     if (err != ESP_OK) return err;
 
-    *out = rx[1]; //first byte is control phase
+    *out = t.rx_data[1]; //first byte is control phase
     return ESP_OK;
 }
 
 esp_err_t spl06_read_burst(uint8_t start_reg, uint8_t *out, size_t n){
     const size_t total = n + 1;
+    const size_t padded = (total + 3) & ~(size_t)3;     // clocks up to 3 extra registers, ignored
 
-    uint8_t tx[1 + 32]; // up to 32 bytes burst here
-    uint8_t rx[1 + 32];
-    if (total > sizeof(tx)) return ESP_ERR_INVALID_SIZE;
+    WORD_ALIGNED_ATTR static uint8_t tx[36]; // up to 32 bytes burst here
+    WORD_ALIGNED_ATTR static uint8_t rx[36];
+    if (padded > sizeof(tx)) return ESP_ERR_INVALID_SIZE;
 
     tx[0] = (uint8_t)((start_reg & 0x7F) | 0x80);   //reg & 0x7F clears bit7 (forces it 0), | 0x80 sets bit7 to 1 
-    memset(&tx[1], 0x00, n);                        //bit7 = 1 → READ, bit7 = 0 → WRITE
+    memset(&tx[1], 0x00, padded - 1);               //bit7 = 1 → READ, bit7 = 0 → WRITE
 
     spi_transaction_t t = {};
-    t.length = 8 * total;
+    t.length = 8 * padded;
     t.tx_buffer = tx;
     t.rx_buffer = rx;
 
@@ -52,10 +57,11 @@ esp_err_t spl06_read_burst(uint8_t start_reg, uint8_t *out, size_t n){
 }
 
 esp_err_t spl06_write_reg(uint8_t reg, uint8_t val){
-    uint8_t tx[2] = { (uint8_t)(reg & 0x7F), val };
     spi_transaction_t t = {};
-    t.length = 8 * sizeof(tx);
-    t.tx_buffer = tx;
+    t.flags = SPI_TRANS_USE_TXDATA;
+    t.length = 8 * 2;
+    t.tx_data[0] = (uint8_t)(reg & 0x7F);
+    t.tx_data[1] = val;
     return spi_device_transmit(spl06_dev, &t);
 }
 
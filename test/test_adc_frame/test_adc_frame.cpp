@@ -0,0 +1,67 @@
+#include <unity.h>
+#include "adc_frame.h"
+
+static void put_word(uint8_t* buf, size_t idx, uint8_t ch, uint16_t data)
+{
+    uint16_t w = (uint16_t)((ch << 12) | (data & 0x0FFF));
+    buf[idx * 2] = (uint8_t)(w & 0xFF);
+    buf[idx * 2 + 1] = (uint8_t)(w >> 8);
+}
+
+void test_demux_two_channels()
+{
+    uint8_t frame[8 * 2];
+    for (size_t i = 0; i < 8; i++) {
+        put_word(frame, i, (i & 1) ? 7 : 6, (uint16_t)(100 * i));
+    }
+
+    uint16_t a[8], b[8];
+    AdcChannelBlock blocks[2] = { {6, a, 8, 0}, {7, b, 8, 0} };
+
+    TEST_ASSERT_EQUAL(8, adc_frame_demux(frame, sizeof(frame), blocks, 2));
+    TEST_ASSERT_EQUAL(4, blocks[0].len);
+    TEST_ASSERT_EQUAL(4, blocks[1].len);
+    TEST_ASSERT_EQUAL(0, a[0]);
+    TEST_ASSERT_EQUAL(200, a[1]);
+    TEST_ASSERT_EQUAL(100, b[0]);
+    TEST_ASSERT_EQUAL(700, b[3]);
+}
+
+void test_unknown_channel_and_full_block()
+{
+    uint8_t frame[4 * 2];
+    put_word(frame, 0, 6, 1);
+    put_word(frame, 1, 3, 2);   // not subscribed
+    put_word(frame, 2, 6, 3);
+    put_word(frame, 3, 6, 4);   // block already full
+
+    uint16_t a[2];
+    AdcChannelBlock blk{6, a, 2, 0};
+    TEST_ASSERT_EQUAL(2, adc_frame_demux(frame, sizeof(frame), &blk, 1));
+    TEST_ASSERT_EQUAL(1, a[0]);
+    TEST_ASSERT_EQUAL(3, a[1]);
+}
+
+void test_odd_length_and_mean()
+{
+    uint8_t frame[5];
+    put_word(frame, 0, 6, 4095);
+    put_word(frame, 1, 6, 1);
+    frame[4] = 0xFF; // trailing half word is ignored
+
+    uint16_t a[4];
+    AdcChannelBlock blk{6, a, 4, 0};
+    TEST_ASSERT_EQUAL(2, adc_frame_demux(frame, sizeof(frame), &blk, 1));
+    TEST_ASSERT_EQUAL(2048, adc_block_mean(blk));
+
+    AdcChannelBlock empty{6, a, 4, 0};
+    TEST_ASSERT_EQUAL(-1, adc_block_mean(empty));
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_demux_two_channels);
+    RUN_TEST(test_unknown_channel_and_full_block);
+    RUN_TEST(test_odd_length_and_mean);
+    return UNITY_END();
+}
@@ -0,0 +1,288 @@
+#include <unity.h>
+#include <cstring>
+#include <deque>
+#include <string>
+#include <vector>
+#include "binproto.h"
+#include "bin_stream.h"
+#include "binproto_client.h"
+#include "command_parser.h"
+#include "line_assembler.h"
+
+void test_crc_and_cobs()
+{
+    TEST_ASSERT_EQUAL_HEX16(0x29B1, crc16_ccitt((const uint8_t*)"123456789", 9));
+
+    // zeros, runs longer than one COBS group, empty
+    std::vector<std::vector<uint8_t>> cases = { {}, {0}, {0, 0}, {1, 0, 2}, {0x11, 0x22, 0, 0x33} };
+    for (size_t len : { 253, 254, 255, 600 }) {
+        std::vector<uint8_t> v(len);
+        for (size_t i = 0; i < len; i++) v[i] = (uint8_t)(i % 255 + 1);
+        cases.push_back(v);
+        v[len / 2] = 0;
+        cases.push_back(v);
+    }
+    for (auto& c : cases) {
+        uint8_t enc[700], dec[700];
+        size_t n = cobs_encode(c.data(), c.size(), enc, sizeof(enc));
+        TEST_ASSERT_TRUE(n > 0);
+        TEST_ASSERT_TRUE(n <= c.size() + c.size() / 254 + 1);
+        TEST_ASSERT_NULL(memchr(enc, 0, n));
+        TEST_ASSERT_EQUAL(c.size(), cobs_decode(enc, n, dec, sizeof(dec)));
+        TEST_ASSERT_EQUAL(0, memcmp(c.data(), dec, c.size()));
+    }
+}
+
+void test_frame_and_demux()
+{
+    uint8_t wire[BIN_MAX_WIRE];
+    CommandEvent ev{ CommandType::SetPeriod, 250 };
+    uint8_t p[8];
+    size_t n = bin_encode(BinMsg::Command, 7, p, bin_put_command(ev, p), wire, sizeof(wire));
+
+    // text, frame, text, corrupted frame, frame again - byte by byte
+    std::vector<uint8_t> rx;
+    auto add = [&](const void* d, size_t k) { rx.insert(rx.end(), (const uint8_t*)d, (const uint8_t*)d + k); };
+    add("status\r\n", 8);
+    add(wire, n);
+    add("fps 5\r\n", 7);
+    std::vector<uint8_t> bad(wire, wire + n);
+    bad[3] ^= 0x40;
+    add(bad.data(), bad.size());
+    add(wire, n);
+
+    FrameDemux d;
+    std::string text;
+    int frames = 0;
+    for (uint8_t b : rx) {
+        d.feed(&b, 1, [&](const uint8_t* t, size_t k) { text.append((const char*)t, k); },
+            [&](const BinFrame& f) {
+                frames++;
+                CommandEvent got;
+                TEST_ASSERT_EQUAL((int)BinMsg::Command, (int)f.type);
+                TEST_ASSERT_EQUAL(7, f.seq);
+                TEST_ASSERT_TRUE(bin_get_command(f.payload, f.len, &got));
+                TEST_ASSERT_EQUAL_UINT32(250, got.value);
+            });
+    }
+    TEST_ASSERT_EQUAL_STRING("status\r\nfps 5\r\n", text.c_str());
+    TEST_ASSERT_EQUAL(2, frames);
+    TEST_ASSERT_EQUAL(1, d.bad_frames());
+    TEST_ASSERT_FALSE(d.in_frame());
+}
+
+// In-process device: the same demux -> line assembler / bin_serve path as the uart task
+struct FakeDevice : BinDevice {
+    FrameDemux demux;
+    LineAssembler<64> lines;
+    std::vector<CommandEvent> cmdQ;
+    size_t cmdq_cap = 4;
+    std::deque<uint8_t> tx;
+    int text_commands = 0;
+
+    bool submit(const CommandEvent& ev) override {
+        if (cmdQ.size() >= cmdq_cap) return false;
+        cmdQ.push_back(ev);
+        return true;
+    }
+    void status(BinStatus* s) override {
+        s->uptime_ms = 123456; s->period_ms = 1000; s->paused = 1; s->fps = 5;
+        s->devices = BIN_DEV_I2C | BIN_DEV_SHT31;
+    }
+    void latest(SensorRecord* r) override {
+        *r = SensorRecord{ 42000, 21.5f, 40.25f, 1013.2f, 12.5f, 2048 };
+    }
+
+    void print(const char* s) { tx.insert(tx.end(), s, s + strlen(s)); }
+
+    void rx(const uint8_t* p, size_t n) {
+        demux.feed(p, n,
+            [&](const uint8_t* t, size_t k) {
+                lines.feed(t, k, [&](char* line, size_t, bool) {
+                    CommandEvent ev;
+                    if (parse_command_line(line, &ev) && submit(ev)) text_commands++;
+                    print("I (1) UART: > \r\n");
+                }, [&](const char* e, size_t k2) { tx.insert(tx.end(), e, e + k2); });
+            },
+            [&](const BinFrame& f) {
+                print("I (2) APP: log line between frames\r\n");
+                uint8_t out[BIN_MAX_WIRE];
+                size_t k = bin_serve(f, *this, out, sizeof(out));
+                tx.insert(tx.end(), out, out + k);
+            });
+    }
+};
+
+struct Loopback : BinTransport {
+    FakeDevice& dev;
+    size_t chunk = 5;       // hand replies back in small pieces
+    explicit Loopback(FakeDevice& d) : dev(d) {}
+    bool write(const uint8_t* p, size_t n) override { dev.rx(p, n); return true; }
+    size_t read(uint8_t* p, size_t cap, int) override {
+        size_t n = 0;
+        while (n < cap && n < chunk && !dev.tx.empty()) { p[n++] = dev.tx.front(); dev.tx.pop_front(); }
+        return n;
+    }
+};
+
+void test_loopback_commands()
+{
+    FakeDevice dev;
+    Loopback link(dev);
+    BinClient c(link, 50);
+
+    BinAck a = BinAck::Busy;
+    TEST_ASSERT_TRUE(c.command(CommandEvent{ CommandType::SetPeriod, 500 }, &a));
+    TEST_ASSERT_EQUAL((int)BinAck::Ok, (int)a);
+    TEST_ASSERT_TRUE(c.command(CommandEvent{ CommandType::SetFps, 99 }, &a));
+    TEST_ASSERT_EQUAL((int)BinAck::Invalid, (int)a);
+
+    // text and binary share the queue
+    const char* typed = "pause on\r";
+    link.write((const uint8_t*)typed, strlen(typed));
+    TEST_ASSERT_EQUAL(1, dev.text_commands);
+    TEST_ASSERT_EQUAL(2, dev.cmdQ.size());
+    TEST_ASSERT_EQUAL((int)CommandType::SetPeriod, (int)dev.cmdQ[0].type);
+    TEST_ASSERT_EQUAL((int)CommandType::PauseOn, (int)dev.cmdQ[1].type);
+
+    dev.cmdq_cap = 2;
+    TEST_ASSERT_TRUE(c.command(CommandEvent{ CommandType::Status, 0 }, &a));
+    TEST_ASSERT_EQUAL((int)BinAck::Busy, (int)a);
+    TEST_ASSERT_EQUAL(0, c.bad_frames());
+}
+
+void test_loopback_status_and_samples()
+{
+    FakeDevice dev;
+    Loopback link(dev);
+    BinClient c(link, 50);
+
+    BinStatus s{};
+    TEST_ASSERT_TRUE(c.status(&s));
+    TEST_ASSERT_EQUAL_UINT32(123456, s.uptime_ms);
+    TEST_ASSERT_EQUAL_UINT32(1000, s.period_ms);
+    TEST_ASSERT_EQUAL(1, s.paused);
+    TEST_ASSERT_EQUAL(BIN_DEV_I2C | BIN_DEV_SHT31, s.devices);
+
+    SensorRecord r[4];
+    TEST_ASSERT_EQUAL(1, c.samples(r, 4));
+    TEST_ASSERT_EQUAL_UINT32(42000, r[0].timestamp_ms);
+    TEST_ASSERT_EQUAL_FLOAT(1013.2f, r[0].press_hpa);
+    TEST_ASSERT_EQUAL_FLOAT(2048.0f, r[0].adc);
+
+    // the log output printed around the frames is not lost
+    std::string text = c.take_text();
+    TEST_ASSERT_NOT_NULL(strstr(text.c_str(), "log line between frames"));
+}
+
+void test_loopback_timeout_and_stray()
+{
+    FakeDevice dev;
+    Loopback link(dev);
+    BinClient c(link, 20);
+
+    // a reply with a stale seq is not taken as the answer
+    uint8_t wire[BIN_MAX_WIRE];
+    const uint8_t ok = (uint8_t)BinAck::Ok;
+    size_t n = bin_encode(BinMsg::Ack, 99, &ok, 1, wire, sizeof(wire));
+    dev.tx.insert(dev.tx.end(), wire, wire + n);
+    BinAck a;
+    TEST_ASSERT_TRUE(c.command(CommandEvent{ CommandType::PauseOff, 0 }, &a));
+    TEST_ASSERT_EQUAL(1, c.stray_frames());
+
+    // device gone: request times out
+    struct Dead : BinTransport {
+        bool write(const uint8_t*, size_t) override { return true; }
+        size_t read(uint8_t*, size_t, int) override { return 0; }
+    } dead;
+    BinClient lost(dead, 5);
+    BinStatus s;
+    TEST_ASSERT_FALSE(lost.status(&s));
+}
+
+void test_stream_rate_limit()
+{
+    BinStream st;
+    st.start(100, 4, 1000000);          // 100 frames/s, burst 4
+
+    // burst goes through, then one frame per 10 ms
+    int sent = 0;
+    for (int i = 0; i < 10; i++) if (st.admit(1000000)) { st.sent(200); sent++; }
+    TEST_ASSERT_EQUAL(4, sent);
+    TEST_ASSERT_EQUAL(6, st.throttled);
+
+    sent = 0;
+    for (uint64_t t = 1000000; t <= 2000000; t += 1000) if (st.admit(t)) { st.sent(200); sent++; }
+    TEST_ASSERT_EQUAL(100, sent);
+    TEST_ASSERT_EQUAL(104, st.frames);
+    TEST_ASSERT_EQUAL_UINT32(104 * 200, st.bytes_per_s(2000000));   // 1 s elapsed
+    TEST_ASSERT_EQUAL(104 % 256, st.seq);
+
+    st.stop(2000000);
+    TEST_ASSERT_FALSE(st.admit(3000000));
+    TEST_ASSERT_EQUAL_UINT32(104 * 200, st.bytes_per_s(9000000));   // rate frozen at stop
+}
+
+void test_loopback_stream()
+{
+    FakeDevice dev;
+    Loopback link(dev);
+    BinClient c(link, 20);
+
+    uint32_t next_count = 0, records = 0, gaps = 0;
+    uint8_t next_seq = 0;
+    c.on_frame([&](const BinFrame& f) {
+        uint32_t first = 0;
+        SensorRecord r[BIN_MAX_STREAM_RECORDS];
+        size_t n = bin_get_stream(f.payload, f.len, &first, r, BIN_MAX_STREAM_RECORDS);
+        if (f.seq != next_seq || first != next_count) gaps++;
+        next_seq = (uint8_t)(f.seq + 1);
+        next_count = first + (uint32_t)n;
+        records += (uint32_t)n;
+    });
+
+    // device streams 16-record batches as two frames each, one frame lost on the wire
+    uint8_t seq = 0;
+    for (uint32_t batch = 0; batch < 20; batch++) {
+        SensorRecord r[16];
+        for (int i = 0; i < 16; i++) r[i] = SensorRecord{ batch * 16 + i, 20, 50, 1000, 0, 0 };
+        for (size_t off = 0; off < 16; off += BIN_MAX_STREAM_RECORDS) {
+            size_t k = 16 - off < BIN_MAX_STREAM_RECORDS ? 16 - off : BIN_MAX_STREAM_RECORDS;
+            uint8_t p[BIN_MAX_PAYLOAD], wire[BIN_MAX_WIRE];
+            size_t n = bin_encode(BinMsg::Stream, seq++, p, bin_put_stream(batch * 16 + (uint32_t)off, r + off, k, p, sizeof(p)),
+                                  wire, sizeof(wire));
+            TEST_ASSERT_TRUE(n > 0);
+            if (batch == 7 && off == 0) continue;
+            dev.tx.insert(dev.tx.end(), wire, wire + n);
+        }
+    }
+    link.chunk = 64;
+    while (!dev.tx.empty()) c.poll(0);
+
+    TEST_ASSERT_EQUAL(20 * 16 - BIN_MAX_STREAM_RECORDS, records);
+    TEST_ASSERT_EQUAL(1, gaps);
+    TEST_ASSERT_EQUAL(0, c.stray_frames());
+
+    // a request in the middle of the stream still gets its answer, stream frames keep flowing
+    SensorRecord one[BIN_MAX_STREAM_RECORDS] = {};
+    uint8_t p[BIN_MAX_PAYLOAD], wire[BIN_MAX_WIRE];
+    size_t n = bin_encode(BinMsg::Stream, next_seq, p, bin_put_stream(next_count, one, 3, p, sizeof(p)), wire, sizeof(wire));
+    dev.tx.insert(dev.tx.end(), wire, wire + n);
+    BinStatus s;
+    TEST_ASSERT_TRUE(c.status(&s));
+    TEST_ASSERT_EQUAL(20 * 16 - BIN_MAX_STREAM_RECORDS + 3, records);
+    TEST_ASSERT_EQUAL(1, gaps);
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_crc_and_cobs);
+    RUN_TEST(test_frame_and_demux);
+    RUN_TEST(test_loopback_commands);
+    RUN_TEST(test_loopback_status_and_samples);
+    RUN_TEST(test_loopback_timeout_and_stray);
+    RUN_TEST(test_stream_rate_limit);
+    RUN_TEST(test_loopback_stream);
+    return UNITY_END();
+}
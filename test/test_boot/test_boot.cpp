@@ -0,0 +1,81 @@
+#include <unity.h>
+#include "boot_profile.h"
+#include "boot_cache.h"
+
+void test_profile_sequential_steps()
+{
+    BootProfile<4> p;
+    int a = p.begin("i2c", 1000);
+    p.end(a, 3000);
+    int b = p.begin("spi", 3000);
+    p.end(b, 3500, false);
+
+    TEST_ASSERT_EQUAL(2, p.size());
+    TEST_ASSERT_EQUAL(2000, p[0].dur_us);
+    TEST_ASSERT_TRUE(p[0].ok);
+    TEST_ASSERT_FALSE(p[1].ok);
+    TEST_ASSERT_EQUAL(2500, p.total_us());
+    TEST_ASSERT_EQUAL(2500, p.busy_us());
+}
+
+void test_profile_overlap_and_full()
+{
+    BootProfile<2> p;
+    int a = p.begin("i2c", 0);
+    int b = p.begin("sd", 100);
+    p.end(b, 5100);
+    p.end(a, 4000);
+    TEST_ASSERT_EQUAL(5100, p.total_us());
+    TEST_ASSERT_EQUAL(9000, p.busy_us());   // ran in parallel
+
+    TEST_ASSERT_EQUAL(-1, p.begin("extra", 6000));
+    p.end(-1, 7000);                        // ignored
+    TEST_ASSERT_EQUAL(5100, p.total_us());
+}
+
+void test_cache_seal_and_validate()
+{
+    BootCache c;
+    boot_cache_reset(c);
+    TEST_ASSERT_TRUE(boot_cache_add_i2c(c, 0x44));
+    TEST_ASSERT_TRUE(boot_cache_add_i2c(c, 0x3C));
+    TEST_ASSERT_TRUE(boot_cache_add_i2c(c, 0x44));   // duplicate
+    TEST_ASSERT_EQUAL(2, c.n_i2c);
+
+    uint8_t calib[18];
+    for (int i = 0; i < 18; i++) calib[i] = (uint8_t)(i * 7);
+    boot_cache_set_spl06(c, 0x10, calib);
+
+    TEST_ASSERT_FALSE(boot_cache_valid(c));          // not sealed yet
+    boot_cache_seal(c);
+    TEST_ASSERT_TRUE(boot_cache_valid(c));
+    TEST_ASSERT_TRUE(boot_cache_has_i2c(c, 0x3C));
+    TEST_ASSERT_FALSE(boot_cache_has_i2c(c, 0x50));
+
+    // any flipped byte invalidates it
+    BootCache bad = c;
+    bad.spl06_calib[5] ^= 0x01;
+    TEST_ASSERT_FALSE(boot_cache_valid(bad));
+    bad = c;
+    bad.magic = 0;
+    TEST_ASSERT_FALSE(boot_cache_valid(bad));
+}
+
+void test_cache_table_full()
+{
+    BootCache c;
+    boot_cache_reset(c);
+    for (int i = 0; i < BOOT_CACHE_MAX_I2C; i++) TEST_ASSERT_TRUE(boot_cache_add_i2c(c, (uint8_t)(0x10 + i)));
+    TEST_ASSERT_FALSE(boot_cache_add_i2c(c, 0x70));
+    TEST_ASSERT_EQUAL(BOOT_CACHE_MAX_I2C, c.n_i2c);
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_profile_sequential_steps);
+    RUN_TEST(test_profile_overlap_and_full);
+    RUN_TEST(test_cache_seal_and_validate);
+    RUN_TEST(test_cache_table_full);
+    return UNITY_END();
+}
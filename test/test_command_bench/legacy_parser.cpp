@@ -0,0 +1,118 @@
+// The strcmp/starts_with chain parse_command_line() was before the command
+// registry, kept only as the benchmark baseline.
+#include "legacy_parser.h"
+#include <cstring>
+#include <cstdlib>
+
+static bool starts_with(const char* s, const char* pref){
+    while (*pref) { if (*s++ != *pref++) return false; }
+    return true;
+}
+
+bool legacy_parse_command_line(const char* line, CommandEvent* out)
+{
+    if (!line || !out) return false;
+
+    // status
+    if (!strcmp(line, "status")) {
+        out->type = CommandType::Status;
+        out->value = 0;
+        return true;
+    }
+
+    // scan: full I2C scan, refreshes the cached boot device map
+    if (!strcmp(line, "scan")) {
+        out->type = CommandType::I2cScan;
+        out->value = 0;
+        return true;
+    }
+
+    // help (let UART handle printing help; parser can still recognize it if you want)
+    if (!strcmp(line, "help")) {
+        // You can either treat this as a command event or let uart() handle it separately.
+        return false;
+    }
+
+    // pause
+    if (!strcmp(line, "pause toggle")) {
+        out->type = CommandType::PauseToggle;
+        out->value = 0;
+        return true;
+    }
+    if (!strcmp(line, "pause on")) {
+        out->type = CommandType::PauseOn;
+        out->value = 0;
+        return true;
+    }
+    if (!strcmp(line, "pause off")) {
+        out->type = CommandType::PauseOff;
+        out->value = 0;
+        return true;
+    }
+
+    // sensor [temp|rh|press|alt|adc]
+    if (!strcmp(line, "sensor")) {
+        out->type = CommandType::SensorStats;
+        out->value = SENSOR_ALL;
+        return true;
+    }
+    if (starts_with(line, "sensor ")) {
+        for (size_t i = 0; i < SENSOR_CH_COUNT; i++) {
+            if (!strcmp(line + 7, SENSOR_CH_NAMES[i])) {
+                out->type = CommandType::SensorStats;
+                out->value = (uint32_t)i;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // history <channel> <seconds>
+    if (starts_with(line, "history ")) {
+        const char* arg = line + 8;
+        for (size_t i = 0; i < SENSOR_CH_COUNT; i++) {
+            size_t n = strlen(SENSOR_CH_NAMES[i]);
+            if (strncmp(arg, SENSOR_CH_NAMES[i], n) != 0 || arg[n] != ' ') continue;
+
+            char* end = nullptr;
+            unsigned long secs = strtoul(arg + n + 1, &end, 10);
+            if (end == arg + n + 1 || *end != '\0') return false;
+            if (secs < 1 || secs > 86400) return false;
+
+            out->type = CommandType::History;
+            out->value = ((uint32_t)i << 24) | (uint32_t)secs;
+            return true;
+        }
+        return false;
+    }
+
+    // fps N (display frame cap)
+    if (starts_with(line, "fps ")) {
+        char* end = nullptr;
+        unsigned long v = strtoul(line + 4, &end, 10);
+        if (end == (line + 4) || *end != '\0') return false;
+        if (v < 1 || v > 30) return false;
+
+        out->type = CommandType::SetFps;
+        out->value = (uint32_t)v;
+        return true;
+    }
+
+    // period N
+    if (starts_with(line, "period ")) {
+        char* end = nullptr;
+        unsigned long v = strtoul(line + 7, &end, 10);
+
+        // must consume at least 1 digit and end exactly at '\0'
+        if (end == (line + 7) || *end != '\0') return false;
+
+        // range check
+        if (v < 50 || v > 10000) return false;
+
+        out->type = CommandType::SetPeriod;
+        out->value = (uint32_t)v;
+        return true;
+    }
+
+    return false;
+}
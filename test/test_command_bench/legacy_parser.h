@@ -0,0 +1,4 @@
+#pragma once
+#include "app_types.h"
+
+bool legacy_parse_command_line(const char* line, CommandEvent* out);
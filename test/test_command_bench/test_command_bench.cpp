@@ -0,0 +1,76 @@
+#include <unity.h>
+#include <chrono>
+#include <cstdio>
+#include "command_parser.h"
+#include "legacy_parser.h"
+
+// Registry parser vs the old strcmp chain (native env). Prints ns per line.
+// Same caveat as test_dsp_bench: compare the two, don't read ESP32 timings off it.
+
+static const char* const LINES[] = {
+    "status", "scan", "pause on", "pause off", "pause toggle",
+    "sensor", "sensor temp", "sensor adc", "history press 3600", "history alt 60",
+    "fps 10", "period 250", "period 10000",
+    // rejected ones walk the whole chain in the legacy parser
+    "period 12x", "fps 31", "history wind 10", "sensor wind", "reboot", "help",
+};
+static constexpr size_t N_LINES = sizeof(LINES) / sizeof(LINES[0]);
+static constexpr int ROUNDS = 200000;   // single-line sets need this many to settle
+static volatile uint32_t sink;
+
+template <typename F>
+static double ns_per_line(const char* const* lines, size_t n, F&& parse)
+{
+    CommandEvent ev{};
+    uint32_t acc = 0;
+    auto t0 = std::chrono::steady_clock::now();
+    for (int r = 0; r < ROUNDS; r++) {
+        for (size_t i = 0; i < n; i++) acc += parse(lines[i], &ev) ? ev.value + 1 : 0;
+    }
+    auto t1 = std::chrono::steady_clock::now();
+    sink = acc;
+    return std::chrono::duration<double, std::nano>(t1 - t0).count() / ((double)ROUNDS * n);
+}
+
+void test_same_results()
+{
+    for (size_t i = 0; i < N_LINES; i++) {
+        CommandEvent a{}, b{};
+        bool ra = legacy_parse_command_line(LINES[i], &a);
+        bool rb = parse_command_line(LINES[i], &b);
+        TEST_ASSERT_EQUAL(ra, rb);
+        if (ra) {
+            TEST_ASSERT_EQUAL((int)a.type, (int)b.type);
+            TEST_ASSERT_EQUAL_UINT32(a.value, b.value);
+        }
+    }
+}
+
+void bench_parsers()
+{
+    struct Set { const char* name; const char* const* lines; size_t n; };
+    const Set sets[] = {
+        { "all",       LINES,      N_LINES },
+        { "period",    LINES + 11, 1 },         // last in the legacy chain
+        { "status",    LINES,      1 },         // first in the legacy chain
+        { "unknown",   LINES + 17, 1 },
+    };
+
+    char msg[96];
+    for (const Set& s : sets) {
+        double legacy = ns_per_line(s.lines, s.n, legacy_parse_command_line);
+        double table = ns_per_line(s.lines, s.n, parse_command_line);
+        snprintf(msg, sizeof(msg), "%-8s legacy %7.1f ns  registry %7.1f ns  (x%.2f)",
+                 s.name, legacy, table, table > 0 ? legacy / table : 0.0);
+        TEST_MESSAGE(msg);
+        TEST_ASSERT_GREATER_THAN(0.0, table);
+    }
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_same_results);
+    RUN_TEST(bench_parsers);
+    return UNITY_END();
+}
@@ -1,5 +1,8 @@
 #include <unity.h>
 #include "command_parser.h"
+#include "command_registry.h"
+#include <cstdio>
+#include <cstring>
 
 void test_status() {
     CommandEvent ev{};
@@ -25,17 +28,141 @@ void test_pause_on() {
     TEST_ASSERT_EQUAL((int)CommandType::PauseOn, (int)ev.type);
 }
 
+void test_sensor() {
+    CommandEvent ev{};
+    TEST_ASSERT_TRUE(parse_command_line("sensor press", &ev));
+    TEST_ASSERT_EQUAL((int)CommandType::SensorStats, (int)ev.type);
+    TEST_ASSERT_EQUAL_UINT32((uint32_t)SensorChannel::PressureHpa, ev.value);
+    TEST_ASSERT_TRUE(parse_command_line("sensor", &ev));
+    TEST_ASSERT_EQUAL_UINT32(SENSOR_ALL, ev.value);
+    TEST_ASSERT_FALSE(parse_command_line("sensor wind", &ev));
+}
+
+void test_history() {
+    CommandEvent ev{};
+    TEST_ASSERT_TRUE(parse_command_line("history temp 600", &ev));
+    TEST_ASSERT_EQUAL((int)CommandType::History, (int)ev.type);
+    TEST_ASSERT_EQUAL_UINT32(600, ev.value & 0xFFFFFF);
+    TEST_ASSERT_EQUAL_UINT32((uint32_t)SensorChannel::TempC, ev.value >> 24);
+    TEST_ASSERT_FALSE(parse_command_line("history temp 0", &ev));
+    TEST_ASSERT_FALSE(parse_command_line("history temp", &ev));
+}
+
+void test_fps() {
+    CommandEvent ev{};
+    TEST_ASSERT_TRUE(parse_command_line("fps 10", &ev));
+    TEST_ASSERT_EQUAL((int)CommandType::SetFps, (int)ev.type);
+    TEST_ASSERT_EQUAL_UINT32(10, ev.value);
+    TEST_ASSERT_FALSE(parse_command_line("fps 0", &ev));
+    TEST_ASSERT_FALSE(parse_command_line("fps 31", &ev));
+}
+
+void test_scan() {
+    CommandEvent ev{};
+    TEST_ASSERT_TRUE(parse_command_line("scan", &ev));
+    TEST_ASSERT_EQUAL((int)CommandType::I2cScan, (int)ev.type);
+    TEST_ASSERT_FALSE(parse_command_line("scan 1", &ev));
+}
+
 void test_unknown() {
     CommandEvent ev{};
     TEST_ASSERT_FALSE(parse_command_line("random 123", &ev));
 }
 
+void test_event_valid() {
+    CommandEvent ev{};
+    const char* ok[] = { "status", "period 1", "period 10000", "period us 250", "fps 30", "sensor",
+                         "sensor adc", "history alt 21600", "pause toggle", "scan" };
+    for (const char* line : ok) {
+        TEST_ASSERT_TRUE(parse_command_line(line, &ev));
+        TEST_ASSERT_TRUE(command_event_valid(ev));
+    }
+    TEST_ASSERT_FALSE(command_event_valid(CommandEvent{ CommandType::SetPeriod, 0 }));
+    TEST_ASSERT_FALSE(command_event_valid(CommandEvent{ CommandType::SetPeriod, 10001 }));
+    TEST_ASSERT_FALSE(command_event_valid(CommandEvent{ CommandType::SetPeriodUs, PERIOD_MIN_US - 1 }));
+    TEST_ASSERT_FALSE(command_event_valid(CommandEvent{ CommandType::SetFps, 0 }));
+    TEST_ASSERT_FALSE(command_event_valid(CommandEvent{ CommandType::SensorStats, 5 }));
+    TEST_ASSERT_FALSE(command_event_valid(CommandEvent{ CommandType::History, (5u << 24) | 10 }));
+    TEST_ASSERT_FALSE(command_event_valid(CommandEvent{ (CommandType)200, 0 }));
+}
+
+void test_registry_rows_parse() {
+    // every row, with its smallest and largest arguments, parses back to itself
+    for (const CommandSpec& c : COMMANDS) {
+        for (int edge = 0; edge < 2; edge++) {
+            char line[64];
+            int n = snprintf(line, sizeof(line), "%s%s%s", c.word, c.sub ? " " : "", c.sub ? c.sub : "");
+            for (uint8_t k = 0; k < c.n_args; k++) {
+                const ArgSpec& a = c.args[k];
+                if (a.kind == ArgKind::Enum) n += snprintf(line + n, sizeof(line) - n, " %s", a.names[edge ? a.n_names - 1 : 0]);
+                else n += snprintf(line + n, sizeof(line) - n, " %u", (unsigned)(edge ? a.max : a.min));
+            }
+            CommandEvent ev{};
+            TEST_ASSERT_TRUE(parse_command_line(line, &ev));
+            TEST_ASSERT_EQUAL((int)c.type, (int)ev.type);
+            TEST_ASSERT_TRUE(command_event_valid(ev));
+        }
+    }
+}
+
+void test_registry_lookup() {
+    TEST_ASSERT_NOT_NULL(command_find("history", 7));
+    TEST_ASSERT_EQUAL_STRING("pause", command_find("pause", 5)->word);
+    TEST_ASSERT_NULL(command_find("histor", 6));
+    TEST_ASSERT_NULL(command_find("help", 4));
+    TEST_ASSERT_NULL(command_find("statusstatus", 12));   // longer than any first word
+
+    CommandEvent ev{};
+    TEST_ASSERT_TRUE(parse_command_line("period   250", &ev));
+    TEST_ASSERT_EQUAL_UINT32(250, ev.value);
+    TEST_ASSERT_TRUE(parse_command_line("period us 500", &ev));
+    TEST_ASSERT_EQUAL((int)CommandType::SetPeriodUs, (int)ev.type);
+    TEST_ASSERT_EQUAL_UINT32(500, ev.value);
+    TEST_ASSERT_TRUE(parse_command_line("bench dsp", &ev));
+    TEST_ASSERT_EQUAL((int)CommandType::DspBench, (int)ev.type);
+    TEST_ASSERT_TRUE(parse_command_line("bench 30", &ev));
+    TEST_ASSERT_EQUAL((int)CommandType::Bench, (int)ev.type);
+    TEST_ASSERT_FALSE(parse_command_line("period us", &ev));
+    TEST_ASSERT_FALSE(parse_command_line("period 0", &ev));
+    TEST_ASSERT_FALSE(parse_command_line("pause", &ev));
+    TEST_ASSERT_FALSE(parse_command_line("pause on now", &ev));
+    TEST_ASSERT_FALSE(parse_command_line("period 99999999999", &ev));
+    TEST_ASSERT_FALSE(parse_command_line("period -5", &ev));
+    TEST_ASSERT_FALSE(parse_command_line("", &ev));
+    TEST_ASSERT_FALSE(parse_command_line("statu", &ev));
+    TEST_ASSERT_FALSE(parse_command_line("historyx temp 5", &ev));
+    TEST_ASSERT_TRUE(parse_command_line("  status  ", &ev));
+    TEST_ASSERT_EQUAL((int)CommandType::Status, (int)ev.type);
+    TEST_ASSERT_TRUE(parse_command_line("sensor ", &ev));
+    TEST_ASSERT_EQUAL_UINT32(SENSOR_ALL, ev.value);
+}
+
+void test_registry_help() {
+    char line[128];
+    const CommandSpec* h = command_find("history", 7);
+    command_help_line(*h, line, sizeof(line));
+    TEST_ASSERT_EQUAL(0, strncmp(line, "history <temp|rh|press|alt|adc> <1..21600 s>", 44));
+    TEST_ASSERT_NOT_NULL(strstr(line, h->help));
+
+    // truncates instead of overflowing
+    TEST_ASSERT_EQUAL(9, command_help_line(*h, line, 10));
+    TEST_ASSERT_EQUAL(9, strlen(line));
+}
+
 int main() {
     UNITY_BEGIN();
     RUN_TEST(test_status);
     RUN_TEST(test_period_ok);
     RUN_TEST(test_period_bad_chars);
     RUN_TEST(test_pause_on);
+    RUN_TEST(test_sensor);
+    RUN_TEST(test_history);
+    RUN_TEST(test_fps);
+    RUN_TEST(test_scan);
     RUN_TEST(test_unknown);
+    RUN_TEST(test_event_valid);
+    RUN_TEST(test_registry_rows_parse);
+    RUN_TEST(test_registry_lookup);
+    RUN_TEST(test_registry_help);
     return UNITY_END();
 }
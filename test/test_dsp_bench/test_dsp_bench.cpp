@@ -0,0 +1,97 @@
+#include <unity.h>
+#include <chrono>
+#include <cstdio>
+#include "dsp_filter.h"
+
+// Throughput benchmarks (native env). Prints Msamples/s per block size and order.
+// Numbers are for comparing settings, not absolute ESP32 performance; the
+// 'bench dsp' command measures the kernels the target build actually uses.
+
+static constexpr size_t TOTAL_SAMPLES = 1 << 18;
+static float in_buf[512];
+static float out_buf[512];
+static volatile float sink;
+
+template <typename F>
+static double msps(size_t block, F&& run_block)
+{
+    auto t0 = std::chrono::steady_clock::now();
+    for (size_t done = 0; done < TOTAL_SAMPLES; done += block) run_block(block);
+    auto t1 = std::chrono::steady_clock::now();
+    sink = out_buf[0];
+    double us = std::chrono::duration<double, std::micro>(t1 - t0).count();
+    return us > 0 ? (double)TOTAL_SAMPLES / us : 0.0;
+}
+
+static const size_t blocks[] = {32, 64, 128, 256, 512};
+
+static void fill_input()
+{
+    for (size_t i = 0; i < 512; i++) in_buf[i] = (float)((i * 37) % 4096);
+}
+
+void bench_moving_average()
+{
+    const size_t windows[] = {4, 16, 64};
+    char msg[96];
+    for (size_t w : windows) {
+        for (size_t b : blocks) {
+            MovingAverage ma;
+            ma.init(w);
+            double r = msps(b, [&](size_t n) { ma.process(in_buf, out_buf, n); });
+            snprintf(msg, sizeof(msg), "MA    window=%-3u block=%-3u %8.1f Msps", (unsigned)w, (unsigned)b, r);
+            TEST_MESSAGE(msg);
+            TEST_ASSERT_GREATER_THAN(0.0, r);
+        }
+    }
+}
+
+void bench_biquad()
+{
+    float c[BiquadCascade::MAX_SECTIONS][5];
+    for (auto& s : c) biquad_lowpass(0.05f, 0.707f, s);
+
+    char msg[96];
+    for (size_t sec = 1; sec <= BiquadCascade::MAX_SECTIONS; sec *= 2) {
+        for (size_t b : blocks) {
+            BiquadCascade bq;
+            bq.init(c, sec);
+            double r = msps(b, [&](size_t n) { bq.process(in_buf, out_buf, n); });
+            snprintf(msg, sizeof(msg), "IIR   order=%-3u  block=%-3u %8.1f Msps", (unsigned)(2 * sec), (unsigned)b, r);
+            TEST_MESSAGE(msg);
+            TEST_ASSERT_GREATER_THAN(0.0, r);
+        }
+    }
+}
+
+void bench_fir_decimator()
+{
+    static float coefs[FirDecimator::MAX_TAPS];
+    const size_t taps_list[] = {8, 16, 32, 64};
+    const size_t decims[] = {1, 4};
+
+    char msg[96];
+    for (size_t taps : taps_list) {
+        fir_lowpass(0.1f, coefs, taps);
+        for (size_t d : decims) {
+            for (size_t b : blocks) {
+                FirDecimator fir;
+                fir.init(coefs, taps, d);
+                double r = msps(b, [&](size_t n) { fir.process(in_buf, out_buf, n); });
+                snprintf(msg, sizeof(msg), "FIR   taps=%-3u decim=%u block=%-3u %8.1f Msps",
+                         (unsigned)taps, (unsigned)d, (unsigned)b, r);
+                TEST_MESSAGE(msg);
+                TEST_ASSERT_GREATER_THAN(0.0, r);
+            }
+        }
+    }
+}
+
+int main() {
+    fill_input();
+    UNITY_BEGIN();
+    RUN_TEST(bench_moving_average);
+    RUN_TEST(bench_biquad);
+    RUN_TEST(bench_fir_decimator);
+    return UNITY_END();
+}
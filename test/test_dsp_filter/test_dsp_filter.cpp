@@ -0,0 +1,151 @@
+#include <unity.h>
+#include "dsp_filter.h"
+
+void test_moving_average_step()
+{
+    MovingAverage ma;
+    TEST_ASSERT_TRUE(ma.init(4));
+
+    float in[8] = {4, 4, 4, 4, 8, 8, 8, 8};
+    float out[8];
+    ma.process(in, out, 8);
+
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, 4.0f, out[0]); // warm-up averages what it has
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, 4.0f, out[3]);
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, 5.0f, out[4]);
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, 8.0f, out[7]);
+}
+
+void test_moving_average_block_split_matches()
+{
+    MovingAverage a, b;
+    a.init(5);
+    b.init(5);
+
+    float in[32], out_a[32], out_b[32];
+    for (int i = 0; i < 32; i++) in[i] = (float)((i * 7) % 11);
+
+    a.process(in, out_a, 32);
+    b.process(in, out_b, 10);        // same stream in uneven blocks
+    b.process(in + 10, out_b + 10, 1);
+    b.process(in + 11, out_b + 11, 21);
+
+    for (int i = 0; i < 32; i++) TEST_ASSERT_FLOAT_WITHIN(1e-5f, out_a[i], out_b[i]);
+}
+
+void test_biquad_lowpass_dc_gain()
+{
+    float c[1][5];
+    biquad_lowpass(0.05f, 0.707f, c[0]);
+
+    BiquadCascade bq;
+    TEST_ASSERT_TRUE(bq.init(c, 1));
+
+    float buf[256];
+    for (int i = 0; i < 256; i++) buf[i] = 100.0f;
+    bq.process(buf, buf, 256);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 100.0f, buf[255]);
+}
+
+void test_biquad_attenuates_nyquist()
+{
+    float c[2][5];
+    biquad_lowpass(0.02f, 0.707f, c[0]);
+    biquad_lowpass(0.02f, 0.707f, c[1]);
+
+    BiquadCascade bq;
+    bq.init(c, 2);
+
+    float buf[256];
+    for (int i = 0; i < 256; i++) buf[i] = (i & 1) ? 1.0f : -1.0f;
+    bq.process(buf, buf, 256);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 0.0f, buf[255]);
+}
+
+void test_fir_decimator_impulse_and_count()
+{
+    const float coefs[4] = {0.1f, 0.2f, 0.3f, 0.4f};
+    FirDecimator fir;
+    TEST_ASSERT_TRUE(fir.init(coefs, 4, 1));
+
+    float in[6] = {1, 0, 0, 0, 0, 0};
+    float out[6];
+    TEST_ASSERT_EQUAL(6, fir.process(in, out, 6));
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, 0.1f, out[0]);
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, 0.4f, out[3]);
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, 0.0f, out[4]);
+
+    FirDecimator dec;
+    TEST_ASSERT_TRUE(dec.init(coefs, 4, 4));
+    float ones[16];
+    for (int i = 0; i < 16; i++) ones[i] = 1.0f;
+    TEST_ASSERT_EQUAL(4, dec.process(ones, out, 16));
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, 1.0f, out[3]);
+}
+
+void test_fir_decimator_split_blocks_match()
+{
+    // 100 samples in odd pieces must give exactly what one call gives:
+    // the leftover of each piece is finished by the next
+    float coefs[16];
+    fir_lowpass(0.1f, coefs, 16);
+    float in[100];
+    for (int i = 0; i < 100; i++) in[i] = (float)((i * 37) % 11);
+
+    FirDecimator whole, split;
+    TEST_ASSERT_TRUE(whole.init(coefs, 16, 4));
+    TEST_ASSERT_TRUE(split.init(coefs, 16, 4));
+
+    float ref[25], got[25];
+    TEST_ASSERT_EQUAL(25, whole.process(in, ref, 100));
+
+    const size_t pieces[] = { 3, 1, 6, 2, 13, 30, 45 };
+    size_t off = 0, n = 0;
+    for (size_t p : pieces) {
+        n += split.process(in + off, got + n, p);
+        off += p;
+    }
+    TEST_ASSERT_EQUAL(100, off);
+    TEST_ASSERT_EQUAL(25, n);
+    for (int i = 0; i < 25; i++) TEST_ASSERT_FLOAT_WITHIN(1e-6f, ref[i], got[i]);
+
+    TEST_ASSERT_EQUAL(0, split.process(in, got, 3));    // short of a block: kept, not dropped
+    TEST_ASSERT_EQUAL(1, split.process(in, got, 1));
+}
+
+void test_fir_lowpass_design()
+{
+    float c[31];
+    TEST_ASSERT_TRUE(fir_lowpass(0.1f, c, 31));
+    float sum = 0;
+    for (int i = 0; i < 31; i++) sum += c[i];
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, 1.0f, sum);
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, c[0], c[30]); // symmetric
+    TEST_ASSERT_FALSE(fir_lowpass(0.6f, c, 31));
+}
+
+void test_init_rejects_bad_sizes()
+{
+    MovingAverage ma;
+    TEST_ASSERT_FALSE(ma.init(0));
+    TEST_ASSERT_FALSE(ma.init(MovingAverage::MAX_WINDOW + 1));
+
+    float c[1] = {1.0f};
+    FirDecimator fir;
+    TEST_ASSERT_FALSE(fir.init(c, 1, 0));
+    TEST_ASSERT_FALSE(fir.init(c, FirDecimator::MAX_TAPS + 1, 1));
+    TEST_ASSERT_FALSE(fir.init(c, 1, FirDecimator::MAX_DECIM + 1));
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_moving_average_step);
+    RUN_TEST(test_moving_average_block_split_matches);
+    RUN_TEST(test_biquad_lowpass_dc_gain);
+    RUN_TEST(test_biquad_attenuates_nyquist);
+    RUN_TEST(test_fir_decimator_impulse_and_count);
+    RUN_TEST(test_fir_decimator_split_blocks_match);
+    RUN_TEST(test_fir_lowpass_design);
+    RUN_TEST(test_init_rejects_bad_sizes);
+    return UNITY_END();
+}
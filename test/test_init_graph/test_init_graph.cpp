@@ -0,0 +1,144 @@
+#include <unity.h>
+#include "init_graph.h"
+
+// Same shape as App::start(): two buses with devices behind them
+struct Boot {
+    InitGraph<16> g;
+    int nvs, i2c, oled, spi, sd, spl06, gpio;
+
+    Boot() {
+        nvs   = g.add("nvs");
+        gpio  = g.add("gpio");
+        i2c   = g.add("i2c", g.dep(nvs), false, 0);
+        oled  = g.add("oled", g.dep(i2c), false, 0);
+        spi   = g.add("spi", 0, false, 1);
+        sd    = g.add("sd", g.dep(spi), false, 1);
+        spl06 = g.add("spl06", g.dep(spi) | g.dep(nvs), false, 1);
+    }
+};
+
+// Runs the graph with one worker per core, each step takes cost[id] ticks.
+// Returns the tick the last step finished.
+template<size_t N>
+static int simulate(InitGraph<N>& g, const int* cost, const bool* fails, int* finish_tick)
+{
+    int busy_id[2] = {-1, -1};
+    int busy_until[2] = {0, 0};
+    int t = 0;
+    while (!g.done()) {
+        for (int c = 0; c < 2; c++) {
+            if (busy_id[c] >= 0 && busy_until[c] <= t) {
+                g.finish(busy_id[c], !fails[busy_id[c]]);
+                finish_tick[busy_id[c]] = t;
+                busy_id[c] = -1;
+            }
+        }
+        for (int c = 0; c < 2; c++) {
+            if (busy_id[c] >= 0) continue;
+            int id = g.claim(c);
+            if (id >= 0) { busy_id[c] = id; busy_until[c] = t + cost[id]; }
+        }
+        t++;
+        TEST_ASSERT_TRUE(t < 1000);
+    }
+    return t - 1;
+}
+
+void test_add_rejects_forward_deps()
+{
+    InitGraph<4> g;
+    int a = g.add("a");
+    TEST_ASSERT_EQUAL(0, a);
+    TEST_ASSERT_EQUAL(-1, g.add("b", g.dep(1)));   // itself
+    TEST_ASSERT_EQUAL(-1, g.add("b", g.dep(3)));   // not added yet
+    TEST_ASSERT_EQUAL(1, g.add("b", g.dep(a)));
+}
+
+void test_claim_respects_deps_and_core()
+{
+    Boot b;
+    // core 1 may only start spi or core-less steps
+    int first = b.g.claim(1);
+    TEST_ASSERT_EQUAL(b.nvs, first);
+    int second = b.g.claim(1);
+    TEST_ASSERT_EQUAL(b.gpio, second);
+    TEST_ASSERT_EQUAL(b.spi, b.g.claim(1));
+    TEST_ASSERT_EQUAL(-1, b.g.claim(1));   // sd/spl06 wait for spi
+    TEST_ASSERT_EQUAL(-1, b.g.claim(0));   // i2c waits for nvs
+
+    b.g.finish(b.nvs, true);
+    TEST_ASSERT_EQUAL(b.i2c, b.g.claim(0));
+    b.g.finish(b.spi, true);
+    TEST_ASSERT_EQUAL(b.sd, b.g.claim(1));
+    TEST_ASSERT_EQUAL(b.spl06, b.g.claim(1));
+}
+
+void test_single_worker_ignores_affinity()
+{
+    Boot b;
+    int order[16];
+    int n = 0;
+    for (int id; (id = b.g.claim(INIT_ANY_CORE)) >= 0;) {
+        order[n++] = id;
+        b.g.finish(id, true);
+    }
+    TEST_ASSERT_EQUAL(7, n);
+    TEST_ASSERT_TRUE(b.g.done());
+    TEST_ASSERT_TRUE(b.g.ok());
+    TEST_ASSERT_EQUAL(b.nvs, order[0]);
+}
+
+void test_branches_run_in_parallel()
+{
+    Boot b;
+    //                nvs gpio i2c oled spi  sd spl06
+    const int cost[] = { 2,  1,  5,  30,  1, 40,  3 };
+    const bool fails[16] = {};
+    int fin[16] = {};
+    int makespan = simulate(b.g, cost, fails, fin);
+
+    TEST_ASSERT_TRUE(b.g.ok());
+    int serial = 0;
+    for (int c : cost) serial += c;
+    TEST_ASSERT_TRUE(makespan < serial * 2 / 3);
+
+    // ordering
+    TEST_ASSERT_TRUE(fin[b.oled] - cost[b.oled] >= fin[b.i2c]);
+    TEST_ASSERT_TRUE(fin[b.sd] - cost[b.sd] >= fin[b.spi]);
+    TEST_ASSERT_TRUE(fin[b.spl06] - cost[b.spl06] >= fin[b.nvs]);
+}
+
+void test_failure_degrades_branch_only()
+{
+    Boot b;
+    const int cost[] = { 1, 1, 1, 1, 1, 1, 1 };
+    bool fails[16] = {};
+    fails[b.spi] = true;
+    int fin[16] = {};
+    simulate(b.g, cost, fails, fin);
+
+    TEST_ASSERT_TRUE(b.g.state(b.spi) == InitState::Failed);
+    TEST_ASSERT_TRUE(b.g.state(b.sd) == InitState::Skipped);
+    TEST_ASSERT_TRUE(b.g.state(b.spl06) == InitState::Skipped);
+    TEST_ASSERT_TRUE(b.g.up(b.oled));
+    TEST_ASSERT_TRUE(b.g.ok());        // spi branch is optional
+
+    Boot r;
+    bool fails2[16] = {};
+    fails2[r.nvs] = true;              // required
+    simulate(r.g, cost, fails2, fin);
+    TEST_ASSERT_FALSE(r.g.ok());
+    TEST_ASSERT_TRUE(r.g.state(r.oled) == InitState::Skipped);   // transitively
+    TEST_ASSERT_TRUE(r.g.up(r.sd));
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_add_rejects_forward_deps);
+    RUN_TEST(test_claim_respects_deps_and_core);
+    RUN_TEST(test_single_worker_ignores_affinity);
+    RUN_TEST(test_branches_run_in_parallel);
+    RUN_TEST(test_failure_degrades_branch_only);
+    return UNITY_END();
+}
@@ -0,0 +1,113 @@
+#include <unity.h>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "line_assembler.h"
+
+struct Capture {
+    std::vector<std::string> lines;
+    std::vector<bool> overflow;
+    std::string echo;
+    int echo_calls = 0;
+};
+
+template<size_t N>
+static void feed(LineAssembler<N>& a, Capture& c, const char* s, size_t chunk = 0)
+{
+    const size_t n = strlen(s);
+    if (!chunk) chunk = n;
+    for (size_t off = 0; off < n; off += chunk) {
+        size_t k = n - off < chunk ? n - off : chunk;
+        a.feed((const uint8_t*)s + off, k,
+               [&](const char* line, size_t len, bool ovf) {
+                   TEST_ASSERT_EQUAL(strlen(line), len);
+                   c.lines.push_back(line);
+                   c.overflow.push_back(ovf);
+               },
+               [&](const char* e, size_t len) { c.echo.append(e, len); c.echo_calls++; });
+    }
+}
+
+void test_line_endings()
+{
+    LineAssembler<64> a;
+    Capture c;
+    feed(a, c, "status\rperiod 100\nfps 5\r\n\r\n\nhelp\n");
+    TEST_ASSERT_EQUAL(4, c.lines.size());
+    TEST_ASSERT_EQUAL_STRING("status", c.lines[0].c_str());
+    TEST_ASSERT_EQUAL_STRING("period 100", c.lines[1].c_str());
+    TEST_ASSERT_EQUAL_STRING("fps 5", c.lines[2].c_str());
+    TEST_ASSERT_EQUAL_STRING("help", c.lines[3].c_str());
+    TEST_ASSERT_EQUAL(0, a.pending());
+}
+
+void test_chunking_does_not_matter()
+{
+    const char* script = "pause on\r\nsensor temp\r\nhistory press 60\r\npause off\r\n";
+    for (size_t chunk = 1; chunk <= 9; chunk++) {
+        LineAssembler<64> a;
+        Capture c;
+        feed(a, c, script, chunk);
+        TEST_ASSERT_EQUAL(4, c.lines.size());
+        TEST_ASSERT_EQUAL_STRING("history press 60", c.lines[2].c_str());
+    }
+
+    // partial line is kept across feeds
+    LineAssembler<64> a;
+    Capture c;
+    feed(a, c, "sta");
+    TEST_ASSERT_EQUAL(0, c.lines.size());
+    TEST_ASSERT_EQUAL(3, a.pending());
+    feed(a, c, "tus\n");
+    TEST_ASSERT_EQUAL_STRING("status", c.lines[0].c_str());
+}
+
+void test_backspace_and_echo()
+{
+    LineAssembler<64> a;
+    Capture c;
+    feed(a, c, "stx\x7F" "atus\b\bus\x01\n");
+    TEST_ASSERT_EQUAL(1, c.lines.size());
+    TEST_ASSERT_EQUAL_STRING("status", c.lines[0].c_str());
+    TEST_ASSERT_EQUAL_STRING("stx\b \batus\b \b\b \bus\r\n", c.echo.c_str());
+
+    // one echo write for the whole chunk, not one per key
+    TEST_ASSERT_EQUAL(1, c.echo_calls);
+}
+
+void test_overflow_drops_rest_of_line()
+{
+    LineAssembler<8> a;
+    Capture c;
+    feed(a, c, "0123456789abc\nok\n");
+    TEST_ASSERT_EQUAL(2, c.lines.size());
+    TEST_ASSERT_TRUE(c.overflow[0]);
+    TEST_ASSERT_EQUAL_STRING("0123456", c.lines[0].c_str());
+    TEST_ASSERT_FALSE(c.overflow[1]);
+    TEST_ASSERT_EQUAL_STRING("ok", c.lines[1].c_str());
+    TEST_ASSERT_EQUAL(1, a.overflows());
+}
+
+void test_long_paste()
+{
+    // a few hundred commands in one buffer, as a script would send them
+    std::string s;
+    for (int i = 0; i < 300; i++) s += "period " + std::to_string(100 + i) + "\r\n";
+    LineAssembler<64> a;
+    Capture c;
+    feed(a, c, s.c_str(), 120);   // UART FIFO sized chunks
+    TEST_ASSERT_EQUAL(300, c.lines.size());
+    TEST_ASSERT_EQUAL_STRING("period 399", c.lines[299].c_str());
+    TEST_ASSERT_EQUAL(300, a.lines());
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_line_endings);
+    RUN_TEST(test_chunking_does_not_matter);
+    RUN_TEST(test_backspace_and_echo);
+    RUN_TEST(test_overflow_drops_rest_of_line);
+    RUN_TEST(test_long_paste);
+    return UNITY_END();
+}
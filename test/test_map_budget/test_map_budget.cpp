@@ -0,0 +1,106 @@
+#include <unity.h>
+#include <sstream>
+#include "map_budget.h"
+
+// Trimmed from a real ESP-IDF firmware.map: wrapped and unwrapped lines,
+// fill, symbols, pattern lines and a debug section at address 0
+static const char* MAP =
+    "Archive member included to satisfy reference by file (symbol)\n"
+    "\n"
+    "Memory Configuration\n"
+    "\n"
+    "Name             Origin             Length             Attributes\n"
+    "iram0_0_seg      0x40080000         0x00020000         xr\n"
+    "dram0_0_seg      0x3ffb0000         0x0002c200         rw\n"
+    "*default*        0x00000000         0xffffffff\n"
+    "\n"
+    "Linker script and memory map\n"
+    "\n"
+    "LOAD /build/esp-idf/main/libmain.a\n"
+    "\n"
+    ".dram0.data     0x3ffb0000      0x120\n"
+    " *(.data .data.*)\n"
+    " .data.s_mux    0x3ffb0000       0x20 /build/esp-idf/main/libmain.a(app.cpp.obj)\n"
+    "                0x3ffb0000                s_mux\n"
+    " .data          0x3ffb0020      0x100 /build/esp-idf/freertos/libfreertos.a(tasks.c.obj)\n"
+    "\n"
+    ".dram0.bss      0x3ffb0120     0x6100\n"
+    " .bss._ZZ4mainE3app\n"
+    "                0x3ffb0120     0x6000 /build/esp-idf/main/libmain.a(main.cpp.obj)\n"
+    " *fill*         0x3ffb6120       0x10 \n"
+    " COMMON         0x3ffb6130       0xf0 /build/esp-idf/main/libmain.a(app.cpp.obj)\n"
+    "\n"
+    ".iram0.text_with_a_very_long_name\n"
+    "                0x40080000     0x2000\n"
+    " .iram1.0       0x40080000     0x2000 /build/esp-idf/freertos/libfreertos.a(port.c.obj)\n"
+    "\n"
+    ".debug_info     0x00000000    0x90000\n"
+    " .debug_info    0x00000000    0x90000 /build/esp-idf/main/libmain.a(app.cpp.obj)\n"
+    "OUTPUT(firmware.elf elf32-xtensa-le)\n";
+
+static MapFile parse()
+{
+    std::istringstream in(MAP);
+    MapFile mf;
+    TEST_ASSERT_TRUE(map_parse(in, &mf));
+    return mf;
+}
+
+void test_regions_and_sections()
+{
+    MapFile mf = parse();
+    TEST_ASSERT_EQUAL(2, (int)mf.regions.size());
+    TEST_ASSERT_EQUAL(4, (int)mf.sections.size());
+
+    const MapSection* bss = mf.section(".dram0.bss");
+    TEST_ASSERT_NOT_NULL(bss);
+    TEST_ASSERT_EQUAL_UINT32(0x6100, (uint32_t)bss->size);
+
+    const MapSection* iram = mf.section(".iram0.text_with_a_very_long_name");   // wrapped line
+    TEST_ASSERT_NOT_NULL(iram);
+    TEST_ASSERT_EQUAL_UINT32(0x2000, (uint32_t)iram->size);
+
+    // debug section at 0 counts nowhere
+    TEST_ASSERT_EQUAL_UINT32(0x120 + 0x6100, (uint32_t)mf.region("dram0_0_seg")->used);
+    TEST_ASSERT_EQUAL_UINT32(0x2000, (uint32_t)mf.region("iram0_0_seg")->used);
+}
+
+void test_objects()
+{
+    MapFile mf = parse();
+    auto top = mf.top_objects(".dram0.bss", 10);
+    TEST_ASSERT_EQUAL(3, (int)top.size());
+    TEST_ASSERT_EQUAL_STRING("libmain.a(main.cpp.obj)", top[0].first.c_str());   // wrapped input line
+    TEST_ASSERT_EQUAL_UINT32(0x6000, (uint32_t)top[0].second);
+    TEST_ASSERT_EQUAL_STRING("libmain.a(app.cpp.obj)", top[1].first.c_str());
+    TEST_ASSERT_EQUAL_STRING("*fill*", top[2].first.c_str());
+
+    auto data = mf.top_objects(".dram0.data", 1);
+    TEST_ASSERT_EQUAL(1, (int)data.size());
+    TEST_ASSERT_EQUAL_STRING("libfreertos.a(tasks.c.obj)", data[0].first.c_str());
+    TEST_ASSERT_EQUAL_STRING("foo.o", map_object_name("/a/b/foo.o").c_str());
+}
+
+void test_budgets()
+{
+    MapFile mf = parse();
+    std::string r;
+    TEST_ASSERT_TRUE(map_check(mf, "dram0_0_seg=15%", &r));         // 0x6220 of 0x2c200 is ~13.9 %
+    TEST_ASSERT_FALSE(map_check(mf, "dram0_0_seg=13%", &r));
+    TEST_ASSERT_TRUE(map_check(mf, ".dram0.bss=25K", &r));
+    TEST_ASSERT_FALSE(map_check(mf, ".dram0.bss=24K", &r));
+    TEST_ASSERT_TRUE(r.find("OVER by 256 B") != std::string::npos);
+    TEST_ASSERT_FALSE(map_check(mf, ".dram0.bss=5%", &r));           // % needs a region
+    TEST_ASSERT_FALSE(map_check(mf, "flash=1K", &r));
+    TEST_ASSERT_FALSE(map_check(mf, "dram0_0_seg", &r));
+    TEST_ASSERT_FALSE(map_check(mf, "dram0_0_seg=12x", &r));
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_regions_and_sections);
+    RUN_TEST(test_objects);
+    RUN_TEST(test_budgets);
+    return UNITY_END();
+}
@@ -0,0 +1,121 @@
+#include <unity.h>
+#include <cmath>
+#include "rollup_store.h"
+
+static SensorRecord rec(uint32_t t_ms, float temp)
+{
+    return SensorRecord{t_ms, temp, 50.0f, 1000.0f, 100.0f, 2048.0f};
+}
+
+// small tiers so tests cross every boundary quickly
+using SmallStore = RollupStore<8, 120, 10>;
+
+void test_raw_window_exact()
+{
+    static SmallStore st;
+    for (uint32_t i = 0; i < 5; i++) st.push(rec(1000 + i * 100, (float)i));
+
+    StatAgg a = st.query(SensorChannel::TempC, 1400, 250); // t=1200,1300,1400
+    TEST_ASSERT_EQUAL(3, a.n);
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, 3.0f, a.mean);
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, 2.0f, a.min);
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, 4.0f, a.max);
+}
+
+void test_second_tier_means()
+{
+    static SmallStore st;
+    // 4 samples per second for 30 s, temp = second number
+    for (uint32_t s = 0; s < 30; s++) {
+        for (uint32_t k = 0; k < 4; k++) st.push(rec(s * 1000 + k * 250, (float)s));
+    }
+    // raw only holds the last 2 s, a 10 s window must come from the second tier
+    StatAgg a = st.query(SensorChannel::TempC, 29999, 10000);
+    TEST_ASSERT_EQUAL(40, a.n);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 24.5f, a.mean);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 20.0f, a.min);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 29.0f, a.max);
+
+    float ser[5];
+    TEST_ASSERT_EQUAL(5, st.series(SensorChannel::TempC, RollupTier::Second, 29999, ser, 5));
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 25.0f, ser[0]);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 29.0f, ser[4]);
+}
+
+void test_sub_ms_counts_weigh_right()
+{
+    static SmallStore st;
+    // 4000 samples/s (250 us period) at 10.0, then 100 at 0.0 in the next
+    // second: both seconds and the minute must weigh by the real counts
+    for (uint32_t k = 0; k < 4000; k++) st.push(rec(k / 4, 10.0f));
+    for (uint32_t k = 0; k < 100; k++) st.push(rec(1000 + k, 0.0f));
+    st.push(rec(2000, 0.0f));                           // closes second 1
+
+    StatAgg a = st.query(SensorChannel::TempC, 1999, 2000);    // raw holds 8, second tier
+    TEST_ASSERT_EQUAL(4100, a.n);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 40000.0f / 4100.0f, a.mean);
+
+    for (uint32_t s = 3; s < 60; s++) st.push(rec(s * 1000, 0.0f));
+    st.push(rec(60000, 0.0f));                          // closes minute 0
+    StatAgg mn = st.query(SensorChannel::TempC, 60000, 180000);  // > SEC_N s: minute tier
+    TEST_ASSERT_EQUAL(4000 + 101 + 57 + 1, mn.n);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 40000.0f / 4159.0f, mn.mean);
+}
+
+void test_minute_tier_and_gaps()
+{
+    static SmallStore st;
+    // one sample every 10 s for 5 minutes, except minute 2 is missing
+    for (uint32_t t = 0; t < 300; t += 10) {
+        if (t / 60 == 2) continue;
+        st.push(rec(t * 1000, (float)(t / 60)));
+    }
+    StatAgg a = st.query(SensorChannel::TempC, 299000, 300000);
+    TEST_ASSERT_EQUAL(24, a.n);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 0.0f, a.min);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 4.0f, a.max);
+
+    float ser[5];
+    st.series(SensorChannel::TempC, RollupTier::Minute, 299000, ser, 5);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 1.0f, ser[1]);
+    TEST_ASSERT_TRUE(std::isnan(ser[2]));
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 4.0f, ser[4]);
+}
+
+void test_old_slots_expire()
+{
+    static SmallStore st;
+    st.push(rec(0, 99.0f));
+    for (uint32_t i = 0; i < 10; i++) st.push(rec(200000 + i * 1000, 1.0f));
+
+    // second tier slot 0 % 120 would alias with 120 s / 240 s, stamps reject it
+    StatAgg a = st.query(SensorChannel::TempC, 209000, 100000);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 1.0f, a.max);
+}
+
+void test_quantization_and_budget()
+{
+    TEST_ASSERT_FLOAT_WITHIN(0.05f, 1013.25f, rollup_dq(SensorChannel::PressureHpa, rollup_q(SensorChannel::PressureHpa, 1013.25f)));
+    TEST_ASSERT_EQUAL(32767, rollup_q(SensorChannel::TempC, 1e6f));
+
+    constexpr auto b = DeviceRollup::budget();
+    TEST_ASSERT_TRUE(b.total >= b.raw + b.second + b.minute);
+    TEST_ASSERT_TRUE(b.total <= ROLLUP_BUDGET_BYTES);
+
+    // the longest 'history' window is answered from the minute tier
+    static DeviceRollup dr;
+    SensorRecord r{};
+    for (uint32_t s = 0; s <= HISTORY_MAX_S; s += 60) { r.timestamp_ms = s * 1000; r.temp_c = 1.0f; dr.push(r); }
+    TEST_ASSERT_EQUAL_UINT32(HISTORY_MAX_S / 60, dr.query(SensorChannel::TempC, HISTORY_MAX_S * 1000, HISTORY_MAX_S * 1000).n);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_raw_window_exact);
+    RUN_TEST(test_second_tier_means);
+    RUN_TEST(test_sub_ms_counts_weigh_right);
+    RUN_TEST(test_minute_tier_and_gaps);
+    RUN_TEST(test_old_slots_expire);
+    RUN_TEST(test_quantization_and_budget);
+    return UNITY_END();
+}
@@ -0,0 +1,83 @@
+#include <unity.h>
+#include "sample_batch.h"
+
+static SensorRecord rec(uint32_t t, float base)
+{
+    return SensorRecord{t, base, base + 1, base + 2, base + 3, base + 4};
+}
+
+void test_push_is_columnar()
+{
+    SampleBatch<4> b;
+    TEST_ASSERT_TRUE(b.empty());
+    TEST_ASSERT_TRUE(b.push(10, rec(100, 1.0f)));
+    TEST_ASSERT_TRUE(b.push(11, rec(200, 10.0f)));
+
+    TEST_ASSERT_EQUAL(2, b.len);
+    TEST_ASSERT_EQUAL(10, b.first_count);
+    TEST_ASSERT_EQUAL(11, b.last_count());
+
+    const float* p = b.channel(SensorChannel::PressureHpa);
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, 3.0f, p[0]);
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, 12.0f, p[1]);
+    TEST_ASSERT_EQUAL(200, b.timestamp_ms[1]);
+}
+
+void test_full_and_clear()
+{
+    SampleBatch<2> b;
+    TEST_ASSERT_TRUE(b.push(0, rec(0, 0)));
+    TEST_ASSERT_TRUE(b.push(1, rec(1, 0)));
+    TEST_ASSERT_TRUE(b.full());
+    TEST_ASSERT_FALSE(b.push(2, rec(2, 0)));
+
+    b.clear();
+    TEST_ASSERT_TRUE(b.empty());
+    TEST_ASSERT_TRUE(b.push(7, rec(5, 0)));
+    TEST_ASSERT_EQUAL(7, b.first_count);
+}
+
+void test_round_trip_and_age()
+{
+    SampleBatch<4> b;
+    b.push(1, rec(1000, 20.5f));
+    b.push(2, rec(1500, 21.5f));
+
+    SensorRecord r = b.at(1);
+    TEST_ASSERT_EQUAL(1500, r.timestamp_ms);
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, 21.5f, r.temp_c);
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, 25.5f, r.adc);
+    TEST_ASSERT_EQUAL(700, b.age_ms(1700));
+}
+
+void test_drain_summary()
+{
+    DrainSummary d;
+    TEST_ASSERT_TRUE(d.empty());
+
+    SampleBatch<4> a, b, empty;
+    for (uint32_t i = 0; i < 4; i++) a.push(100 + i, rec(1000 + i, 0));
+    for (uint32_t i = 0; i < 2; i++) b.push(104 + i, rec(1004 + i, 0));
+    d.add(a, 350);
+    d.add(empty, 1);                    // nothing in it, ignored
+    d.add(b, 90);
+
+    LogEvent ev = d.event();
+    TEST_ASSERT_EQUAL((int)LogType::RECEIVED, (int)ev.type);
+    TEST_ASSERT_EQUAL(100, ev.count);
+    TEST_ASSERT_EQUAL_UINT32(105, ev.last_count);
+    TEST_ASSERT_EQUAL_UINT32(1000, ev.timestamp_ms);
+    TEST_ASSERT_EQUAL(6, ev.samples);
+    TEST_ASSERT_EQUAL(2, ev.batches);
+    TEST_ASSERT_EQUAL_UINT32(90, ev.lat_min_us);
+    TEST_ASSERT_EQUAL_UINT32(350, ev.lat_max_us);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_push_is_columnar);
+    RUN_TEST(test_full_and_clear);
+    RUN_TEST(test_round_trip_and_age);
+    RUN_TEST(test_drain_summary);
+    return UNITY_END();
+}
@@ -0,0 +1,144 @@
+#include <unity.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+// count back-offs; on target this is the sleep that lets a preempted writer run
+static std::atomic<uint32_t> g_backoffs{0};
+#define SEQLOCK_BACKOFF() (g_backoffs++, std::this_thread::yield())
+#include "seqlock_store.h"
+
+struct Cfg {
+    uint32_t period_ms;
+    float sea_level_hpa;
+    uint32_t fps;
+    uint8_t flag;           // odd size on purpose, last word is padded
+};
+
+void test_load_store_version()
+{
+    SeqlockStore<Cfg> s(Cfg{ 2000, 1013.25f, 5, 1 });
+    TEST_ASSERT_EQUAL_UINT32(1, s.version());
+
+    Cfg c = s.load();
+    TEST_ASSERT_EQUAL_UINT32(2000, c.period_ms);
+    TEST_ASSERT_EQUAL_FLOAT(1013.25f, c.sea_level_hpa);
+    TEST_ASSERT_EQUAL(1, c.flag);
+
+    s.update([](Cfg& v) { v.fps = 30; });
+    TEST_ASSERT_EQUAL_UINT32(2, s.version());
+    c = s.load();
+    TEST_ASSERT_EQUAL_UINT32(30, c.fps);
+    TEST_ASSERT_EQUAL_UINT32(2000, c.period_ms);      // rest untouched
+}
+
+void test_load_if_changed()
+{
+    SeqlockStore<Cfg> s(Cfg{ 100, 1000.0f, 5, 0 });
+    uint32_t seen = 0;
+    Cfg c{};
+    TEST_ASSERT_TRUE(s.load_if_changed(&seen, &c));
+    TEST_ASSERT_EQUAL_UINT32(100, c.period_ms);
+    TEST_ASSERT_FALSE(s.load_if_changed(&seen, &c));
+
+    s.update([](Cfg& v) { v.period_ms = 250; });
+    TEST_ASSERT_TRUE(s.load_if_changed(&seen, &c));
+    TEST_ASSERT_EQUAL_UINT32(250, c.period_ms);
+    TEST_ASSERT_EQUAL_UINT32(s.version(), seen);
+}
+
+void test_readers_never_see_torn_writes()
+{
+    // every published value keeps fps == period_ms * 3 and sea level == period_ms
+    SeqlockStore<Cfg> s(Cfg{ 1, 1.0f, 3, 0 });
+    std::atomic<bool> done{false};
+    std::atomic<uint32_t> torn{0}, reads{0};
+
+    auto reader = [&] {
+        while (!done.load()) {
+            Cfg c = s.load();
+            if (c.fps != c.period_ms * 3 || c.sea_level_hpa != (float)c.period_ms) torn++;
+            reads++;
+        }
+    };
+    auto writer = [&](uint32_t base) {
+        for (uint32_t i = 1; i <= 20000; i++) {
+            s.update([&](Cfg& v) {
+                v.period_ms = base + i;
+                v.sea_level_hpa = (float)(base + i);
+                v.fps = (base + i) * 3;
+            });
+        }
+    };
+
+    std::thread r1(reader), r2(reader);
+    std::thread w1(writer, 0u), w2(writer, 1000000u);   // writers serialise on the sequence
+    w1.join();
+    w2.join();
+    done = true;
+    r1.join();
+    r2.join();
+
+    TEST_ASSERT_EQUAL_UINT32(0, torn.load());
+    TEST_ASSERT_GREATER_THAN(0, reads.load());
+    TEST_ASSERT_EQUAL_UINT32(1 + 40000, s.version());
+}
+
+void test_reader_backs_off_for_stalled_writer()
+{
+    // The writer is "preempted" mid-update: it holds the odd sequence until
+    // the reader backs off, the point where a same-core writer gets the CPU.
+    // A reader that only spins never gets there and the writer gives up.
+    SeqlockStore<Cfg> s(Cfg{ 10, 10.0f, 30, 0 });
+    g_backoffs = 0;
+    std::atomic<bool> in_update{false}, writer_resumed{false};
+
+    std::thread w([&] {
+        s.update([&](Cfg& v) {
+            in_update = true;
+            const auto give_up = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+            while (g_backoffs.load() == 0 && std::chrono::steady_clock::now() < give_up) {}
+            writer_resumed = g_backoffs.load() > 0;
+            v.period_ms = 20;
+            v.sea_level_hpa = 20.0f;
+            v.fps = 60;
+        });
+    });
+    while (!in_update) {}
+
+    Cfg c = s.load();                   // blocks behind the writer, backing off
+    w.join();
+
+    TEST_ASSERT_TRUE(writer_resumed.load());
+    TEST_ASSERT_GREATER_THAN(0, g_backoffs.load());
+    TEST_ASSERT_EQUAL_UINT32(20, c.period_ms);
+    TEST_ASSERT_EQUAL_UINT32(60, c.fps);
+    TEST_ASSERT_EQUAL_UINT32(2, s.version());
+
+    // a second writer waits the same way
+    g_backoffs = 0;
+    in_update = false;
+    std::thread w2([&] {
+        s.update([&](Cfg& v) {
+            in_update = true;
+            const auto give_up = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+            while (g_backoffs.load() == 0 && std::chrono::steady_clock::now() < give_up) {}
+            v.fps = 90;
+        });
+    });
+    while (!in_update) {}
+    s.update([](Cfg& v) { v.fps += 1; });
+    w2.join();
+    TEST_ASSERT_GREATER_THAN(0, g_backoffs.load());
+    TEST_ASSERT_EQUAL_UINT32(91, s.load().fps);
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_load_store_version);
+    RUN_TEST(test_load_if_changed);
+    RUN_TEST(test_readers_never_see_torn_writes);
+    RUN_TEST(test_reader_backs_off_for_stalled_writer);
+    return UNITY_END();
+}
@@ -0,0 +1,121 @@
+#include <unity.h>
+#include <cstring>
+#include "ssd1306_display.h"
+
+// Records every write so tests can check what would go on the bus
+class RecordingTransport : public Ssd1306Transport {
+public:
+    bool write(uint8_t control, const uint8_t* bytes, size_t n) override {
+        if (writes < 64) {
+            ctrl[writes] = control;
+            len[writes] = n;
+            memcpy(data[writes], bytes, n < 132 ? n : 132);
+        }
+        writes++;
+        return true;
+    }
+    void reset() { writes = 0; }
+    uint32_t fail_epoch() const override { return fails; }
+
+    size_t writes = 0;
+    uint32_t fails = 0;     // bumped by tests: an accepted write failed later
+    uint8_t ctrl[64];
+    size_t len[64];
+    uint8_t data[64][132];
+};
+
+void test_clear_panel_then_no_changes()
+{
+    static RecordingTransport t;
+    static Ssd1306Display d(t);
+    TEST_ASSERT_TRUE(d.clear_panel());
+    TEST_ASSERT_EQUAL(1 + 8, t.writes); // window + 8 pages
+
+    t.reset();
+    TEST_ASSERT_TRUE(d.flush());
+    TEST_ASSERT_EQUAL(0, t.writes);
+    TEST_ASSERT_EQUAL(0, d.stats().bytes_last);
+}
+
+void test_text_sends_only_changed_columns()
+{
+    static RecordingTransport t;
+    static Ssd1306Display d(t);
+    d.clear_panel();
+    t.reset();
+
+    d.draw_text(12, 3, "T:1");   // columns 12..29 on page 3
+    TEST_ASSERT_TRUE(d.flush());
+    TEST_ASSERT_EQUAL(2, t.writes);
+
+    // window command: columns trimmed to non-zero glyph columns, page 3 only
+    TEST_ASSERT_EQUAL(0x00, t.ctrl[0]);
+    TEST_ASSERT_EQUAL(0x21, t.data[0][0]);
+    TEST_ASSERT_EQUAL(12, t.data[0][1]);
+    TEST_ASSERT_EQUAL(3, t.data[0][4]);
+    TEST_ASSERT_EQUAL(3, t.data[0][5]);
+    TEST_ASSERT_EQUAL(0x40, t.ctrl[1]);
+    TEST_ASSERT_EQUAL(t.data[0][2] - t.data[0][1] + 1, t.len[1]);
+    TEST_ASSERT_EQUAL(1, d.stats().pages_last);
+
+    // redraw the same thing after a clear: nothing changed on the panel
+    t.reset();
+    d.clear();
+    d.draw_text(12, 3, "T:1");
+    d.flush();
+    TEST_ASSERT_EQUAL(0, t.writes);
+}
+
+void test_pixels_and_invalidate()
+{
+    static RecordingTransport t;
+    static Ssd1306Display d(t);
+    d.clear_panel();
+
+    d.set_pixel(5, 9, true);   // page 1, bit 1
+    TEST_ASSERT_EQUAL(0x02, d.buffer()[128 + 5]);
+    d.vline(0, 0, 16);
+    TEST_ASSERT_EQUAL(0xFF, d.buffer()[0]);
+    TEST_ASSERT_EQUAL(0xFF, d.buffer()[128]);
+    d.set_pixel(200, 200, true); // clipped
+
+    t.reset();
+    d.flush();
+    TEST_ASSERT_EQUAL(4, t.writes); // two pages, window + data each
+
+    t.reset();
+    d.invalidate();
+    d.flush();
+    TEST_ASSERT_EQUAL(16, t.writes);
+    TEST_ASSERT_EQUAL(8 * (2 + 6) + 8 * (2 + 128), d.stats().bytes_last);
+}
+
+void test_late_failure_resends_frame()
+{
+    static RecordingTransport t;
+    static Ssd1306Display d(t);
+    d.clear_panel();
+    d.draw_text(0, 2, "A");
+    d.flush();
+
+    // the bus task reports the chunk lost after flush() had queued it
+    t.fails++;
+    TEST_ASSERT_TRUE(d.stale());
+    t.reset();
+    d.flush();
+    TEST_ASSERT_EQUAL(16, t.writes);    // all 8 pages, the shadow is not trusted
+    TEST_ASSERT_FALSE(d.stale());
+
+    t.reset();
+    d.flush();
+    TEST_ASSERT_EQUAL(0, t.writes);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_clear_panel_then_no_changes);
+    RUN_TEST(test_text_sends_only_changed_columns);
+    RUN_TEST(test_pixels_and_invalidate);
+    RUN_TEST(test_late_failure_resends_frame);
+    return UNITY_END();
+}
@@ -0,0 +1,145 @@
+#include <unity.h>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include "ssd1306_sim.h"
+#include "ssd1306_display.h"
+#include "strip_chart.h"
+
+static void print_cost(const char* what, const SimCounters& c)
+{
+    char msg[160];
+    snprintf(msg, sizeof(msg), "%-22s tx=%4u bytes=%5u  %8.1f us @100k  %7.1f us @400k",
+             what, (unsigned)c.transactions, (unsigned)c.bytes,
+             Ssd1306Sim::bus_us(c, 100000), Ssd1306Sim::bus_us(c, 400000));
+    TEST_MESSAGE(msg);
+}
+
+void test_init_and_clear_follow_datasheet()
+{
+    static Ssd1306Sim sim;
+    static Ssd1306Display d(sim);
+
+    TEST_ASSERT_TRUE(d.init());
+    TEST_ASSERT_TRUE(sim.display_on());
+    TEST_ASSERT_TRUE(sim.mode() == Ssd1306Sim::AddrMode::Horizontal);
+    TEST_ASSERT_EQUAL(0, sim.unknown_cmds());
+
+    TEST_ASSERT_TRUE(d.clear_panel());
+    for (int i = 0; i < 1024; i++) TEST_ASSERT_EQUAL(0, sim.ram()[i]);
+}
+
+void test_panel_matches_framebuffer()
+{
+    static Ssd1306Sim sim;
+    static Ssd1306Display d(sim);
+    d.init();
+    d.clear_panel();
+
+    d.draw_text_2x(0, 0, "21.5C");
+    d.draw_text(0, 3, "RH 45%  1013hPa");
+    d.fill_rect(100, 40, 10, 10);
+    d.flush();
+    TEST_ASSERT_EQUAL_MEMORY(d.buffer(), sim.ram(), 1024);
+
+    // partial update lands in the right place
+    d.draw_text(0, 3, "RH 46%");
+    d.flush();
+    TEST_ASSERT_EQUAL_MEMORY(d.buffer(), sim.ram(), 1024);
+
+    // with A1/C8 from init() the panel shows GDDRAM unmirrored
+    for (int x = 0; x < 128; x++)
+        for (int y = 0; y < 64; y++)
+            TEST_ASSERT_EQUAL((d.buffer()[(y >> 3) * 128 + x] >> (y & 7)) & 1, sim.pixel(x, y));
+
+    if (const char* path = getenv("SSD1306_SIM_PBM")) TEST_ASSERT_TRUE(sim.save_pbm(path));
+}
+
+void test_feed_raw_transactions()
+{
+    static Ssd1306Sim sim;
+    // Co = 1 pairs: set column window 4..5 and page 2..2, then a data stream
+    const uint8_t cmds[] = {0x80, 0x20, 0x80, 0x00, 0x80, 0x21, 0x80, 0x04, 0x80, 0x05,
+                            0x80, 0x22, 0x80, 0x02, 0x00, 0x02};
+    TEST_ASSERT_TRUE(sim.feed(cmds, sizeof(cmds)));
+    const uint8_t data[] = {0x40, 0x11, 0x22, 0x33};
+    TEST_ASSERT_TRUE(sim.feed(data, sizeof(data)));
+
+    TEST_ASSERT_EQUAL_HEX8(0x22, sim.ram()[2 * 128 + 5]);
+    TEST_ASSERT_EQUAL_HEX8(0x33, sim.ram()[2 * 128 + 4]);  // wrapped in the window
+    TEST_ASSERT_EQUAL(2, sim.counters().transactions);
+    TEST_ASSERT_EQUAL(3, sim.counters().data_bytes);
+}
+
+void test_bus_time()
+{
+    SimCounters c{};
+    c.transactions = 1;
+    c.bytes = 1026;     // one full frame in a single write
+    // ~23 ms at 400 kHz, ~92 ms at 100 kHz
+    TEST_ASSERT_TRUE(Ssd1306Sim::bus_us(c, 400000) > 23000 && Ssd1306Sim::bus_us(c, 400000) < 23200);
+    TEST_ASSERT_TRUE(Ssd1306Sim::bus_us(c, 100000) > 92000 && Ssd1306Sim::bus_us(c, 100000) < 92800);
+}
+
+// Cost of the refresh strategies the firmware can use, for one value change
+void test_refresh_strategy_cost()
+{
+    static Ssd1306Sim sim;
+    static Ssd1306Display d(sim);
+    d.init();
+    d.clear_panel();
+    d.draw_text_2x(0, 0, "21.5C");
+    d.draw_text(0, 3, "RH 45%  1013hPa");
+    d.flush();
+
+    // full frame resend
+    sim.reset_counters();
+    d.invalidate();
+    d.flush();
+    SimCounters full = sim.counters();
+    print_cost("full frame", full);
+
+    // clear + redraw everything, dirty pages trimmed by the shadow copy
+    sim.reset_counters();
+    d.clear();
+    d.draw_text_2x(0, 0, "21.6C");
+    d.draw_text(0, 3, "RH 45%  1013hPa");
+    d.flush();
+    SimCounters redraw = sim.counters();
+    print_cost("redraw, diffed", redraw);
+
+    // only the changed text drawn
+    sim.reset_counters();
+    d.draw_text(0, 3, "RH 46%");
+    d.flush();
+    SimCounters text = sim.counters();
+    print_cost("one field", text);
+
+    // one strip chart sample
+    StripChart chart(0, 5, 128, 3);
+    chart.set_range(1000.0f, 1020.0f);
+    chart.push(d, 1010.0f);
+    d.flush();
+    sim.reset_counters();
+    chart.push(d, 1011.0f);
+    d.flush();
+    SimCounters col = sim.counters();
+    print_cost("chart sample", col);
+
+    TEST_ASSERT_EQUAL_MEMORY(d.buffer(), sim.ram(), 1024);
+    TEST_ASSERT_TRUE(full.bytes > 1024);
+    TEST_ASSERT_TRUE(redraw.bytes < full.bytes / 4);
+    TEST_ASSERT_TRUE(text.bytes < redraw.bytes);
+    TEST_ASSERT_TRUE(col.data_bytes <= 6);
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_init_and_clear_follow_datasheet);
+    RUN_TEST(test_panel_matches_framebuffer);
+    RUN_TEST(test_feed_raw_transactions);
+    RUN_TEST(test_bus_time);
+    RUN_TEST(test_refresh_strategy_cost);
+    return UNITY_END();
+}
@@ -0,0 +1,156 @@
+#include <unity.h>
+#include <cstring>
+#include "strip_chart.h"
+
+// Counts data bytes per flush, that is what a chart update costs on the bus
+class CountingTransport : public Ssd1306Transport {
+public:
+    bool write(uint8_t control, const uint8_t* bytes, size_t n) override {
+        (void)bytes;
+        if (control == 0x40) data_bytes += n;
+        return true;
+    }
+    size_t data_bytes = 0;
+};
+
+static bool pixel(const Ssd1306Display& d, int x, int y) {
+    return (d.buffer()[(y >> 3) * Ssd1306Display::WIDTH + x] >> (y & 7)) & 1;
+}
+
+void test_fixed_range_maps_rows()
+{
+    static CountingTransport t;
+    static Ssd1306Display d(t);
+    StripChart c(0, 6, 128, 2);   // 16 rows
+    c.set_range(0.0f, 15.0f);
+
+    c.push(d, 15.0f);   // top row
+    TEST_ASSERT_TRUE(pixel(d, 0, 48));
+    c.push(d, 15.0f);
+    TEST_ASSERT_TRUE(pixel(d, 1, 48));
+    c.push(d, 0.0f);    // bottom row, connected to the previous sample
+    for (int y = 48; y < 64; y++) TEST_ASSERT_TRUE(pixel(d, 2, y));
+    TEST_ASSERT_EQUAL(3, c.head());
+
+    // out of range clamps
+    c.push(d, 100.0f);
+    TEST_ASSERT_TRUE(pixel(d, 3, 48));
+}
+
+void test_pages_clamped_to_panel()
+{
+    static CountingTransport t;
+    static Ssd1306Display d(t);
+
+    // more pages than the panel has: the chart ends at the last page
+    StripChart c(0, 6, 128, 12);
+    TEST_ASSERT_EQUAL(2, c.pages());
+    c.set_range(0.0f, 15.0f);
+    c.push(d, 0.0f);
+    TEST_ASSERT_TRUE(pixel(d, 0, 63));
+
+    StripChart full(0, 0, 128, 40);
+    TEST_ASSERT_EQUAL(StripChart::MAX_PAGES, full.pages());
+    full.set_range(0.0f, 63.0f);
+    full.push(d, 0.0f);
+    TEST_ASSERT_TRUE(pixel(d, 0, 63));
+    TEST_ASSERT_EQUAL(1, StripChart(0, 3, 128, 0).pages());
+}
+
+void test_columns_clamped_to_panel()
+{
+    static CountingTransport t;
+    static Ssd1306Display d(t);
+    const uint8_t* fb = d.buffer();
+
+    // would end at column 137: stops at the right edge instead
+    StripChart c(10, 5, 128, 3);
+    TEST_ASSERT_EQUAL(10, c.x());
+    TEST_ASSERT_EQUAL(Ssd1306Display::WIDTH - 10, c.width());
+    c.set_range(0.0f, 23.0f);
+    for (int i = 0; i < 200; i++) c.push(d, (float)(i % 24));
+    for (int p = 0; p < 5; p++)
+        for (int x = 0; x < Ssd1306Display::WIDTH; x++) TEST_ASSERT_EQUAL_HEX8(0, fb[p * Ssd1306Display::WIDTH + x]);
+    for (int p = 5; p < 8; p++)
+        for (int x = 0; x < 10; x++) TEST_ASSERT_EQUAL_HEX8(0, fb[p * Ssd1306Display::WIDTH + x]);
+
+    StripChart left(-20, 0, 64, 1);
+    TEST_ASSERT_EQUAL(0, left.x());
+    TEST_ASSERT_EQUAL(64, left.width());
+
+    StripChart right(200, 0, 64, 1);
+    TEST_ASSERT_EQUAL(Ssd1306Display::WIDTH - 2, right.x());
+    TEST_ASSERT_EQUAL(2, right.width());
+}
+
+void test_each_sample_sends_two_columns()
+{
+    static CountingTransport t;
+    static Ssd1306Display d(t);
+    d.clear_panel();
+
+    StripChart c(0, 5, 128, 3);
+    c.set_range(1000.0f, 1020.0f);
+
+    for (int i = 0; i < 300; i++) {
+        c.push(d, 1010.0f + (float)(i % 7));
+        t.data_bytes = 0;
+        d.flush();
+        // new column + cursor column on each of the 3 pages, at most. On the
+        // wrap they are at opposite edges and the page window spans the width.
+        if (c.head() != 0) TEST_ASSERT_TRUE(t.data_bytes <= 2 * 3);
+    }
+    TEST_ASSERT_EQUAL(300 % 128, c.head());
+    TEST_ASSERT_EQUAL(128, c.count());
+    TEST_ASSERT_EQUAL(0, c.redraws());
+}
+
+void test_autoscale_expands_and_repaints()
+{
+    static CountingTransport t;
+    static Ssd1306Display d(t);
+    StripChart c(0, 6, 64, 2);
+    c.set_autoscale(0.5f);
+
+    for (int i = 0; i < 10; i++) c.push(d, 20.0f);
+    TEST_ASSERT_TRUE(c.lo() < 20.0f && c.hi() > 20.0f);
+    TEST_ASSERT_TRUE(c.hi() - c.lo() >= 0.5f);
+    uint32_t r = c.redraws();
+
+    // jump out of the range: rescale + repaint, new value still on screen
+    c.push(d, 30.0f);
+    TEST_ASSERT_TRUE(c.redraws() > r);
+    TEST_ASSERT_TRUE(c.hi() >= 30.0f);
+    TEST_ASSERT_TRUE(c.lo() <= 20.0f);
+
+    // in range again: no repaint
+    r = c.redraws();
+    c.push(d, 25.0f);
+    TEST_ASSERT_EQUAL(r, c.redraws());
+}
+
+void test_autoscale_shrinks_after_sweep()
+{
+    static CountingTransport t;
+    static Ssd1306Display d(t);
+    StripChart c(0, 6, 32, 2);
+    c.set_autoscale(0.5f);
+
+    c.push(d, 0.0f);
+    c.push(d, 100.0f);
+    float wide = c.hi() - c.lo();
+    for (int i = 0; i < 64; i++) c.push(d, 50.0f);
+    TEST_ASSERT_TRUE(c.hi() - c.lo() < wide / 10.0f);
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_fixed_range_maps_rows);
+    RUN_TEST(test_pages_clamped_to_panel);
+    RUN_TEST(test_columns_clamped_to_panel);
+    RUN_TEST(test_each_sample_sends_two_columns);
+    RUN_TEST(test_autoscale_expands_and_repaints);
+    RUN_TEST(test_autoscale_shrinks_after_sweep);
+    return UNITY_END();
+}
@@ -0,0 +1,134 @@
+#include <unity.h>
+#include "task_stats.h"
+
+void test_first_update_has_no_window()
+{
+    TaskCpuTracker<8> t;
+    TaskSample s[2] = { { 1, "IDLE0", 500000, 800, 0, 0 }, { 2, "producer", 1000, 600, 3, 1 } };
+    uint16_t pm[2] = { 7, 7 };
+    TEST_ASSERT_EQUAL_UINT32(0, t.update(s, 2, 1000000, pm));
+    TEST_ASSERT_EQUAL(0, pm[0]);
+    TEST_ASSERT_EQUAL(0, pm[1]);
+}
+
+void test_share_over_window()
+{
+    TaskCpuTracker<8> t;
+    uint16_t pm[3];
+    TaskSample a[2] = { { 1, "IDLE0", 500000, 800, 0, 0 }, { 2, "producer", 1000, 600, 3, 1 } };
+    t.update(a, 2, 1000000, pm);
+
+    // 1 s later: idle ran 0.9 s, producer 50 ms, a new task 10 ms
+    TaskSample b[3] = { { 1, "IDLE0", 1400000, 800, 0, 0 }, { 2, "producer", 51000, 600, 3, 1 },
+                        { 9, "stream", 10000, 1200, 2, 0 } };
+    TEST_ASSERT_EQUAL_UINT32(1000000, t.update(b, 3, 2000000, pm));
+    TEST_ASSERT_EQUAL(900, pm[0]);
+    TEST_ASSERT_EQUAL(50, pm[1]);
+    TEST_ASSERT_EQUAL(10, pm[2]);
+}
+
+void test_counter_wrap()
+{
+    TaskCpuTracker<4> t;
+    uint16_t pm[1];
+    TaskSample a = { 3, "consumer", 0xFFFF0000u, 500, 6, 1 };
+    t.update(&a, 1, 0xFFFFF000u, pm);
+
+    // both counters wrapped past 2^32
+    TaskSample b = { 3, "consumer", 0x00010000u + 0x10000u, 500, 6, 1 };
+    const uint32_t window = t.update(&b, 1, 0x000F0000u, pm);
+    TEST_ASSERT_EQUAL_UINT32(0x000F0000u + 0x1000u, window);
+    TEST_ASSERT_EQUAL((uint64_t)0x30000u * 1000 / window, pm[0]);
+}
+
+void test_rate_meter()
+{
+    RateMeter rate;
+    TEST_ASSERT_EQUAL_UINT32(0, rate.per_s(100, 1000000));
+    TEST_ASSERT_EQUAL_UINT32(250, rate.per_s(600, 3000000));
+
+    // counter wraps
+    rate.per_s(0xFFFFFF00u, 5000000);
+    TEST_ASSERT_EQUAL_UINT32(0x200, rate.per_s(0x100, 6000000));
+}
+
+void test_latency_stats()
+{
+    LatencyStats l;
+    TEST_ASSERT_EQUAL_UINT32(0, l.percentile_us(50));
+
+    // 90 fast samples around 100 us, 10 slow ones at 5 ms
+    for (int i = 0; i < 90; i++) l.add(80 + i % 40);
+    for (int i = 0; i < 10; i++) l.add(5000);
+    TEST_ASSERT_EQUAL_UINT32(100, l.count);
+    TEST_ASSERT_EQUAL_UINT32(80, l.min_us);
+    TEST_ASSERT_EQUAL_UINT32(5000, l.max_us);
+    TEST_ASSERT_EQUAL_UINT32(588, l.mean_us());
+
+    TEST_ASSERT_EQUAL_UINT32(127, l.percentile_us(50));    // 64..127 bucket
+    TEST_ASSERT_EQUAL_UINT32(127, l.percentile_us(90));
+    TEST_ASSERT_EQUAL_UINT32(5000, l.percentile_us(91));   // bucket edge 8191 capped at max
+
+    l.add(0);
+    TEST_ASSERT_EQUAL_UINT32(0, l.min_us);
+    l.reset();
+    TEST_ASSERT_EQUAL_UINT32(0, l.count);
+}
+
+void test_clock_jitter()
+{
+    ClockJitter j;
+    j.add(5000, 1);                     // no schedule yet
+    TEST_ASSERT_EQUAL_UINT32(0, j.late.count);
+
+    // 1 ms period started at 9000, ticks due at 10000, 11000, 12000...
+    j.restart(9000, 1000);
+    j.add(10020, 1);                    // first wake only syncs (boot kick lands anywhere)
+    TEST_ASSERT_EQUAL_UINT32(0, j.late.count);
+    j.add(11040, 1);                    // 40 us late
+    j.add(12005, 1);
+    j.add(15300, 3);                    // slept through two ticks, 300 us late on the third
+    TEST_ASSERT_EQUAL_UINT32(3, j.late.count);
+    TEST_ASSERT_EQUAL_UINT32(5, j.late.min_us);
+    TEST_ASSERT_EQUAL_UINT32(300, j.late.max_us);
+    TEST_ASSERT_EQUAL_UINT32(2, j.missed);
+
+    j.add(17900, 1);                    // 1900 us late: beyond a period, still counted
+    TEST_ASSERT_EQUAL_UINT32(1900, j.late.max_us);
+
+    j.resync();                         // pause: ticks dropped
+    j.add(30100, 1);
+    j.add(31050, 1);
+    TEST_ASSERT_EQUAL_UINT32(5, j.late.count);
+    TEST_ASSERT_EQUAL_UINT32(1900, j.late.max_us);   // 31050 is 50 us after tick 22
+
+    j.restart(40000, 250);
+    TEST_ASSERT_EQUAL_UINT32(0, j.late.count);
+    TEST_ASSERT_EQUAL_UINT32(0, j.missed);
+}
+
+// What the producer does at 250 us: one wake per tick, a little late each
+// time. The stats must fill up, not sit at zero.
+void test_clock_jitter_running()
+{
+    ClockJitter j;
+    j.restart(1000000, 250);
+    for (uint64_t t = 1000000 + 250 + 7; t < 1000000 + 250 * 1000; t += 250) j.add(t, 1);
+    TEST_ASSERT_EQUAL_UINT32(998, j.late.count);
+    TEST_ASSERT_EQUAL_UINT32(7, j.late.min_us);
+    TEST_ASSERT_EQUAL_UINT32(7, j.late.max_us);
+    TEST_ASSERT_EQUAL_UINT32(0, j.missed);
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_first_update_has_no_window);
+    RUN_TEST(test_share_over_window);
+    RUN_TEST(test_counter_wrap);
+    RUN_TEST(test_rate_meter);
+    RUN_TEST(test_latency_stats);
+    RUN_TEST(test_clock_jitter);
+    RUN_TEST(test_clock_jitter_running);
+    return UNITY_END();
+}
@@ -0,0 +1,159 @@
+#include <unity.h>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include "text_render.h"
+
+static uint8_t fb_data[128 * 8];
+static PageBuffer fb{fb_data, 128, 8};
+
+static void fb_clear() { memset(fb_data, 0, sizeof(fb_data)); }
+
+static bool pixel(int x, int y) {
+    return (fb_data[(y >> 3) * 128 + x] >> (y & 7)) & 1;
+}
+
+void test_every_printable_char_has_a_glyph()
+{
+    // '?' is the fallback, so only '?' itself may map to it
+    const uint8_t* q = font_glyph('?');
+    for (char c = FONT_FIRST; c <= FONT_LAST; c++) {
+        const uint8_t* g = font_glyph(c);
+        TEST_ASSERT_NOT_NULL(g);
+        if (c != '?') TEST_ASSERT_TRUE(g != q);
+        TEST_ASSERT_EQUAL_HEX8(0x00, g[5]); // spacing column
+        if (c != ' ') {
+            uint8_t any = g[0] | g[1] | g[2] | g[3] | g[4];
+            TEST_ASSERT_TRUE(any != 0);
+            TEST_ASSERT_EQUAL_HEX8(0, any & 0x80); // 7 rows only
+        }
+    }
+    TEST_ASSERT_TRUE(font_glyph('\n') == q);
+    TEST_ASSERT_TRUE(font_glyph((char)0xB0) == q);
+}
+
+void test_draw_is_page_aligned_copy()
+{
+    fb_clear();
+    int end = text_draw(fb, 10, 2, "Ab");
+    TEST_ASSERT_EQUAL(22, end);
+    TEST_ASSERT_EQUAL_MEMORY(font_glyph('A'), &fb_data[2 * 128 + 10], 6);
+    TEST_ASSERT_EQUAL_MEMORY(font_glyph('b'), &fb_data[2 * 128 + 16], 6);
+
+    // nothing outside the two cells
+    for (int i = 0; i < (int)sizeof(fb_data); i++) {
+        if (i >= 2 * 128 + 10 && i < 2 * 128 + 22) continue;
+        TEST_ASSERT_EQUAL_HEX8(0, fb_data[i]);
+    }
+}
+
+void test_draw_clips_at_edges()
+{
+    fb_clear();
+    // 'W' starts at 125: 3 visible columns, rest dropped
+    text_draw(fb, 125, 0, "W");
+    TEST_ASSERT_EQUAL_MEMORY(font_glyph('W'), &fb_data[125], 3);
+    TEST_ASSERT_EQUAL_HEX8(0, fb_data[128]); // did not wrap to page 1
+
+    fb_clear();
+    // starts 2 columns left of the panel
+    int end = text_draw(fb, -2, 0, "XY");
+    TEST_ASSERT_EQUAL(10, end);
+    TEST_ASSERT_EQUAL_MEMORY(font_glyph('X') + 2, &fb_data[0], 4);
+    TEST_ASSERT_EQUAL_MEMORY(font_glyph('Y'), &fb_data[4], 6);
+
+    fb_clear();
+    TEST_ASSERT_EQUAL(0, text_draw(fb, 0, 8, "A"));
+    TEST_ASSERT_EQUAL(0, text_draw(fb, 0, -1, "A"));
+    for (size_t i = 0; i < sizeof(fb_data); i++) TEST_ASSERT_EQUAL_HEX8(0, fb_data[i]);
+}
+
+void test_2x_doubles_every_pixel()
+{
+    fb_clear();
+    int end = text_draw_2x(fb, 4, 1, "8");
+    TEST_ASSERT_EQUAL(4 + FONT2X_W, end);
+
+    const uint8_t* g = font_glyph('8');
+    for (int c = 0; c < 6; c++) {
+        for (int r = 0; r < 8; r++) {
+            bool on = (g[c] >> r) & 1;
+            for (int dx = 0; dx < 2; dx++)
+                for (int dy = 0; dy < 2; dy++)
+                    TEST_ASSERT_EQUAL(on, pixel(4 + 2 * c + dx, 8 + 2 * r + dy));
+        }
+    }
+
+    // bottom page not available
+    TEST_ASSERT_EQUAL(0, text_draw_2x(fb, 0, 7, "8"));
+}
+
+void test_2x_clips_at_edges()
+{
+    // same pixels as an unclipped draw shifted by the offset
+    static uint8_t ref_data[(128 + 2 * FONT2X_W) * 8];
+    PageBuffer ref{ref_data, 128 + 2 * FONT2X_W, 8};
+    memset(ref_data, 0, sizeof(ref_data));
+    text_draw_2x(ref, 0, 2, "W8");
+
+    fb_clear();
+    int end = text_draw_2x(fb, -5, 2, "W8");
+    TEST_ASSERT_EQUAL(-5 + 2 * FONT2X_W, end);
+    TEST_ASSERT_EQUAL_MEMORY(&ref_data[2 * ref.width + 5], &fb_data[2 * 128], 2 * FONT2X_W - 5);
+    TEST_ASSERT_EQUAL_MEMORY(&ref_data[3 * ref.width + 5], &fb_data[3 * 128], 2 * FONT2X_W - 5);
+
+    fb_clear();
+    end = text_draw_2x(fb, 120, 2, "W8");
+    TEST_ASSERT_EQUAL(120 + FONT2X_W, end);
+    TEST_ASSERT_EQUAL_MEMORY(&ref_data[2 * ref.width], &fb_data[2 * 128 + 120], 8);
+    TEST_ASSERT_EQUAL_MEMORY(&ref_data[3 * ref.width], &fb_data[3 * 128 + 120], 8);
+    TEST_ASSERT_EQUAL_HEX8(0, fb_data[4 * 128]); // did not wrap
+
+    // fully off either side
+    fb_clear();
+    TEST_ASSERT_EQUAL(128, text_draw_2x(fb, 128, 2, "W"));
+    TEST_ASSERT_EQUAL(0, text_draw_2x(fb, -FONT2X_W, 2, "W"));
+    for (size_t i = 0; i < sizeof(fb_data); i++) TEST_ASSERT_EQUAL_HEX8(0, fb_data[i]);
+}
+
+void test_pbm_dump()
+{
+    fb_clear();
+    text_draw(fb, 0, 0, "Hi");
+
+    static char out[64 + 64 * 129 + 1];
+    size_t n = pbm_dump(fb, out, sizeof(out));
+    TEST_ASSERT_TRUE(n > 0);
+    TEST_ASSERT_EQUAL(0, strncmp(out, "P1\n128 64\n", 10));
+
+    // 'H' column 0 is 0x7F: rows 0..6 set, row 7 clear
+    const char* body = out + 10;
+    TEST_ASSERT_EQUAL('1', body[0 * 129]);
+    TEST_ASSERT_EQUAL('1', body[6 * 129]);
+    TEST_ASSERT_EQUAL('0', body[7 * 129]);
+
+    TEST_ASSERT_EQUAL(0, pbm_dump(fb, out, 100));
+
+    // dump for eyeballing: TEXT_RENDER_PBM=path
+    if (const char* path = getenv("TEXT_RENDER_PBM")) {
+        fb_clear();
+        text_draw(fb, 0, 0, " !\"#$%&'()*+,-./0123456789:;<=>?");
+        text_draw(fb, 0, 1, "@ABCDEFGHIJKLMNOPQRSTUVWXYZ[\\]^_");
+        text_draw(fb, 0, 2, "`abcdefghijklmnopqrstuvwxyz{|}~");
+        text_draw_2x(fb, 0, 4, "23.5C 45%");
+        n = pbm_dump(fb, out, sizeof(out));
+        if (FILE* f = fopen(path, "w")) { fwrite(out, 1, n, f); fclose(f); }
+    }
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_every_printable_char_has_a_glyph);
+    RUN_TEST(test_draw_is_page_aligned_copy);
+    RUN_TEST(test_draw_clips_at_edges);
+    RUN_TEST(test_2x_doubles_every_pixel);
+    RUN_TEST(test_2x_clips_at_edges);
+    RUN_TEST(test_pbm_dump);
+    return UNITY_END();
+}
@@ -0,0 +1,186 @@
+#include <unity.h>
+#include <cmath>
+#include "window_stats.h"
+
+// brute force reference over the last n values of xs[0..end)
+static StatAgg reference(const float* xs, size_t end, size_t n)
+{
+    size_t start = end > n ? end - n : 0;
+    StatAgg r;
+    for (size_t i = start; i < end; i++) r.add(xs[i]);
+    return r;
+}
+
+void test_welford_add_and_merge()
+{
+    StatAgg a, b, all;
+    const float xs[] = {2, 4, 4, 4, 5, 5, 7, 9};
+    for (int i = 0; i < 8; i++) {
+        all.add(xs[i]);
+        (i < 3 ? a : b).add(xs[i]);
+    }
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, 5.0f, all.mean);
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, 32.0f / 7.0f, all.variance());
+
+    a.merge(b);
+    TEST_ASSERT_EQUAL(8, a.n);
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, all.mean, a.mean);
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, all.m2, a.m2);
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, 2.0f, a.min);
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, 9.0f, a.max);
+
+    a.unmerge(b);
+    TEST_ASSERT_EQUAL(3, a.n);
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, 10.0f / 3.0f, a.mean);
+}
+
+void test_sliding_matches_brute_force()
+{
+    static float xs[500];
+    for (int i = 0; i < 500; i++) xs[i] = 20.0f + 5.0f * std::sin(i * 0.37f) + (float)((i * 13) % 7);
+
+    SlidingStats<17> w;
+    for (size_t i = 0; i < 500; i++) {
+        w.push(xs[i]);
+        StatAgg got = w.result();
+        StatAgg ref = reference(xs, i + 1, 17);
+        TEST_ASSERT_EQUAL(ref.n, got.n);
+        TEST_ASSERT_FLOAT_WITHIN(1e-3f, ref.mean, got.mean);
+        TEST_ASSERT_FLOAT_WITHIN(1e-2f, ref.stddev(), got.stddev());
+        TEST_ASSERT_FLOAT_WITHIN(1e-6f, ref.min, got.min);
+        TEST_ASSERT_FLOAT_WITHIN(1e-6f, ref.max, got.max);
+    }
+}
+
+void test_monotonic_sequences()
+{
+    SlidingStats<4> up, down;
+    for (int i = 0; i < 10; i++) {
+        up.push((float)i);
+        down.push((float)(10 - i));
+    }
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, 6.0f, up.result().min);
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, 9.0f, up.result().max);
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, 1.0f, down.result().min);
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, 4.0f, down.result().max);
+}
+
+void test_min_max_many_laps()
+{
+    // N not a power of two, repeated values: the deques hold ring positions
+    // and expire the front exactly when its slot is overwritten
+    static float xs[6000];
+    uint32_t r = 12345;
+    for (int i = 0; i < 6000; i++) {
+        r = r * 1103515245u + 12345u;
+        xs[i] = (float)((r >> 16) % 9);
+    }
+    SlidingStats<60> w;
+    for (size_t i = 0; i < 6000; i++) {
+        w.push(xs[i]);
+        StatAgg ref = reference(xs, i + 1, 60);
+        StatAgg got = w.result();
+        TEST_ASSERT_EQUAL(ref.n, got.n);
+        TEST_ASSERT_FLOAT_WITHIN(1e-6f, ref.min, got.min);
+        TEST_ASSERT_FLOAT_WITHIN(1e-6f, ref.max, got.max);
+    }
+}
+
+void test_gaps_take_slots()
+{
+    SlidingStats<4> w;
+    w.push(1.0f);
+    w.push(9.0f);
+    w.push(StatAgg{});
+    w.push(StatAgg{});
+    StatAgg r = w.result();
+    TEST_ASSERT_EQUAL(2, r.n);
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, 1.0f, r.min);
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, 9.0f, r.max);
+
+    w.push(StatAgg{});  // 1 leaves
+    w.push(StatAgg{});  // 9 leaves
+    r = w.result();
+    TEST_ASSERT_EQUAL(0, r.n);
+    TEST_ASSERT_EQUAL(4, (int)w.size());
+}
+
+void test_windows_follow_time_not_samples()
+{
+    // 4 samples per second for 2 minutes: short = last 60 s (+ current)
+    static ChannelStats<60, 60> fast;
+    for (uint32_t t = 0; t < 120000; t += 250) fast.push(t, (float)(t / 1000));
+    StatAgg s = fast.query(StatWindow::Short);
+    TEST_ASSERT_EQUAL(61 * 4, s.n);
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, 59.0f, s.min);
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, 119.0f, s.max);
+    StatAgg l = fast.query(StatWindow::Long);
+    TEST_ASSERT_EQUAL(480, l.n);
+
+    // one sample every 10 s: the short window still spans 60 s, not 60 samples
+    static ChannelStats<60, 60> slow;
+    for (uint32_t t = 0; t <= 600000; t += 10000) slow.push(t, (float)(t / 1000));
+    s = slow.query(StatWindow::Short);
+    TEST_ASSERT_EQUAL(7, s.n);          // 540 .. 600 s
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, 540.0f, s.min);
+
+    // a gap longer than the window empties it; time going back restarts it
+    slow.push(700000, 1.0f);
+    TEST_ASSERT_EQUAL(1, slow.query(StatWindow::Short).n);
+    TEST_ASSERT_EQUAL(62, slow.query(StatWindow::Long).n);
+    slow.push(5000, 2.0f);
+    TEST_ASSERT_EQUAL(1, slow.query(StatWindow::Long).n);
+}
+
+void test_long_window_minutes()
+{
+    // 1 Hz for 3 hours: the long window is the last 60 whole minutes plus the
+    // minute in progress
+    static ChannelStats<60, 60> cs;
+    static float xs[3 * 3600 + 30];
+    const size_t n = sizeof(xs) / sizeof(xs[0]);
+    for (size_t i = 0; i < n; i++) {
+        xs[i] = 20.0f + 5.0f * std::sin(i * 0.01f) + (float)((i * 7) % 11);
+        cs.push((uint32_t)(i * 1000), xs[i]);
+    }
+    StatAgg l = cs.query(StatWindow::Long);
+    StatAgg ref = reference(xs, n, 3600 + 30);
+    TEST_ASSERT_EQUAL(ref.n, l.n);
+    TEST_ASSERT_FLOAT_WITHIN(1e-2f, ref.mean, l.mean);
+    TEST_ASSERT_FLOAT_WITHIN(2e-2f, ref.stddev(), l.stddev());
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, ref.min, l.min);
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, ref.max, l.max);
+}
+
+void test_engine_channels()
+{
+    StatsEngine<4, 2> eng;
+    const uint32_t t[6] = { 0, 1000, 2000, 3000, 4000, 5000 };
+    const float temp[6] = { 20, 21, 22, 23, 24, 25 };
+    const float rh[6] = { 50, 50, 50, 50, 50, 50 };
+    const float press[6] = { 1000, 999, 998, 997, 996, 995 };
+    eng.update(SensorChannel::TempC, t, temp, 2);          // columns in pieces, like batches
+    eng.update(SensorChannel::TempC, t + 2, temp + 2, 4);
+    eng.update(SensorChannel::Humidity, t, rh, 6);
+    eng.update(SensorChannel::PressureHpa, t, press, 6);
+    StatAgg ts = eng.query(SensorChannel::TempC, StatWindow::Short);
+    TEST_ASSERT_EQUAL(5, ts.n);        // 4 closed seconds + the current one
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, 23.0f, ts.mean);
+    StatAgg p = eng.query(SensorChannel::PressureHpa, StatWindow::Long);
+    TEST_ASSERT_EQUAL(6, p.n);
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, 995.0f, p.min);
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, 0.0f, eng.query(SensorChannel::Humidity, StatWindow::Short).stddev());
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_welford_add_and_merge);
+    RUN_TEST(test_sliding_matches_brute_force);
+    RUN_TEST(test_monotonic_sequences);
+    RUN_TEST(test_min_max_many_laps);
+    RUN_TEST(test_gaps_take_slots);
+    RUN_TEST(test_windows_follow_time_not_samples);
+    RUN_TEST(test_long_window_minutes);
+    RUN_TEST(test_engine_channels);
+    return UNITY_END();
+}
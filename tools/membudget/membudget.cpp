@@ -0,0 +1,77 @@
+// RAM/IRAM budget report from the linker map (host, Linux/macOS).
+//
+//   membudget .pio/build/esp32doit-devkit-v1/firmware.map
+//   membudget firmware.map --top 20
+//   membudget firmware.map --budget dram0_0_seg=85% --budget .dram0.bss=48K
+//
+// Prints every memory region (used / length), the loaded output sections and
+// the largest objects in .dram0.data, .dram0.bss and .iram0.text. Exit code
+// 1 if a --budget is exceeded (or malformed), 2 if the map can't be read.
+//
+// Build from the repo root:
+//   g++ -std=c++17 -O2 -Ilib/map_budget/include tools/membudget/membudget.cpp -o membudget
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "map_budget.h"
+
+static const char* const TOP_SECTIONS[] = { ".dram0.data", ".dram0.bss", ".iram0.text" };
+
+static int usage() {
+    fprintf(stderr, "usage: membudget <firmware.map> [--top N] [--budget name=bytes[K|%%] ...]\n");
+    return 2;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) return usage();
+    size_t top = 10;
+    std::vector<std::string> budgets;
+    for (int i = 2; i < argc; i++) {
+        if (!strcmp(argv[i], "--top") && i + 1 < argc) top = strtoul(argv[++i], nullptr, 10);
+        else if (!strcmp(argv[i], "--budget") && i + 1 < argc) budgets.push_back(argv[++i]);
+        else return usage();
+    }
+
+    std::ifstream in(argv[1]);
+    if (!in) {
+        fprintf(stderr, "can't open %s\n", argv[1]);
+        return 2;
+    }
+    MapFile mf;
+    if (!map_parse(in, &mf) || mf.regions.empty()) {
+        fprintf(stderr, "%s: no memory configuration, not an ld map?\n", argv[1]);
+        return 2;
+    }
+
+    printf("%-20s %10s %10s %6s\n", "region", "used", "length", "%");
+    for (const MapRegion& r : mf.regions) {
+        printf("%-20s %10llu %10llu %5.1f%%\n", r.name.c_str(), (unsigned long long)r.used,
+               (unsigned long long)r.length, r.length ? 100.0 * r.used / r.length : 0.0);
+    }
+
+    printf("\n%-32s %10s %10s\n", "section", "addr", "size");
+    for (const MapSection& s : mf.sections) {
+        if (!s.addr || !s.size) continue;       // debug info, empty
+        printf("%-32s 0x%08llx %10llu\n", s.name.c_str(), (unsigned long long)s.addr, (unsigned long long)s.size);
+    }
+
+    for (const char* name : TOP_SECTIONS) {
+        const MapSection* s = mf.section(name);
+        if (!s || !s->size) continue;
+        printf("\n%s, top %zu of %llu B\n", name, top, (unsigned long long)s->size);
+        for (const auto& o : mf.top_objects(name, top))
+            printf("  %8llu  %s\n", (unsigned long long)o.second, o.first.c_str());
+    }
+
+    int rc = 0;
+    if (!budgets.empty()) printf("\nbudgets\n");
+    for (const std::string& b : budgets) {
+        std::string report;
+        if (!map_check(mf, b, &report)) rc = 1;
+        printf("  %s\n", report.c_str());
+    }
+    return rc;
+}